@@ -0,0 +1,106 @@
+#!/usr/bin/env bash
+
+# Measure client setup throughput (logins/sec).
+#
+# Every pgbench transaction opens a new connection (-C), authenticates
+# with AUTH method (none by default, or scram-sha-256, md5, clear_text
+# against a plain text password configured in odyssey) and runs a
+# trivial query, so tps reported by pgbench is the login rate. Clients
+# send application_name, which is patched into the cached
+# ParameterStatus block of the route on every login.
+
+set -e
+
+echo "WARNING: all running instances of postgresql and odyssey will be terminated. Continue (y/n)?"
+read choice
+case "$choice" in
+  y|Y ) echo "Ok, proceeding";;
+  n|N ) echo "exiting" && exit 1;;
+  * ) echo "invalid" && exit 1;;
+esac
+
+if [[ -z $PGINSTALL ]]; then
+  echo "ERROR: \$PGINSTALL environment variable must point to PostgreSQL installation."
+  exit 1
+fi
+
+U=`whoami`
+CLIENTS=${CLIENTS:-8}
+DURATION=${DURATION:-10}
+AUTH=${AUTH:-none}
+PASSWORD=login_bench_password
+
+soft_cleanup(){
+    pkill -9 postgres || true
+    rm -rf tmpbuild || true
+}
+
+cleanup () {
+    echo "Cleanup"
+    soft_cleanup
+    pkill -9 odyssey || true
+}
+
+cleanup
+trap cleanup ERR INT TERM
+
+echo "Make temp build"
+mkdir tmpbuild
+cd tmpbuild
+cmake -DCMAKE_BUILD_TYPE=Release ../.. >/dev/null
+make -j 4 >/dev/null
+
+echo "Make temp DB"
+$PGINSTALL/bin/initdb datadir >/dev/null
+$PGINSTALL/bin/pg_ctl -D datadir start >/dev/null
+
+cat > odyssey-login.conf <<EOF
+workers 4
+log_to_stdout no
+log_debug no
+log_session no
+log_query no
+prefetch_route_params yes
+
+listen {
+	host "127.0.0.1"
+	port 6432
+}
+
+storage "postgres_server" {
+	type "remote"
+	host "127.0.0.1"
+	port 5432
+}
+
+database "postgres" {
+	user "login_bench" {
+		authentication "$AUTH"
+		password "$PASSWORD"
+
+		storage "postgres_server"
+		storage_db "postgres"
+		storage_user "$U"
+
+		pool "transaction"
+		pool_size 16
+	}
+}
+EOF
+
+echo "Start Odyssey"
+./sources/odyssey odyssey-login.conf >/dev/null &
+cd ..
+
+sleep 1
+
+echo "select 1;"> tmpbuild/shot.sql
+
+echo "$AUTH logins, $CLIENTS clients, $DURATION seconds"
+PGPASSWORD=$PASSWORD PGAPPNAME=login_bench PGHOST=127.0.0.1 PGPORT=6432 PGUSER=login_bench \
+    $PGINSTALL/bin/pgbench --no-vacuum -C -T $DURATION -c $CLIENTS -j $CLIENTS \
+    -f tmpbuild/shot.sql postgres | grep " = "
+
+echo "Stop Odyssey"
+kill %1
+soft_cleanup
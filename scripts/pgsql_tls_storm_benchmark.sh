@@ -0,0 +1,131 @@
+#!/usr/bin/env bash
+
+# Measure query latency of established clients during a TLS connect storm.
+#
+# A fixed set of pgbench clients keeps its connections and runs a trivial
+# query, logging every transaction, while a second pgbench opens a new
+# TLS connection per transaction at STORM_RATE connections/sec. The run
+# is repeated for every value in HANDSHAKE_WORKERS (odyssey
+# tls_handshake_workers) and p50/p99 latency of the established clients
+# is reported for each.
+
+set -e
+
+echo "WARNING: all running instances of postgresql and odyssey will be terminated. Continue (y/n)?"
+read choice
+case "$choice" in
+  y|Y ) echo "Ok, proceeding";;
+  n|N ) echo "exiting" && exit 1;;
+  * ) echo "invalid" && exit 1;;
+esac
+
+if [[ -z $PGINSTALL ]]; then
+  echo "ERROR: \$PGINSTALL environment variable must point to PostgreSQL installation."
+  exit 1
+fi
+
+U=`whoami`
+CLIENTS=${CLIENTS:-8}
+STORM_CLIENTS=${STORM_CLIENTS:-64}
+STORM_RATE=${STORM_RATE:-10000}
+DURATION=${DURATION:-30}
+WORKERS=${WORKERS:-4}
+HANDSHAKE_WORKERS=${HANDSHAKE_WORKERS:-"0 2"}
+
+soft_cleanup(){
+    pkill -9 postgres || true
+    rm -rf tmpbuild || true
+}
+
+cleanup () {
+    echo "Cleanup"
+    soft_cleanup
+    pkill -9 odyssey || true
+}
+
+cleanup
+trap cleanup ERR INT TERM
+
+echo "Make temp build"
+mkdir tmpbuild
+cd tmpbuild
+cmake -DCMAKE_BUILD_TYPE=Release ../.. >/dev/null
+make -j 4 >/dev/null
+
+echo "Make temp DB"
+$PGINSTALL/bin/initdb datadir >/dev/null
+$PGINSTALL/bin/pg_ctl -D datadir start >/dev/null
+
+echo "Make certificates"
+openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj "/CN=localhost" \
+    -keyout server.key -out server.crt 2>/dev/null
+
+echo "select 1;"> shot.sql
+
+for hw in $HANDSHAKE_WORKERS; do
+    cat > odyssey-tls.conf <<EOF
+workers $WORKERS
+tls_handshake_workers $hw
+log_to_stdout no
+log_debug no
+log_session no
+log_query no
+
+listen {
+	host "127.0.0.1"
+	port 6432
+	tls "require"
+	tls_cert_file "server.crt"
+	tls_key_file "server.key"
+}
+
+storage "postgres_server" {
+	type "remote"
+	host "127.0.0.1"
+	port 5432
+}
+
+database "postgres" {
+	user "$U" {
+		authentication "none"
+
+		storage "postgres_server"
+		pool "transaction"
+		pool_size 32
+	}
+}
+EOF
+
+    echo "Start Odyssey, tls_handshake_workers $hw"
+    ./sources/odyssey odyssey-tls.conf >/dev/null &
+    sleep 1
+
+    rm -f established.*
+    PGSSLMODE=require PGHOST=127.0.0.1 PGPORT=6432 \
+        $PGINSTALL/bin/pgbench --no-vacuum -T $DURATION -c $STORM_CLIENTS \
+        -j $STORM_CLIENTS -C -R $STORM_RATE -f shot.sql postgres \
+        >storm.out 2>&1 &
+    STORM=$!
+
+    PGSSLMODE=require PGHOST=127.0.0.1 PGPORT=6432 \
+        $PGINSTALL/bin/pgbench --no-vacuum -T $DURATION -c $CLIENTS \
+        -j $CLIENTS -l --log-prefix=established -f shot.sql postgres \
+        >/dev/null 2>&1
+    wait $STORM || true
+
+    echo "storm: `grep "^tps" storm.out | head -1`"
+    # third column of the transaction log is latency in microseconds
+    cat established.* | awk '{ print $3 }' | sort -n | awk '
+        { v[NR] = $1 }
+        END {
+            if (NR == 0) { print "no transactions"; exit }
+            printf "established: %d queries, p50 %d us, p99 %d us\n",
+                   NR, v[int((NR - 1) * 0.50) + 1], v[int((NR - 1) * 0.99) + 1]
+        }'
+
+    kill %1
+    wait %1 2>/dev/null || true
+done
+
+cd ..
+soft_cleanup
@@ -9,6 +9,60 @@
 #include <machinarium.h>
 #include <odyssey.h>
 
+#ifdef PAM_FOUND
+typedef struct {
+	char *service;
+	char *user;
+	char peer[128];
+	od_pam_auth_data_t *data;
+	int rc;
+} od_auth_pam_task_t;
+
+static void od_auth_pam_task_free(void *arg)
+{
+	od_auth_pam_task_t *task = arg;
+	if (task->data)
+		od_pam_auth_data_free(task->data);
+	free(task->service);
+	free(task->user);
+	free(task);
+}
+
+static void od_auth_pam_task(void *arg)
+{
+	od_auth_pam_task_t *task = arg;
+	task->rc = od_pam_auth(task->service, task->user, task->data,
+			       task->peer);
+}
+
+static inline int od_auth_pam(od_client_t *client, kiwi_password_t *token)
+{
+	/* pam calls block, run them with a private copy of the arguments */
+	od_auth_pam_task_t *task = calloc(1, sizeof(od_auth_pam_task_t));
+	if (task == NULL)
+		return -1;
+	task->rc = -1;
+	task->service = strdup(client->rule->auth_pam_service);
+	task->user = strdup(client->startup.user.value);
+	task->data = od_pam_auth_data_create();
+	if (task->service == NULL || task->user == NULL || task->data == NULL) {
+		od_auth_pam_task_free(task);
+		return -1;
+	}
+	od_pam_convert_passwd(task->data, token->password);
+	od_getpeername(client->io.io, task->peer, sizeof(task->peer), 1, 0);
+
+	int rc;
+	rc = od_auth_executor_run(client, od_auth_pam_task,
+				  od_auth_pam_task_free, task);
+	if (rc == -1)
+		return -1;
+	rc = task->rc;
+	od_auth_pam_task_free(task);
+	return rc;
+}
+#endif
+
 static inline int od_auth_frontend_cleartext(od_client_t *client)
 {
 	od_instance_t *instance = client->global->instance;
@@ -105,12 +159,7 @@ static inline int od_auth_frontend_cleartext(od_client_t *client)
 #ifdef PAM_FOUND
 	/* support PAM authentication */
 	if (client->rule->auth_pam_service) {
-		od_pam_convert_passwd(client->rule->auth_pam_data,
-				      client_token.password);
-
-		rc = od_pam_auth(client->rule->auth_pam_service,
-				 client->startup.user.value,
-				 client->rule->auth_pam_data, client->io.io);
+		rc = od_auth_pam(client, &client_token);
 		kiwi_password_free(&client_token);
 		machine_msg_free(msg);
 		if (rc == -1) {
@@ -331,6 +380,72 @@ static inline int od_auth_frontend_md5(od_client_t *client)
 
 #ifdef USE_SCRAM
 
+typedef struct {
+	od_scram_state_t scram_state;
+	char *password;
+	int rc;
+} od_auth_scram_task_t;
+
+static void od_auth_scram_task_free(void *arg)
+{
+	od_auth_scram_task_t *task = arg;
+	od_scram_state_free(&task->scram_state);
+	free(task->password);
+	free(task);
+}
+
+static void od_auth_scram_task(void *arg)
+{
+	od_auth_scram_task_t *task = arg;
+	task->rc = od_scram_init_from_plain_password(&task->scram_state,
+						     task->password);
+}
+
+static inline int
+od_auth_scram_init_from_plain_password(od_client_t *client,
+				       od_scram_state_t *scram_state,
+				       char *plain_password)
+{
+	od_scram_cache_t *cache = &client->rule->scram_cache;
+	char *user = client->startup.user.value;
+
+	int rc;
+	rc = od_scram_init_from_cache(scram_state, cache, user, plain_password);
+	if (rc == 0)
+		return 0;
+
+	/* salted password derivation is expensive, keep it off the worker */
+	od_auth_scram_task_t *task = malloc(sizeof(od_auth_scram_task_t));
+	if (task == NULL)
+		return -1;
+	od_scram_state_init(&task->scram_state);
+	task->rc = -1;
+	task->password = strdup(plain_password);
+	if (task->password == NULL) {
+		od_auth_scram_task_free(task);
+		return -1;
+	}
+
+	rc = od_auth_executor_run(client, od_auth_scram_task,
+				  od_auth_scram_task_free, task);
+	if (rc == -1)
+		return -1;
+	rc = task->rc;
+	if (rc == 0) {
+		od_scram_cache_store(cache, user, plain_password,
+				     &task->scram_state);
+		scram_state->salt = task->scram_state.salt;
+		scram_state->iterations = task->scram_state.iterations;
+		memcpy(scram_state->stored_key, task->scram_state.stored_key,
+		       sizeof(scram_state->stored_key));
+		memcpy(scram_state->server_key, task->scram_state.server_key,
+		       sizeof(scram_state->server_key));
+		task->scram_state.salt = NULL;
+	}
+	od_auth_scram_task_free(task);
+	return rc;
+}
+
 static inline int od_auth_frontend_scram_sha_256(od_client_t *client)
 {
 	od_instance_t *instance = client->global->instance;
@@ -473,8 +588,8 @@ static inline int od_auth_frontend_scram_sha_256(od_client_t *client)
 
 	rc = od_scram_parse_verifier(&scram_state, query_password.password);
 	if (rc == -1)
-		rc = od_scram_init_from_plain_password(&scram_state,
-						       query_password.password);
+		rc = od_auth_scram_init_from_plain_password(
+			client, &scram_state, query_password.password);
 
 	if (rc == -1) {
 		od_frontend_error(
@@ -0,0 +1,289 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+
+void od_auth_cache_init(od_auth_cache_t *cache)
+{
+	pthread_mutex_init(&cache->lock, NULL);
+	cache->buckets = NULL;
+	cache->count = 0;
+}
+
+static inline void od_auth_cache_entry_free(od_auth_cache_entry_t *entry)
+{
+	if (entry->wait)
+		machine_channel_free(entry->wait);
+	kiwi_password_free(&entry->password);
+	free(entry);
+}
+
+/* lookup is complete, wake up everyone waiting for it */
+static inline void od_auth_cache_wakeup(od_auth_cache_entry_t *entry)
+{
+	int i;
+	for (i = 0; i < entry->waiters; i++) {
+		machine_msg_t *msg;
+		msg = machine_msg_create(0);
+		if (msg == NULL)
+			return;
+		machine_channel_write(entry->wait, msg);
+	}
+}
+
+static inline void od_auth_cache_remove(od_auth_cache_t *cache,
+					od_auth_cache_entry_t *entry)
+{
+	od_list_unlink(&entry->link);
+	cache->count--;
+	if (entry->waiters > 0) {
+		od_auth_cache_wakeup(entry);
+		entry->removed = 1;
+		return;
+	}
+	od_auth_cache_entry_free(entry);
+}
+
+void od_auth_cache_free(od_auth_cache_t *cache)
+{
+	if (cache->buckets) {
+		int i;
+		for (i = 0; i < OD_AUTH_CACHE_BUCKETS; i++) {
+			od_list_t *j, *n;
+			od_list_foreach_safe(&cache->buckets[i], j, n)
+			{
+				od_auth_cache_entry_t *entry;
+				entry = od_container_of(
+					j, od_auth_cache_entry_t, link);
+				od_auth_cache_remove(cache, entry);
+			}
+		}
+	}
+	free(cache->buckets);
+	cache->buckets = NULL;
+	pthread_mutex_destroy(&cache->lock);
+}
+
+static inline od_list_t *od_auth_cache_bucket(od_auth_cache_t *cache,
+					      char *key, int key_len)
+{
+	od_hash_t hash = od_murmur_hash(key, key_len);
+	return &cache->buckets[hash % OD_AUTH_CACHE_BUCKETS];
+}
+
+static inline od_auth_cache_entry_t *
+od_auth_cache_find(od_auth_cache_t *cache, char *key, int key_len)
+{
+	if (cache->buckets == NULL)
+		return NULL;
+	od_list_t *bucket = od_auth_cache_bucket(cache, key, key_len);
+	od_list_t *i;
+	od_list_foreach(bucket, i)
+	{
+		od_auth_cache_entry_t *entry;
+		entry = od_container_of(i, od_auth_cache_entry_t, link);
+		if (entry->key_len == key_len &&
+		    memcmp(entry->key, key, key_len) == 0)
+			return entry;
+	}
+	return NULL;
+}
+
+static inline void od_auth_cache_password_copy(kiwi_password_t *dst,
+					       kiwi_password_t *src)
+{
+	kiwi_password_init(dst);
+	if (src->password == NULL)
+		return;
+	dst->password = malloc(src->password_len);
+	if (dst->password == NULL)
+		return;
+	memcpy(dst->password, src->password, src->password_len);
+	dst->password_len = src->password_len;
+}
+
+/*
+ * Lookup key. On miss the key is marked as being looked up and
+ * caller must complete it with od_auth_cache_set() or
+ * od_auth_cache_abort(); concurrent callers get OD_AUTH_CACHE_WAIT.
+ */
+od_auth_cache_status_t od_auth_cache_get(od_auth_cache_t *cache, char *key,
+					 int key_len, int user_len,
+					 kiwi_password_t *password,
+					 uint64_t now_ms,
+					 od_auth_cache_entry_t **wait)
+{
+	pthread_mutex_lock(&cache->lock);
+
+	od_auth_cache_entry_t *entry;
+	entry = od_auth_cache_find(cache, key, key_len);
+	if (entry) {
+		switch (entry->status) {
+		case OD_AUTH_CACHE_WAIT:
+			if (entry->wait == NULL) {
+				entry->wait = machine_channel_create();
+				if (entry->wait == NULL) {
+					pthread_mutex_unlock(&cache->lock);
+					return OD_AUTH_CACHE_MISS;
+				}
+			}
+			entry->waiters++;
+			*wait = entry;
+			pthread_mutex_unlock(&cache->lock);
+			return OD_AUTH_CACHE_WAIT;
+		case OD_AUTH_CACHE_HIT:
+		case OD_AUTH_CACHE_NEGATIVE:
+			if (entry->expire_ms > now_ms) {
+				od_auth_cache_status_t status = entry->status;
+				if (status == OD_AUTH_CACHE_HIT)
+					od_auth_cache_password_copy(
+						password, &entry->password);
+				pthread_mutex_unlock(&cache->lock);
+				return status;
+			}
+			od_auth_cache_remove(cache, entry);
+			break;
+		case OD_AUTH_CACHE_MISS:
+			assert(0);
+			break;
+		}
+	}
+
+	if (cache->buckets == NULL) {
+		cache->buckets =
+			malloc(sizeof(od_list_t) * OD_AUTH_CACHE_BUCKETS);
+		if (cache->buckets == NULL) {
+			pthread_mutex_unlock(&cache->lock);
+			return OD_AUTH_CACHE_MISS;
+		}
+		int i;
+		for (i = 0; i < OD_AUTH_CACHE_BUCKETS; i++)
+			od_list_init(&cache->buckets[i]);
+	}
+
+	/* become owner of the lookup */
+	entry = malloc(sizeof(od_auth_cache_entry_t) + key_len);
+	if (entry == NULL) {
+		pthread_mutex_unlock(&cache->lock);
+		return OD_AUTH_CACHE_MISS;
+	}
+	entry->status = OD_AUTH_CACHE_WAIT;
+	entry->invalidated = 0;
+	entry->wait = NULL;
+	entry->waiters = 0;
+	entry->removed = 0;
+	entry->expire_ms = 0;
+	kiwi_password_init(&entry->password);
+	entry->user_len = user_len;
+	entry->key_len = key_len;
+	memcpy(entry->key, key, key_len);
+	od_list_init(&entry->link);
+	od_list_append(od_auth_cache_bucket(cache, key, key_len), &entry->link);
+	cache->count++;
+
+	pthread_mutex_unlock(&cache->lock);
+	return OD_AUTH_CACHE_MISS;
+}
+
+/* complete lookup, password is NULL when user was not found */
+void od_auth_cache_set(od_auth_cache_t *cache, char *key, int key_len,
+		       kiwi_password_t *password, uint64_t expire_ms)
+{
+	pthread_mutex_lock(&cache->lock);
+	od_auth_cache_entry_t *entry;
+	entry = od_auth_cache_find(cache, key, key_len);
+	if (entry == NULL || entry->status != OD_AUTH_CACHE_WAIT) {
+		pthread_mutex_unlock(&cache->lock);
+		return;
+	}
+	/* result may be stale, waiters will repeat the lookup */
+	if (entry->invalidated) {
+		od_auth_cache_remove(cache, entry);
+		pthread_mutex_unlock(&cache->lock);
+		return;
+	}
+	if (password) {
+		od_auth_cache_password_copy(&entry->password, password);
+		if (password->password && entry->password.password == NULL) {
+			od_auth_cache_remove(cache, entry);
+			pthread_mutex_unlock(&cache->lock);
+			return;
+		}
+		entry->status = OD_AUTH_CACHE_HIT;
+	} else {
+		entry->status = OD_AUTH_CACHE_NEGATIVE;
+	}
+	entry->expire_ms = expire_ms;
+	od_auth_cache_wakeup(entry);
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/*
+ * Wait for the lookup owner to complete entry returned by
+ * od_auth_cache_get(), caller repeats the lookup afterwards.
+ * Returns -1 on timeout.
+ */
+int od_auth_cache_wait(od_auth_cache_t *cache, od_auth_cache_entry_t *entry,
+		       uint32_t time_ms)
+{
+	machine_msg_t *msg;
+	msg = machine_channel_read(entry->wait, time_ms);
+	if (msg)
+		machine_msg_free(msg);
+
+	pthread_mutex_lock(&cache->lock);
+	entry->waiters--;
+	if (entry->removed && entry->waiters == 0)
+		od_auth_cache_entry_free(entry);
+	pthread_mutex_unlock(&cache->lock);
+	return msg ? 0 : -1;
+}
+
+/* lookup failed, let one of the waiters retry */
+void od_auth_cache_abort(od_auth_cache_t *cache, char *key, int key_len)
+{
+	pthread_mutex_lock(&cache->lock);
+	od_auth_cache_entry_t *entry;
+	entry = od_auth_cache_find(cache, key, key_len);
+	if (entry && entry->status == OD_AUTH_CACHE_WAIT)
+		od_auth_cache_remove(cache, entry);
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/* drop cached results of the user or all results, if user is NULL */
+int od_auth_cache_invalidate(od_auth_cache_t *cache, char *user, int user_len)
+{
+	int removed = 0;
+	pthread_mutex_lock(&cache->lock);
+	if (cache->buckets == NULL) {
+		pthread_mutex_unlock(&cache->lock);
+		return 0;
+	}
+	int i;
+	for (i = 0; i < OD_AUTH_CACHE_BUCKETS; i++) {
+		od_list_t *j, *n;
+		od_list_foreach_safe(&cache->buckets[i], j, n)
+		{
+			od_auth_cache_entry_t *entry;
+			entry = od_container_of(j, od_auth_cache_entry_t, link);
+			if (user && (entry->user_len != user_len ||
+				     memcmp(entry->key, user, user_len) != 0))
+				continue;
+			/* lookups in flight are completed by their owners */
+			if (entry->status == OD_AUTH_CACHE_WAIT) {
+				entry->invalidated = 1;
+				continue;
+			}
+			od_auth_cache_remove(cache, entry);
+			removed++;
+		}
+	}
+	pthread_mutex_unlock(&cache->lock);
+	return removed;
+}
@@ -0,0 +1,69 @@
+#ifndef ODYSSEY_AUTH_CACHE_H
+#define ODYSSEY_AUTH_CACHE_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Cache of auth_query results.
+ *
+ * Found passwords are kept for auth_query_cache_ttl, missing users
+ * for auth_query_cache_negative_ttl. Only one lookup per key runs at a
+ * time: the first client owns it, concurrent clients wait on the
+ * entry for its result instead of querying auth database again.
+ *
+ * Key is the user name, followed by client host when auth_query
+ * depends on it.
+ */
+
+#define OD_AUTH_CACHE_BUCKETS 256
+
+typedef struct od_auth_cache_entry od_auth_cache_entry_t;
+typedef struct od_auth_cache od_auth_cache_t;
+
+typedef enum {
+	OD_AUTH_CACHE_MISS,
+	OD_AUTH_CACHE_HIT,
+	OD_AUTH_CACHE_NEGATIVE,
+	OD_AUTH_CACHE_WAIT
+} od_auth_cache_status_t;
+
+struct od_auth_cache_entry {
+	od_auth_cache_status_t status;
+	int invalidated;
+	/* clients waiting for the lookup owner, entry removed from
+	 * cache is freed by the last of them */
+	machine_channel_t *wait;
+	int waiters;
+	int removed;
+	uint64_t expire_ms;
+	kiwi_password_t password;
+	int user_len;
+	int key_len;
+	od_list_t link;
+	char key[];
+};
+
+struct od_auth_cache {
+	pthread_mutex_t lock;
+	od_list_t *buckets;
+	int count;
+};
+
+extern void od_auth_cache_init(od_auth_cache_t *);
+extern void od_auth_cache_free(od_auth_cache_t *);
+extern od_auth_cache_status_t od_auth_cache_get(od_auth_cache_t *, char *, int,
+						int, kiwi_password_t *,
+						uint64_t,
+						od_auth_cache_entry_t **);
+extern int od_auth_cache_wait(od_auth_cache_t *, od_auth_cache_entry_t *,
+			      uint32_t);
+extern void od_auth_cache_set(od_auth_cache_t *, char *, int,
+			      kiwi_password_t *, uint64_t);
+extern void od_auth_cache_abort(od_auth_cache_t *, char *, int);
+extern int od_auth_cache_invalidate(od_auth_cache_t *, char *, int);
+
+#endif /* ODYSSEY_AUTH_CACHE_H */
@@ -0,0 +1,62 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+
+int od_auth_executor_start(od_global_t *global, int workers_count)
+{
+	od_instance_t *instance = global->instance;
+	if (workers_count == 0)
+		return 0;
+
+	global->auth_executor = machine_taskmgr_create("auth", workers_count);
+	if (global->auth_executor == NULL) {
+		od_error(&instance->logger, "auth", NULL, NULL,
+			 "failed to start auth executor");
+		return -1;
+	}
+	return 0;
+}
+
+void od_auth_executor_stop(od_global_t *global)
+{
+	if (global->auth_executor == NULL)
+		return;
+	machine_taskmgr_free(global->auth_executor);
+	global->auth_executor = NULL;
+}
+
+int od_auth_executor_run(od_client_t *client, machine_task_function_t function,
+			 machine_task_function_t on_abandon, void *arg)
+{
+	od_global_t *global = client->global;
+	od_instance_t *instance = global->instance;
+
+	/* no executor configured, run inside the worker */
+	if (global->auth_executor == NULL) {
+		function(arg);
+		return 0;
+	}
+
+	uint32_t timeout = UINT32_MAX;
+	if (client->config_listen &&
+	    client->config_listen->client_login_timeout > 0)
+		timeout = client->config_listen->client_login_timeout;
+
+	int rc;
+	rc = machine_task_run(global->auth_executor, function, on_abandon, arg,
+			      timeout);
+	if (rc == -1) {
+		od_error(&instance->logger, "auth", client, NULL,
+			 "auth executor task %s",
+			 machine_timedout() ? "timed out" : "failed");
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef ODYSSEY_AUTH_EXECUTOR_H
+#define ODYSSEY_AUTH_EXECUTOR_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Blocking or CPU heavy authentication steps (PAM, LDAP binds, SCRAM
+ * secret derivation) are run on a dedicated pool of machinarium task
+ * threads, so worker threads keep relaying while logins are processed.
+ *
+ * The task argument must be self contained: if the client gives up
+ * waiting, the task is abandoned and on_abandon(arg) is called from the
+ * executor thread once the function has finished.
+ */
+
+int od_auth_executor_start(od_global_t *, int);
+void od_auth_executor_stop(od_global_t *);
+int od_auth_executor_run(od_client_t *, machine_task_function_t,
+			 machine_task_function_t, void *);
+
+#endif /* ODYSSEY_AUTH_EXECUTOR_H */
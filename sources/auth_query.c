@@ -93,7 +93,7 @@ error:
 	return NOT_OK_RESPONSE;
 }
 
-int od_auth_query(od_client_t *client, char *peer)
+static inline int od_auth_query_do(od_client_t *client, char *peer, int *empty)
 {
 	od_global_t *global = client->global;
 	od_rule_t *rule = client->rule;
@@ -174,7 +174,7 @@ int od_auth_query(od_client_t *client, char *peer)
 			sizeof(query));
 
 	machine_msg_t *msg;
-	msg = od_query_do(server, "auth query", query, user->value);
+	msg = od_query_do(server, "auth query", query, user->value, empty);
 	if (msg == NULL) {
 		od_debug(&instance->logger, "auth_query", auth_client, server,
 			 "auth query returned empty msg");
@@ -199,3 +199,80 @@ int od_auth_query(od_client_t *client, char *peer)
 	od_client_free(auth_client);
 	return OK_RESPONSE;
 }
+
+int od_auth_query(od_client_t *client, char *peer)
+{
+	od_instance_t *instance = client->global->instance;
+	od_rule_t *rule = client->rule;
+	if (rule->auth_query_cache_ttl == 0)
+		return od_auth_query_do(client, peer, NULL);
+
+	/* user name with trailing zero and host, if query uses it */
+	kiwi_var_t *user = &client->startup.user;
+	char key[KIWI_MAX_VAR_SIZE + 128];
+	int user_len = user->value_len;
+	int key_len = user_len;
+	memcpy(key, user->value, user_len);
+	if (strstr(rule->auth_query, "%h")) {
+		int peer_len = strlen(peer);
+		memcpy(key + key_len, peer, peer_len);
+		key_len += peer_len;
+	}
+
+	/* wait for another client is bounded by login timeout */
+	uint64_t deadline = UINT64_MAX;
+	if (client->config_listen &&
+	    client->config_listen->client_login_timeout > 0)
+		deadline = machine_time_ms() +
+			   client->config_listen->client_login_timeout;
+
+	od_auth_cache_t *cache = &rule->auth_query_cache;
+	od_auth_cache_status_t status;
+	for (;;) {
+		od_auth_cache_entry_t *entry = NULL;
+		uint64_t now = machine_time_ms();
+		status = od_auth_cache_get(cache, key, key_len, user_len,
+					   &client->password, now, &entry);
+		if (status != OD_AUTH_CACHE_WAIT)
+			break;
+		/* same lookup is run by another client */
+		uint32_t timeout = UINT32_MAX;
+		if (deadline != UINT64_MAX)
+			timeout = deadline > now ? deadline - now : 0;
+		if (od_auth_cache_wait(cache, entry, timeout) == -1) {
+			od_error(&instance->logger, "auth_query", client, NULL,
+				 "timed out waiting for auth query of user %s",
+				 user->value);
+			return NOT_OK_RESPONSE;
+		}
+	}
+
+	switch (status) {
+	case OD_AUTH_CACHE_HIT:
+		od_debug(&instance->logger, "auth_query", client, NULL,
+			 "cached password found for user %s", user->value);
+		return OK_RESPONSE;
+	case OD_AUTH_CACHE_NEGATIVE:
+		od_debug(&instance->logger, "auth_query", client, NULL,
+			 "cached auth query returned empty msg for user %s",
+			 user->value);
+		return NOT_OK_RESPONSE;
+	default:
+		break;
+	}
+
+	int empty = 0;
+	int rc = od_auth_query_do(client, peer, &empty);
+	uint64_t now = machine_time_ms();
+	if (rc == OK_RESPONSE) {
+		od_auth_cache_set(cache, key, key_len, &client->password,
+				  now + rule->auth_query_cache_ttl * 1000ULL);
+	} else if (empty && rule->auth_query_cache_negative_ttl > 0) {
+		od_auth_cache_set(
+			cache, key, key_len, NULL,
+			now + rule->auth_query_cache_negative_ttl * 1000ULL);
+	} else {
+		od_auth_cache_abort(cache, key, key_len);
+	}
+	return rc;
+}
@@ -45,10 +45,8 @@ void od_backend_close_connection(od_server_t *server)
 		server->error_connect = NULL;
 	}
 
-	if (server->tls) {
-		machine_tls_free(server->tls);
-		server->tls = NULL;
-	}
+	/* owned by the storage */
+	server->tls = NULL;
 }
 
 void od_backend_error(od_server_t *server, char *context, char *data,
@@ -244,6 +242,7 @@ static inline int od_backend_connect_to(od_server_t *server, char *context,
 
 	/* set network options */
 	machine_set_nodelay(io, instance->config.nodelay);
+	machine_set_edge_triggered(io, instance->config.io_edge_triggered);
 	if (instance->config.keepalive > 0) {
 		machine_set_keepalive(io, 1, instance->config.keepalive,
 				      instance->config.keepalive_keep_interval,
@@ -263,7 +262,7 @@ static inline int od_backend_connect_to(od_server_t *server, char *context,
 
 	/* set tls options */
 	if (storage->tls_opts->tls_mode != OD_CONFIG_TLS_DISABLE) {
-		server->tls = od_tls_backend(storage);
+		server->tls = od_tls_backend_shared(storage);
 		if (server->tls == NULL)
 			return -1;
 	}
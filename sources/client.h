@@ -32,6 +32,8 @@ struct od_client {
 	od_client_ctl_t ctl;
 	uint64_t coroutine_id;
 	machine_tls_t *tls;
+	/* ssl negotiation already done by a handshake machine */
+	int tls_offloaded;
 	od_io_t io;
 	machine_cond_t *cond;
 	od_relay_t relay;
@@ -42,6 +44,19 @@ struct od_client {
 	uint64_t time_accept;
 	uint64_t time_setup;
 	uint64_t time_last_active;
+	uint64_t time_queue;
+	/* login phases durations */
+	uint64_t lifecycle[OD_LIFECYCLE_MAX];
+
+	/* bytes queued by client and server relays */
+	int64_t buffered;
+
+	/* query log sampling decision for the current transaction */
+	int log_query_decided;
+	int log_query_sampled;
+	/* rate limit decision for the current client message, -1 until
+	 * the message is first logged */
+	int log_query_message;
 
 	kiwi_be_startup_t startup;
 	kiwi_vars_t vars;
@@ -51,10 +66,18 @@ struct od_client {
 	/* od_route_t */
 	void *route;
 	char peer[OD_CLIENT_MAX_PEERLEN];
+	/* cached for logging */
+	char peer_host[OD_CLIENT_MAX_PEERLEN];
+	char peer_port[16];
 
 	// desc preparet statements ids
 	od_hashmap_t *prep_stmt_ids;
 
+	/* normalized statements by statement and portal name, and
+	 * queries in flight, kept for query statistics */
+	od_hashmap_t *query_stmts;
+	od_query_stats_pipeline_t query_pipeline;
+
 	/* passwd from config rule */
 	kiwi_password_t password;
 
@@ -66,6 +89,7 @@ struct od_client {
 };
 
 static const size_t OD_CLIENT_DEFAULT_HASHMAP_SZ = 420;
+static const size_t OD_CLIENT_QUERY_STMTS_HASHMAP_SZ = 16;
 
 static inline od_retcode_t od_client_init_hm(od_client_t *client)
 {
@@ -82,6 +106,7 @@ static inline void od_client_init(od_client_t *client)
 	client->type = OD_POOL_CLIENT_EXTERNAL;
 	client->coroutine_id = 0;
 	client->tls = NULL;
+	client->tls_offloaded = 0;
 	client->cond = NULL;
 	client->rule = NULL;
 	client->config_listen = NULL;
@@ -90,8 +115,16 @@ static inline void od_client_init(od_client_t *client)
 	client->global = NULL;
 	client->time_accept = 0;
 	client->time_setup = 0;
+	client->time_queue = 0;
+	memset(client->lifecycle, 0, sizeof(client->lifecycle));
+	client->buffered = 0;
+	client->log_query_decided = 0;
+	client->log_query_sampled = 0;
+	client->log_query_message = -1;
 	client->notify_io = NULL;
 	client->ctl.op = OD_CLIENT_OP_NONE;
+	client->peer_host[0] = 0;
+	client->peer_port[0] = 0;
 
 	kiwi_be_startup_init(&client->startup);
 	kiwi_vars_init(&client->vars);
@@ -107,6 +140,8 @@ static inline void od_client_init(od_client_t *client)
 	od_list_init(&client->link);
 
 	client->prep_stmt_ids = NULL;
+	client->query_stmts = NULL;
+	od_query_stats_pipeline_init(&client->query_pipeline);
 }
 
 static inline od_client_t *od_client_allocate(void)
@@ -129,6 +164,10 @@ static inline void od_client_free(od_client_t *client)
 	if (client->prep_stmt_ids) {
 		od_hashmap_free(client->prep_stmt_ids);
 	}
+	if (client->query_stmts) {
+		od_hashmap_free(client->query_stmts);
+	}
+	od_query_stats_pipeline_free(&client->query_pipeline);
 	free(client);
 }
 
@@ -23,7 +23,11 @@ void od_config_init(od_config_t *config)
 	config->log_stats = 1;
 	config->log_stats_prom = 0;
 	config->stats_interval = 3;
+	config->slow_query_ring_size = 128;
+	config->query_stats_max = 1000;
 	config->log_format = NULL;
+	config->log_output = NULL;
+	config->log_output_type = OD_LOGGER_TEXT;
 	config->pid_file = NULL;
 	config->unix_socket_dir = NULL;
 	config->locks_dir = NULL;
@@ -35,9 +39,17 @@ void od_config_init(od_config_t *config)
 	config->log_syslog = 0;
 	config->log_syslog_ident = NULL;
 	config->log_syslog_facility = NULL;
+	config->log_login_min_duration = 0;
+	config->log_queue_size = 262144;
+	config->log_queue_overflow = NULL;
+	config->log_queue_overflow_policy = OD_LOGGER_SPILL;
 
 	config->readahead = 8192;
 	config->nodelay = 1;
+	config->io_edge_triggered = 0;
+	config->splice_threshold = 0;
+	config->relay_buffer_limit = 0;
+	config->relay_message_limit = 0;
 
 	config->keepalive = 15;
 	config->keepalive_keep_interval = 5;
@@ -46,6 +58,10 @@ void od_config_init(od_config_t *config)
 
 	config->workers = 1;
 	config->resolvers = 1;
+	config->auth_workers = 0;
+	config->tls_ticket_lifetime = 3600;
+	config->tls_handshake_workers = 0;
+	config->prefetch_route_params = 0;
 	config->client_max_set = 0;
 	config->client_max = 0;
 	config->client_max_routing = 0;
@@ -79,6 +95,8 @@ void od_config_free(od_config_t *config)
 		free(config->log_file);
 	if (config->log_format)
 		free(config->log_format);
+	if (config->log_output)
+		free(config->log_output);
 	if (config->pid_file)
 		free(config->pid_file);
 	if (config->unix_socket_dir)
@@ -87,6 +105,8 @@ void od_config_free(od_config_t *config)
 		free(config->log_syslog_ident);
 	if (config->log_syslog_facility)
 		free(config->log_syslog_facility);
+	if (config->log_queue_overflow)
+		free(config->log_queue_overflow);
 	if (config->locks_dir) {
 		free(config->locks_dir);
 	}
@@ -143,6 +163,27 @@ int od_config_validate(od_config_t *config, od_logger_t *logger)
 		return -1;
 	}
 
+	/* auth_workers */
+	if (config->auth_workers < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad auth_workers number");
+		return -1;
+	}
+
+	/* tls_ticket_lifetime */
+	if (config->tls_ticket_lifetime < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad tls_ticket_lifetime value");
+		return -1;
+	}
+
+	/* tls_handshake_workers */
+	if (config->tls_handshake_workers < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad tls_handshake_workers number");
+		return -1;
+	}
+
 	/* coroutine_stack_size */
 	if (config->coroutine_stack_size < 4) {
 		od_error(logger, "config", NULL, NULL,
@@ -150,8 +191,81 @@ int od_config_validate(od_config_t *config, od_logger_t *logger)
 		return -1;
 	}
 
+	/* splice_threshold */
+	if (config->splice_threshold < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad splice_threshold number");
+		return -1;
+	}
+
+	/* relay limits */
+	if (config->relay_buffer_limit < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad relay_buffer_limit number");
+		return -1;
+	}
+	if (config->relay_message_limit < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad relay_message_limit number");
+		return -1;
+	}
+
+	/* slow queries */
+	if (config->slow_query_ring_size < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad slow_query_ring_size number");
+		return -1;
+	}
+	if (config->query_stats_max < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad query_stats_max number");
+		return -1;
+	}
+
+	if (config->log_login_min_duration < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad log_login_min_duration number");
+		return -1;
+	}
+
+	/* log queue */
+	if (config->log_queue_size < 0) {
+		od_error(logger, "config", NULL, NULL,
+			 "bad log_queue_size number");
+		return -1;
+	}
+	if (config->log_queue_overflow) {
+		if (strcmp(config->log_queue_overflow, "spill") == 0) {
+			config->log_queue_overflow_policy = OD_LOGGER_SPILL;
+		} else if (strcmp(config->log_queue_overflow, "drop") == 0) {
+			config->log_queue_overflow_policy = OD_LOGGER_DROP;
+		} else if (strcmp(config->log_queue_overflow, "block") == 0) {
+			config->log_queue_overflow_policy = OD_LOGGER_BLOCK;
+		} else {
+			od_error(logger, "config", NULL, NULL,
+				 "unknown log_queue_overflow policy");
+			return -1;
+		}
+	}
+
+	/* log output */
+	if (config->log_output) {
+		if (strcmp(config->log_output, "text") == 0) {
+			config->log_output_type = OD_LOGGER_TEXT;
+		} else if (strcmp(config->log_output, "json") == 0) {
+			config->log_output_type = OD_LOGGER_JSON;
+		} else if (strcmp(config->log_output, "logfmt") == 0) {
+			config->log_output_type = OD_LOGGER_LOGFMT;
+		} else {
+			od_error(logger, "config", NULL, NULL,
+				 "unknown log_output type");
+			return -1;
+		}
+	}
+
 	/* log format */
-	if (config->log_format == NULL) {
+	if (config->log_format == NULL &&
+	    config->log_output_type == OD_LOGGER_TEXT) {
 		od_error(logger, "config", NULL, NULL, "log is not defined");
 		return -1;
 	}
@@ -252,6 +366,9 @@ void od_config_print(od_config_t *config, od_logger_t *logger)
 	if (config->log_format)
 		od_log(logger, "config", NULL, NULL,
 		       "log_format              %s", config->log_format);
+	if (config->log_output)
+		od_log(logger, "config", NULL, NULL,
+		       "log_output              %s", config->log_output);
 	if (config->log_file)
 		od_log(logger, "config", NULL, NULL,
 		       "log_file                %s", config->log_file);
@@ -266,22 +383,43 @@ void od_config_print(od_config_t *config, od_logger_t *logger)
 		od_log(logger, "config", NULL, NULL,
 		       "log_syslog_facility     %s",
 		       config->log_syslog_facility);
+	od_log(logger, "config", NULL, NULL, "log_queue_size          %d",
+	       config->log_queue_size);
+	if (config->log_queue_overflow)
+		od_log(logger, "config", NULL, NULL,
+		       "log_queue_overflow      %s", config->log_queue_overflow);
 	od_log(logger, "config", NULL, NULL, "log_debug               %s",
 	       od_config_yes_no(config->log_debug));
 	od_log(logger, "config", NULL, NULL, "log_config              %s",
 	       od_config_yes_no(config->log_config));
 	od_log(logger, "config", NULL, NULL, "log_session             %s",
 	       od_config_yes_no(config->log_session));
+	if (config->log_login_min_duration)
+		od_log(logger, "config", NULL, NULL,
+		       "log_login_min_duration  %d",
+		       config->log_login_min_duration);
 	od_log(logger, "config", NULL, NULL, "log_query               %s",
 	       od_config_yes_no(config->log_query));
 	od_log(logger, "config", NULL, NULL, "log_stats               %s",
 	       od_config_yes_no(config->log_stats));
 	od_log(logger, "config", NULL, NULL, "stats_interval          %d",
 	       config->stats_interval);
+	od_log(logger, "config", NULL, NULL, "slow_query_ring_size    %d",
+	       config->slow_query_ring_size);
+	od_log(logger, "config", NULL, NULL, "query_stats_max         %d",
+	       config->query_stats_max);
 	od_log(logger, "config", NULL, NULL, "readahead               %d",
 	       config->readahead);
 	od_log(logger, "config", NULL, NULL, "nodelay                 %s",
 	       od_config_yes_no(config->nodelay));
+	od_log(logger, "config", NULL, NULL, "io_edge_triggered       %s",
+	       od_config_yes_no(config->io_edge_triggered));
+	od_log(logger, "config", NULL, NULL, "splice_threshold        %d",
+	       config->splice_threshold);
+	od_log(logger, "config", NULL, NULL, "relay_buffer_limit      %d",
+	       config->relay_buffer_limit);
+	od_log(logger, "config", NULL, NULL, "relay_message_limit     %d",
+	       config->relay_message_limit);
 	od_log(logger, "config", NULL, NULL, "keepalive               %d",
 	       config->keepalive);
 	if (config->client_max_set)
@@ -301,6 +439,14 @@ void od_config_print(od_config_t *config, od_logger_t *logger)
 	       config->workers);
 	od_log(logger, "config", NULL, NULL, "resolvers               %d",
 	       config->resolvers);
+	od_log(logger, "config", NULL, NULL, "auth_workers            %d",
+	       config->auth_workers);
+	od_log(logger, "config", NULL, NULL, "tls_ticket_lifetime     %d",
+	       config->tls_ticket_lifetime);
+	od_log(logger, "config", NULL, NULL, "tls_handshake_workers   %d",
+	       config->tls_handshake_workers);
+	od_log(logger, "config", NULL, NULL, "prefetch_route_params   %s",
+	       od_config_yes_no(config->prefetch_route_params));
 
 	if (config->enable_online_restart_feature) {
 		od_log(logger, "config", NULL, NULL,
@@ -34,13 +34,21 @@ struct od_config {
 	int log_query;
 	char *log_file;
 	char *log_format;
+	char *log_output;
+	od_logger_output_t log_output_type;
 	int log_stats;
 	int log_stats_prom;
 	int log_syslog;
 	char *log_syslog_ident;
 	char *log_syslog_facility;
+	int log_login_min_duration;
+	int log_queue_size;
+	char *log_queue_overflow;
+	od_logger_overflow_t log_queue_overflow_policy;
 	/*         */
 	int stats_interval;
+	int slow_query_ring_size;
+	int query_stats_max;
 	/* system related settings */
 	char *pid_file;
 	char *unix_socket_dir;
@@ -53,6 +61,10 @@ struct od_config {
 	/*                         */
 	int readahead;
 	int nodelay;
+	int io_edge_triggered;
+	int splice_threshold;
+	int relay_buffer_limit;
+	int relay_message_limit;
 
 	/* TCP KEEPALIVE related settings */
 	int keepalive;
@@ -62,6 +74,10 @@ struct od_config {
 	/*                                */
 	int workers;
 	int resolvers;
+	int auth_workers;
+	int tls_ticket_lifetime;
+	int tls_handshake_workers;
+	int prefetch_route_params;
 	/*         client                 */
 	int client_max_set;
 	int client_max;
@@ -16,8 +16,15 @@ typedef enum {
 	OD_LINCLUDE,
 	OD_LDAEMONIZE,
 	OD_LPRIORITY,
-	OD_LLOG_TO_STDOUT,
+	OD_LPID_FILE,
+	OD_LUNIX_SOCKET_DIR,
+	OD_LUNIX_SOCKET_MODE,
+	OD_LLOCKS_DIR,
+	OD_LENABLE_ONLINE_RESTART,
+	OD_LGRACEFUL_DIE_ON_ERRORS,
+	OD_LBINDWITH_REUSEPORT,
 	OD_LLOG_DEBUG,
+	OD_LLOG_TO_STDOUT,
 	OD_LLOG_CONFIG,
 	OD_LLOG_SESSION,
 	OD_LLOG_QUERY,
@@ -25,17 +32,22 @@ typedef enum {
 	OD_LLOG_FORMAT,
 	OD_LLOG_STATS,
 	OD_LLOG_STATS_PROM,
-	OD_LPID_FILE,
-	OD_LUNIX_SOCKET_DIR,
-	OD_LUNIX_SOCKET_MODE,
-	OD_LLOCKS_DIR,
-	OD_LENABLE_ONLINE_RESTART,
-	OD_LGRACEFUL_DIE_ON_ERRORS,
-	OD_LBINDWITH_REUSEPORT,
 	OD_LLOG_SYSLOG,
 	OD_LLOG_SYSLOG_IDENT,
 	OD_LLOG_SYSLOG_FACILITY,
+	OD_LLOG_QUEUE_SIZE,
+	OD_LLOG_QUEUE_OVERFLOW,
+	OD_LLOG_OUTPUT,
+	OD_LLOG_QUERY_SAMPLE,
+	OD_LLOG_QUERY_RATE,
+	OD_LLOG_QUERY_MIN_DURATION,
+	OD_LLOG_LOGIN_MIN_DURATION,
 	OD_LSTATS_INTERVAL,
+	OD_LSLOW_QUERY_THRESHOLD,
+	OD_LSLOW_QUERY_LOG,
+	OD_LSLOW_QUERY_RING_SIZE,
+	OD_LQUERY_STATS,
+	OD_LQUERY_STATS_MAX,
 	OD_LLISTEN,
 	OD_LHOST,
 	OD_LPORT,
@@ -48,6 +60,10 @@ typedef enum {
 	OD_LREADAHEAD,
 	OD_LWORKERS,
 	OD_LRESOLVERS,
+	OD_LAUTH_WORKERS,
+	OD_LTLS_TICKET_LIFETIME,
+	OD_LTLS_HANDSHAKE_WORKERS,
+	OD_LPREFETCH_ROUTE_PARAMS,
 	OD_LPIPELINE,
 	OD_LPACKET_READ_SIZE,
 	OD_LPACKET_WRITE_QUEUE,
@@ -79,8 +95,8 @@ typedef enum {
 	OD_LPASSWORD,
 	OD_LROLE,
 	OD_LPOOL,
-	OD_LPOOL_ROUTING,
 	OD_LPOOL_PRESERVE_PREP_STMT,
+	OD_LPOOL_ROUTING,
 #ifdef LDAP_FOUND
 	OD_LLDAPPOOL_SIZE,
 	OD_LLDAPPOOL_TIMEOUT,
@@ -100,14 +116,14 @@ typedef enum {
 	OD_LSTORAGE_PASSWORD,
 	OD_LAUTHENTICATION,
 	OD_LAUTH_COMMON_NAME,
-	OD_LAUTH_PAM_SERVICE,
-	OD_LAUTH_MODULE,
 	OD_LAUTH_QUERY,
 	OD_LAUTH_QUERY_DB,
 	OD_LAUTH_QUERY_USER,
-	OD_LAUTH_LDAP_SERVICE,
+	OD_LAUTH_QUERY_CACHE_TTL,
+	OD_LAUTH_QUERY_CACHE_NEGATIVE_TTL,
+	OD_LAUTH_PAM_SERVICE,
+	OD_LAUTH_MODULE,
 	OD_LAUTH_PASSWORD_PASSTHROUGH,
-	OD_LQUANTILES,
 	OD_LMODULE,
 	OD_LLDAP_ENDPOINT,
 	OD_LLDAP_SERVER,
@@ -116,12 +132,14 @@ typedef enum {
 	OD_LLDAP_SUFFIX,
 	OD_LLDAP_BASEDN,
 	OD_LLDAP_BINDDN,
+	OD_LLDAP_BIND_PASSWD,
 	OD_LLDAP_URL,
 	OD_LLDAP_SEARCH_ATTRIBUTE,
-	OD_LLDAP_BIND_PASSWD,
 	OD_LLDAP_SCHEME,
-	OD_LLDAP_SCOPE,
 	OD_LLDAP_FILTER,
+	OD_LLDAP_SCOPE,
+	OD_LLDAP_CACHE_TTL,
+	OD_LLDAP_CACHE_SIZE,
 	OD_LLDAP_ENDPOINT_NAME,
 	OD_LWATCHDOG,
 	OD_LWATCHDOG_LAG_QUERY,
@@ -129,8 +147,14 @@ typedef enum {
 	OD_LCATCHUP_TIMEOUT,
 	OD_LCATCHUP_CHECKS,
 	OD_LOPTIONS,
+	OD_LQUANTILES,
+	OD_LIO_EDGE_TRIGGERED,
+	OD_LSPLICE_THRESHOLD,
+	OD_LRELAY_BUFFER_LIMIT,
+	OD_LRELAY_MESSAGE_LIMIT,
 } od_lexeme_t;
 
+/* indexed by od_lexeme_t, keep entries in the same order */
 static od_keyword_t od_config_keywords[] = {
 	/* main */
 	od_keyword("yes", OD_LYES),
@@ -160,7 +184,19 @@ static od_keyword_t od_config_keywords[] = {
 	od_keyword("log_syslog", OD_LLOG_SYSLOG),
 	od_keyword("log_syslog_ident", OD_LLOG_SYSLOG_IDENT),
 	od_keyword("log_syslog_facility", OD_LLOG_SYSLOG_FACILITY),
+	od_keyword("log_queue_size", OD_LLOG_QUEUE_SIZE),
+	od_keyword("log_queue_overflow", OD_LLOG_QUEUE_OVERFLOW),
+	od_keyword("log_output", OD_LLOG_OUTPUT),
+	od_keyword("log_query_sample", OD_LLOG_QUERY_SAMPLE),
+	od_keyword("log_query_rate", OD_LLOG_QUERY_RATE),
+	od_keyword("log_query_min_duration", OD_LLOG_QUERY_MIN_DURATION),
+	od_keyword("log_login_min_duration", OD_LLOG_LOGIN_MIN_DURATION),
 	od_keyword("stats_interval", OD_LSTATS_INTERVAL),
+	od_keyword("slow_query_threshold", OD_LSLOW_QUERY_THRESHOLD),
+	od_keyword("slow_query_log", OD_LSLOW_QUERY_LOG),
+	od_keyword("slow_query_ring_size", OD_LSLOW_QUERY_RING_SIZE),
+	od_keyword("query_stats", OD_LQUERY_STATS),
+	od_keyword("query_stats_max", OD_LQUERY_STATS_MAX),
 
 	/* listen */
 	od_keyword("listen", OD_LLISTEN),
@@ -179,6 +215,10 @@ static od_keyword_t od_config_keywords[] = {
 	od_keyword("readahead", OD_LREADAHEAD),
 	od_keyword("workers", OD_LWORKERS),
 	od_keyword("resolvers", OD_LRESOLVERS),
+	od_keyword("auth_workers", OD_LAUTH_WORKERS),
+	od_keyword("tls_ticket_lifetime", OD_LTLS_TICKET_LIFETIME),
+	od_keyword("tls_handshake_workers", OD_LTLS_HANDSHAKE_WORKERS),
+	od_keyword("prefetch_route_params", OD_LPREFETCH_ROUTE_PARAMS),
 	od_keyword("pipeline", OD_LPIPELINE),
 	od_keyword("packet_read_size", OD_LPACKET_READ_SIZE),
 	od_keyword("packet_write_queue", OD_LPACKET_WRITE_QUEUE),
@@ -248,6 +288,9 @@ static od_keyword_t od_config_keywords[] = {
 	od_keyword("auth_query", OD_LAUTH_QUERY),
 	od_keyword("auth_query_db", OD_LAUTH_QUERY_DB),
 	od_keyword("auth_query_user", OD_LAUTH_QUERY_USER),
+	od_keyword("auth_query_cache_ttl", OD_LAUTH_QUERY_CACHE_TTL),
+	od_keyword("auth_query_cache_negative_ttl",
+		   OD_LAUTH_QUERY_CACHE_NEGATIVE_TTL),
 	od_keyword("auth_pam_service", OD_LAUTH_PAM_SERVICE),
 	od_keyword("auth_module", OD_LAUTH_MODULE),
 	od_keyword("password_passthrough", OD_LAUTH_PASSWORD_PASSTHROUGH),
@@ -267,6 +310,8 @@ static od_keyword_t od_config_keywords[] = {
 	od_keyword("ldapscheme", OD_LLDAP_SCHEME),
 	od_keyword("ldapfilter", OD_LLDAP_FILTER),
 	od_keyword("ldapscope", OD_LLDAP_SCOPE),
+	od_keyword("ldapcachettl", OD_LLDAP_CACHE_TTL),
+	od_keyword("ldapcachesize", OD_LLDAP_CACHE_SIZE),
 	od_keyword("ldap_endpoint_name", OD_LLDAP_ENDPOINT_NAME),
 
 	/* watchdog */
@@ -283,6 +328,12 @@ static od_keyword_t od_config_keywords[] = {
 
 	/* stats */
 	od_keyword("quantiles", OD_LQUANTILES),
+
+	/* io */
+	od_keyword("io_edge_triggered", OD_LIO_EDGE_TRIGGERED),
+	od_keyword("splice_threshold", OD_LSPLICE_THRESHOLD),
+	od_keyword("relay_buffer_limit", OD_LRELAY_BUFFER_LIMIT),
+	od_keyword("relay_message_limit", OD_LRELAY_MESSAGE_LIMIT),
 	{ 0, 0, 0 },
 };
 
@@ -948,6 +999,18 @@ static int od_config_reader_rule_settings(od_config_reader_t *reader,
 						     &rule->auth_query_user))
 				return NOT_OK_RESPONSE;
 			break;
+		/* auth_query_cache_ttl */
+		case OD_LAUTH_QUERY_CACHE_TTL:
+			if (!od_config_reader_number(
+				    reader, &rule->auth_query_cache_ttl))
+				return NOT_OK_RESPONSE;
+			break;
+		/* auth_query_cache_negative_ttl */
+		case OD_LAUTH_QUERY_CACHE_NEGATIVE_TTL:
+			if (!od_config_reader_number(
+				    reader, &rule->auth_query_cache_negative_ttl))
+				return NOT_OK_RESPONSE;
+			break;
 		/* auth_query_user */
 		case OD_LAUTH_PASSWORD_PASSTHROUGH:
 			if (!od_config_reader_yes_no(
@@ -1156,6 +1219,41 @@ static int od_config_reader_rule_settings(od_config_reader_t *reader,
 			if (!od_config_reader_yes_no(reader, &rule->log_query))
 				return NOT_OK_RESPONSE;
 			continue;
+		/* log_query_sample */
+		case OD_LLOG_QUERY_SAMPLE:
+			if (!od_config_reader_number(reader,
+						     &rule->log_query_sample))
+				return NOT_OK_RESPONSE;
+			continue;
+		/* log_query_rate */
+		case OD_LLOG_QUERY_RATE:
+			if (!od_config_reader_number(reader,
+						     &rule->log_query_rate))
+				return NOT_OK_RESPONSE;
+			continue;
+		/* log_query_min_duration */
+		case OD_LLOG_QUERY_MIN_DURATION:
+			if (!od_config_reader_number(
+				    reader, &rule->log_query_min_duration))
+				return NOT_OK_RESPONSE;
+			continue;
+		/* slow_query_threshold */
+		case OD_LSLOW_QUERY_THRESHOLD:
+			if (!od_config_reader_number(
+				    reader, &rule->slow_query_threshold))
+				return NOT_OK_RESPONSE;
+			continue;
+		/* slow_query_log */
+		case OD_LSLOW_QUERY_LOG:
+			if (!od_config_reader_yes_no(reader,
+						     &rule->slow_query_log))
+				return NOT_OK_RESPONSE;
+			continue;
+		/* query_stats */
+		case OD_LQUERY_STATS:
+			if (!od_config_reader_yes_no(reader, &rule->query_stats))
+				return NOT_OK_RESPONSE;
+			continue;
 		case OD_LLDAP_ENDPOINT_NAME: {
 #ifdef LDAP_FOUND
 			if (!od_config_reader_string(reader,
@@ -1455,6 +1553,18 @@ od_config_reader_ldap_endpoint(od_config_reader_t *reader)
 				    reader, &ldap_current->ldapbindpasswd))
 				goto error;
 
+		} break;
+		case OD_LLDAP_CACHE_TTL: {
+			if (!od_config_reader_number(
+				    reader, &ldap_current->ldapcachettl))
+				goto error;
+
+		} break;
+		case OD_LLDAP_CACHE_SIZE: {
+			if (!od_config_reader_number(
+				    reader, &ldap_current->ldapcachesize))
+				goto error;
+
 		} break;
 		}
 	}
@@ -1804,6 +1914,34 @@ static int od_config_reader_parse(od_config_reader_t *reader,
 				goto error;
 			}
 			continue;
+		/* log_queue_size */
+		case OD_LLOG_QUEUE_SIZE:
+			if (!od_config_reader_number(
+				    reader, &config->log_queue_size)) {
+				goto error;
+			}
+			continue;
+		/* log_queue_overflow */
+		case OD_LLOG_QUEUE_OVERFLOW:
+			if (!od_config_reader_string(
+				    reader, &config->log_queue_overflow)) {
+				goto error;
+			}
+			continue;
+		/* log_login_min_duration */
+		case OD_LLOG_LOGIN_MIN_DURATION:
+			if (!od_config_reader_number(
+				    reader, &config->log_login_min_duration)) {
+				goto error;
+			}
+			continue;
+		/* log_output */
+		case OD_LLOG_OUTPUT:
+			if (!od_config_reader_string(reader,
+						     &config->log_output)) {
+				goto error;
+			}
+			continue;
 		/* stats_interval */
 		case OD_LSTATS_INTERVAL:
 			if (!od_config_reader_number(reader,
@@ -1811,6 +1949,20 @@ static int od_config_reader_parse(od_config_reader_t *reader,
 				goto error;
 			}
 
+			continue;
+		/* slow_query_ring_size */
+		case OD_LSLOW_QUERY_RING_SIZE:
+			if (!od_config_reader_number(
+				    reader, &config->slow_query_ring_size)) {
+				goto error;
+			}
+			continue;
+		/* query_stats_max */
+		case OD_LQUERY_STATS_MAX:
+			if (!od_config_reader_number(
+				    reader, &config->query_stats_max)) {
+				goto error;
+			}
 			continue;
 		/* client_max */
 		case OD_LCLIENT_MAX:
@@ -1848,6 +2000,34 @@ static int od_config_reader_parse(od_config_reader_t *reader,
 				goto error;
 			}
 			continue;
+		/* io_edge_triggered */
+		case OD_LIO_EDGE_TRIGGERED:
+			if (!od_config_reader_yes_no(
+				    reader, &config->io_edge_triggered)) {
+				goto error;
+			}
+			continue;
+		/* splice_threshold */
+		case OD_LSPLICE_THRESHOLD:
+			if (!od_config_reader_number(
+				    reader, &config->splice_threshold)) {
+				goto error;
+			}
+			continue;
+		/* relay_buffer_limit */
+		case OD_LRELAY_BUFFER_LIMIT:
+			if (!od_config_reader_number(
+				    reader, &config->relay_buffer_limit)) {
+				goto error;
+			}
+			continue;
+		/* relay_message_limit */
+		case OD_LRELAY_MESSAGE_LIMIT:
+			if (!od_config_reader_number(
+				    reader, &config->relay_message_limit)) {
+				goto error;
+			}
+			continue;
 		/* keepalive */
 		case OD_LKEEPALIVE:
 			if (!od_config_reader_number(reader,
@@ -1910,6 +2090,38 @@ static int od_config_reader_parse(od_config_reader_t *reader,
 				goto error;
 			}
 
+			continue;
+		/* auth_workers */
+		case OD_LAUTH_WORKERS:
+			if (!od_config_reader_number(reader,
+						     &config->auth_workers)) {
+				goto error;
+			}
+
+			continue;
+		/* tls_ticket_lifetime */
+		case OD_LTLS_TICKET_LIFETIME:
+			if (!od_config_reader_number(
+				    reader, &config->tls_ticket_lifetime)) {
+				goto error;
+			}
+
+			continue;
+		/* tls_handshake_workers */
+		case OD_LTLS_HANDSHAKE_WORKERS:
+			if (!od_config_reader_number(
+				    reader, &config->tls_handshake_workers)) {
+				goto error;
+			}
+
+			continue;
+		/* prefetch_route_params */
+		case OD_LPREFETCH_ROUTE_PARAMS:
+			if (!od_config_reader_yes_no(
+				    reader, &config->prefetch_route_params)) {
+				goto error;
+			}
+
 			continue;
 		/* pipeline */
 		case OD_LPIPELINE:
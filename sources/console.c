@@ -32,6 +32,13 @@ typedef enum {
 	OD_LVERSION,
 	OD_LLISTEN,
 	OD_LSTORAGES,
+	OD_LSLOW_QUERIES,
+	OD_LQUERY_STATS,
+	OD_LLIFECYCLE,
+	OD_LWORKERS,
+	OD_LINVALIDATE,
+	OD_LAUTH_CACHE,
+	OD_LLDAP_CACHE,
 } od_console_keywords_t;
 
 static od_keyword_t od_console_keywords[] = {
@@ -57,6 +64,13 @@ static od_keyword_t od_console_keywords[] = {
 	od_keyword("version", OD_LVERSION),
 	od_keyword("listen", OD_LLISTEN),
 	od_keyword("storages", OD_LSTORAGES),
+	od_keyword("slow_queries", OD_LSLOW_QUERIES),
+	od_keyword("query_stats", OD_LQUERY_STATS),
+	od_keyword("lifecycle", OD_LLIFECYCLE),
+	od_keyword("workers", OD_LWORKERS),
+	od_keyword("invalidate", OD_LINVALIDATE),
+	od_keyword("auth_cache", OD_LAUTH_CACHE),
+	od_keyword("ldap_cache", OD_LLDAP_CACHE),
 	{ 0, 0, 0 }
 };
 
@@ -472,6 +486,199 @@ od_console_show_errors_per_route(od_client_t *client, machine_msg_t *stream)
 	return rc;
 }
 
+static inline int od_console_show_lifecycle_cb(od_route_t *route, void **argv)
+{
+	machine_msg_t *stream = argv[0];
+	assert(stream);
+
+	int i;
+	for (i = 0; i < OD_LIFECYCLE_MAX; i++) {
+		od_hgram_t *hgram = &route->lifecycle.phases[i];
+		uint64_t buckets[OD_HGRAM_BUCKETS];
+		uint64_t count = od_hgram_read(hgram, buckets);
+		if (count == 0)
+			continue;
+
+		int offset;
+		machine_msg_t *msg;
+		msg = kiwi_be_write_data_row(stream, &offset);
+		if (msg == NULL)
+			return NOT_OK_RESPONSE;
+		int rc;
+		/* database */
+		rc = kiwi_be_write_data_row_add(stream, offset,
+						route->rule->db_name,
+						strlen(route->rule->db_name));
+		if (rc != OK_RESPONSE)
+			return rc;
+		/* user */
+		rc = kiwi_be_write_data_row_add(stream, offset,
+						route->rule->user_name,
+						strlen(route->rule->user_name));
+		if (rc != OK_RESPONSE)
+			return rc;
+		/* phase */
+		char *phase = od_lifecycle_phase_to_str(i);
+		rc = kiwi_be_write_data_row_add(stream, offset, phase,
+						strlen(phase));
+		if (rc != OK_RESPONSE)
+			return rc;
+		uint64_t values[] = {
+			count,
+			od_atomic_u64_of(&hgram->sum) / count,
+			od_hgram_quantile_of(count, buckets, 0.5),
+			od_hgram_quantile_of(count, buckets, 0.99),
+			od_atomic_u64_of(&hgram->max),
+		};
+		/* count, avg_us, p50_us, p99_us, max_us */
+		size_t j;
+		for (j = 0; j < sizeof(values) / sizeof(values[0]); j++) {
+			char data[64];
+			int data_len;
+			data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+					       values[j]);
+			rc = kiwi_be_write_data_row_add(stream, offset, data,
+							data_len);
+			if (rc != OK_RESPONSE)
+				return rc;
+		}
+	}
+	return OK_RESPONSE;
+}
+
+static inline int od_console_show_lifecycle(od_client_t *client,
+					    machine_msg_t *stream)
+{
+	assert(stream);
+	od_router_t *router = client->global->router;
+
+	void *argv[] = { stream };
+
+	if (kiwi_be_write_row_descriptionf(
+		    stream, "ssslllll", "database", "user", "phase", "count",
+		    "avg_us", "p50_us", "p99_us", "max_us") == NULL) {
+		return NOT_OK_RESPONSE;
+	}
+
+	od_router_foreach(router, od_console_show_lifecycle_cb, argv);
+
+	return kiwi_be_write_complete(stream, "SHOW", 5);
+}
+
+static inline int od_console_show_workers(od_client_t *client,
+					  machine_msg_t *stream)
+{
+	assert(stream);
+	od_worker_pool_t *worker_pool = client->global->worker_pool;
+
+	if (kiwi_be_write_row_descriptionf(
+		    stream, "llllllllll", "worker", "ready", "active", "timers",
+		    "switches_per_sec", "wait_pct", "run_pct", "run_max_us",
+		    "ready_delay_avg_us", "ready_delay_max_us") == NULL) {
+		return NOT_OK_RESPONSE;
+	}
+
+	int i;
+	for (i = 0; i < worker_pool->count; i++) {
+		od_worker_t *worker = &worker_pool->pool[i];
+		od_worker_loop_stat_t stat;
+		od_worker_loop_stat_read(worker, &stat);
+
+		int offset;
+		if (kiwi_be_write_data_row(stream, &offset) == NULL)
+			return NOT_OK_RESPONSE;
+		uint64_t values[] = {
+			worker->id,
+			stat.count_ready,
+			stat.count_active,
+			stat.count_timer,
+			stat.switch_rate,
+			stat.wait_pct,
+			stat.run_pct,
+			stat.run_max_us,
+			stat.ready_delay_avg_us,
+			stat.ready_delay_max_us,
+		};
+		size_t j;
+		for (j = 0; j < sizeof(values) / sizeof(values[0]); j++) {
+			char data[64];
+			int data_len;
+			data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+					       values[j]);
+			int rc;
+			rc = kiwi_be_write_data_row_add(stream, offset, data,
+							data_len);
+			if (rc != OK_RESPONSE)
+				return rc;
+		}
+	}
+
+	return kiwi_be_write_complete(stream, "SHOW", 5);
+}
+
+static inline int od_console_show_ldap_cache(od_client_t *client,
+					     machine_msg_t *stream)
+{
+	assert(stream);
+	od_router_t *router = client->global->router;
+
+	if (kiwi_be_write_row_descriptionf(stream, "slll", "endpoint",
+					   "entries", "hits",
+					   "misses") == NULL) {
+		return NOT_OK_RESPONSE;
+	}
+
+#ifdef LDAP_FOUND
+	od_rules_t *rules = &router->rules;
+	int rc = OK_RESPONSE;
+	pthread_mutex_lock(&rules->mu);
+	od_list_t *i;
+	od_list_foreach(&rules->ldap_endpoints, i)
+	{
+		od_ldap_endpoint_t *le;
+		le = od_container_of(i, od_ldap_endpoint_t, link);
+		int count;
+		uint64_t hits, misses;
+		od_ldap_cache_stat(&le->cache, &count, &hits, &misses);
+
+		int offset;
+		if (kiwi_be_write_data_row(stream, &offset) == NULL) {
+			rc = NOT_OK_RESPONSE;
+			break;
+		}
+		rc = kiwi_be_write_data_row_add(stream, offset, le->name,
+						strlen(le->name));
+		if (rc != OK_RESPONSE)
+			break;
+		char data[64];
+		int data_len;
+		data_len = od_snprintf(data, sizeof(data), "%d", count);
+		rc = kiwi_be_write_data_row_add(stream, offset, data,
+						data_len);
+		if (rc != OK_RESPONSE)
+			break;
+		data_len = od_snprintf(data, sizeof(data), "%" PRIu64, hits);
+		rc = kiwi_be_write_data_row_add(stream, offset, data,
+						data_len);
+		if (rc != OK_RESPONSE)
+			break;
+		data_len =
+			od_snprintf(data, sizeof(data), "%" PRIu64, misses);
+		rc = kiwi_be_write_data_row_add(stream, offset, data,
+						data_len);
+		if (rc != OK_RESPONSE)
+			break;
+	}
+	pthread_mutex_unlock(&rules->mu);
+	if (rc != OK_RESPONSE)
+		return rc;
+#else
+	(void)router;
+#endif
+
+	return kiwi_be_write_complete(stream, "SHOW", 5);
+}
+
 static inline int od_console_show_version(machine_msg_t *stream)
 {
 	assert(stream);
@@ -607,12 +814,15 @@ static inline int od_console_show_pools_add_cb(od_route_t *route, void **argv)
 	if (rc == NOT_OK_RESPONSE)
 		goto error;
 	/* maxwait */
-	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, 0UL);
+	uint64_t maxwait = od_route_maxwait(route, machine_time_us());
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+			       maxwait / 1000000);
 	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
 	if (rc == NOT_OK_RESPONSE)
 		goto error;
 	/* maxwait_us */
-	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, 0UL);
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+			       maxwait % 1000000);
 	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
 	if (rc == NOT_OK_RESPONSE)
 		goto error;
@@ -659,6 +869,31 @@ static inline int od_console_show_pools_add_cb(od_route_t *route, void **argv)
 		if (rc == NOT_OK_RESPONSE)
 			goto error;
 
+		/* bytes buffered */
+		data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+				       od_atomic_u64_of(&route->stats.buffered));
+		rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+		if (rc == NOT_OK_RESPONSE)
+			goto error;
+
+		/* pool wait time */
+		od_hgram_t *wait = &route->lifecycle.phases[OD_LIFECYCLE_QUEUE];
+		data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+				       od_hgram_quantile(wait, 0.5));
+		rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+		if (rc == NOT_OK_RESPONSE)
+			goto error;
+		data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+				       od_hgram_quantile(wait, 0.99));
+		rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+		if (rc == NOT_OK_RESPONSE)
+			goto error;
+		data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+				       od_atomic_u64_of(&route->wait_timeouts));
+		rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+		if (rc == NOT_OK_RESPONSE)
+			goto error;
+
 		transactions_hgram = td_new(QUANTILES_COMPRESSION);
 		queries_hgram = td_new(QUANTILES_COMPRESSION);
 		freeze_hgram = td_new(QUANTILES_COMPRESSION);
@@ -869,6 +1104,24 @@ static inline int od_console_show_pools(od_client_t *client,
 		if (rc == NOT_OK_RESPONSE)
 			return NOT_OK_RESPONSE;
 
+		char *bytes_buffered = "bytes_buffered";
+		rc = kiwi_be_write_row_description_add(msg, 0, bytes_buffered,
+						       strlen(bytes_buffered),
+						       0, 0, 20 /* INT8OID */,
+						       8, 0, 0);
+		if (rc == NOT_OK_RESPONSE)
+			return NOT_OK_RESPONSE;
+
+		char *wait_columns[] = { "wait_p50_us", "wait_p99_us",
+					 "wait_timeouts" };
+		for (int i = 0; i < 3; i++) {
+			rc = kiwi_be_write_row_description_add(
+				msg, 0, wait_columns[i], strlen(wait_columns[i]),
+				0, 0, 20 /* INT8OID */, 8, 0, 0);
+			if (rc == NOT_OK_RESPONSE)
+				return NOT_OK_RESPONSE;
+		}
+
 		for (int i = 0; i < quantiles_count; i++) {
 			char caption[KIWI_MAX_VAR_SIZE];
 			int caption_len;
@@ -917,7 +1170,7 @@ static inline int od_console_show_pools(od_client_t *client,
 		if (rc == NOT_OK_RESPONSE) {
 			goto error;
 		}
-		const size_t rest_columns_count = 13;
+		const size_t rest_columns_count = 17;
 		for (size_t i = 0; i < rest_columns_count; ++i) {
 			rc = kiwi_be_write_data_row_add(stream, offset, NULL,
 							NULL_MSG_LEN);
@@ -1316,6 +1569,12 @@ static inline int od_console_show_clients_callback(od_client_t *client,
 	/* tls */
 	data_len = od_snprintf(data, sizeof(data), "%s", "");
 	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* buffered */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIi64,
+			       client->buffered);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
 	if (rc == NOT_OK_RESPONSE)
 		return NOT_OK_RESPONSE;
 	return 0;
@@ -1347,10 +1606,10 @@ static inline int od_console_show_clients(od_client_t *client,
 
 	machine_msg_t *msg;
 	msg = kiwi_be_write_row_descriptionf(
-		stream, "sssssdsdssddssds", "type", "user", "database", "state",
+		stream, "sssssdsdssddssdsl", "type", "user", "database", "state",
 		"addr", "port", "local_addr", "local_port", "connect_time",
 		"request_time", "wait", "wait_us", "ptr", "link", "remote_pid",
-		"tls");
+		"tls", "buffered");
 	if (msg == NULL)
 		return NOT_OK_RESPONSE;
 
@@ -1605,10 +1864,10 @@ static inline int od_console_show_storages(od_client_t *client,
 	od_router_t *router = client->global->router;
 
 	machine_msg_t *msg;
-	msg = kiwi_be_write_row_descriptionf(stream, "ssdsssss", "type", "host",
-					     "port", "tls", "tls_cert_file",
-					     "tls_key_file", "tls_ca_file",
-					     "tls_protocols");
+	msg = kiwi_be_write_row_descriptionf(
+		stream, "ssdsssssll", "type", "host", "port", "tls",
+		"tls_cert_file", "tls_key_file", "tls_ca_file", "tls_protocols",
+		"tls_resumed", "tls_full_handshakes");
 
 	if (msg == NULL) {
 		return NOT_OK_RESPONSE;
@@ -1673,6 +1932,41 @@ static inline int od_console_show_storages(od_client_t *client,
 		if (rc != OK_RESPONSE) {
 			goto error;
 		}
+
+		/* backend tls session reuse, summed over rules */
+		uint64_t tls_resumed = 0;
+		uint64_t tls_full = 0;
+		od_list_t *j;
+		od_list_foreach(&rules->rules, j)
+		{
+			od_rule_t *rule;
+			rule = od_container_of(j, od_rule_t, link);
+			if (rule->storage == NULL || rule->storage_name == NULL ||
+			    strcmp(rule->storage_name, storage->name) != 0)
+				continue;
+			pthread_mutex_lock(&rule->storage->tls_lock);
+			if (rule->storage->tls) {
+				uint64_t resumed, full;
+				machine_tls_stat(rule->storage->tls, &resumed,
+						 &full);
+				tls_resumed += resumed;
+				tls_full += full;
+			}
+			pthread_mutex_unlock(&rule->storage->tls_lock);
+		}
+
+		data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+				       tls_resumed);
+		rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+		if (rc == NOT_OK_RESPONSE) {
+			goto error;
+		}
+		data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+				       tls_full);
+		rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+		if (rc == NOT_OK_RESPONSE) {
+			goto error;
+		}
 	}
 
 	pthread_mutex_unlock(&rules->mu);
@@ -1682,6 +1976,190 @@ error:
 	return rc;
 }
 
+static int od_console_show_slow_queries_cb(od_slow_query_t *record,
+					   void **argv)
+{
+	machine_msg_t *stream = argv[0];
+	int offset;
+	machine_msg_t *msg;
+	msg = kiwi_be_write_data_row(stream, &offset);
+	if (msg == NULL)
+		return NOT_OK_RESPONSE;
+	char data[64];
+	int data_len;
+	int rc;
+	/* time */
+	struct tm tm;
+	localtime_r(&record->time, &tm);
+	data_len = strftime(data, sizeof(data), "%Y-%m-%d %H:%M:%S", &tm);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* type */
+	char *type = od_slow_query_type_to_str(record->type);
+	rc = kiwi_be_write_data_row_add(stream, offset, type, strlen(type));
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* client */
+	data_len = od_snprintf(data, sizeof(data), "%s%.*s",
+			       record->client_id.id_prefix,
+			       (signed)sizeof(record->client_id.id),
+			       record->client_id.id);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* server */
+	data_len = od_snprintf(data, sizeof(data), "%s%.*s",
+			       record->server_id.id_prefix,
+			       (signed)sizeof(record->server_id.id),
+			       record->server_id.id);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* user */
+	rc = kiwi_be_write_data_row_add(stream, offset, record->user,
+					strlen(record->user));
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* database */
+	rc = kiwi_be_write_data_row_add(stream, offset, record->database,
+					strlen(record->database));
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* duration_us */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIi64,
+			       record->duration_us);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* bytes */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, record->bytes);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* query */
+	rc = kiwi_be_write_data_row_add(stream, offset, record->text,
+					record->text_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	return 0;
+}
+
+static inline int od_console_show_slow_queries(od_client_t *client,
+					       machine_msg_t *stream)
+{
+	assert(stream);
+	od_router_t *router = client->global->router;
+
+	machine_msg_t *msg;
+	msg = kiwi_be_write_row_descriptionf(
+		stream, "sssssslls", "time", "type", "client", "server", "user",
+		"database", "duration_us", "bytes", "query");
+	if (msg == NULL)
+		return NOT_OK_RESPONSE;
+
+	void *argv[] = { stream };
+	int rc;
+	rc = od_slow_query_ring_foreach(&router->slow_queries,
+					od_console_show_slow_queries_cb, argv);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+
+	return kiwi_be_write_complete(stream, "SHOW", 5);
+}
+
+static int od_console_show_query_stats_cb(od_query_stats_entry_t *entry,
+					  void **argv)
+{
+	machine_msg_t *stream = argv[0];
+	int offset;
+	machine_msg_t *msg;
+	msg = kiwi_be_write_data_row(stream, &offset);
+	if (msg == NULL)
+		return NOT_OK_RESPONSE;
+	char data[64];
+	int data_len;
+	int rc;
+	/* user */
+	rc = kiwi_be_write_data_row_add(stream, offset, entry->user,
+					strlen(entry->user));
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* database */
+	rc = kiwi_be_write_data_row_add(stream, offset, entry->database,
+					strlen(entry->database));
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* fingerprint */
+	data_len = od_snprintf(data, sizeof(data), "%016" PRIx64,
+			       entry->fingerprint);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* calls */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, entry->calls);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* total_time_us */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, entry->time_us);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* avg_time_us */
+	uint64_t avg = entry->calls ? entry->time_us / entry->calls : 0;
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, avg);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* p99_time_us */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64,
+			       od_query_stats_quantile(entry, 0.99));
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* rows */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, entry->rows);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* bytes */
+	data_len = od_snprintf(data, sizeof(data), "%" PRIu64, entry->bytes);
+	rc = kiwi_be_write_data_row_add(stream, offset, data, data_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	/* query */
+	rc = kiwi_be_write_data_row_add(stream, offset, entry->text,
+					entry->text_len);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+	return 0;
+}
+
+static inline int od_console_show_query_stats(od_client_t *client,
+					      machine_msg_t *stream)
+{
+	assert(stream);
+	od_router_t *router = client->global->router;
+
+	machine_msg_t *msg;
+	msg = kiwi_be_write_row_descriptionf(
+		stream, "ssslllllls", "user", "database", "fingerprint",
+		"calls", "total_time_us", "avg_time_us", "p99_time_us", "rows",
+		"bytes", "query");
+	if (msg == NULL)
+		return NOT_OK_RESPONSE;
+
+	void *argv[] = { stream };
+	int rc;
+	rc = od_query_stats_foreach(&router->query_stats,
+				    od_console_show_query_stats_cb, argv);
+	if (rc == NOT_OK_RESPONSE)
+		return NOT_OK_RESPONSE;
+
+	return kiwi_be_write_complete(stream, "SHOW", 5);
+}
+
 static inline int od_console_show(od_client_t *client, machine_msg_t *stream,
 				  od_parser_t *parser)
 {
@@ -1727,6 +2205,16 @@ static inline int od_console_show(od_client_t *client, machine_msg_t *stream,
 		return od_console_show_listen(client, stream);
 	case OD_LSTORAGES:
 		return od_console_show_storages(client, stream);
+	case OD_LSLOW_QUERIES:
+		return od_console_show_slow_queries(client, stream);
+	case OD_LQUERY_STATS:
+		return od_console_show_query_stats(client, stream);
+	case OD_LLIFECYCLE:
+		return od_console_show_lifecycle(client, stream);
+	case OD_LWORKERS:
+		return od_console_show_workers(client, stream);
+	case OD_LLDAP_CACHE:
+		return od_console_show_ldap_cache(client, stream);
 	}
 	return NOT_OK_RESPONSE;
 }
@@ -1944,6 +2432,84 @@ od_console_drop(od_client_t *client, machine_msg_t *stream, od_parser_t *parser)
 	return NOT_OK_RESPONSE;
 }
 
+static inline int od_console_invalidate(od_client_t *client,
+					machine_msg_t *stream,
+					od_parser_t *parser)
+{
+	assert(stream);
+	od_instance_t *instance = client->global->instance;
+	od_router_t *router = client->global->router;
+
+	od_token_t token;
+	int rc;
+	rc = od_parser_next(parser, &token);
+	if (rc != OD_PARSER_KEYWORD)
+		return NOT_OK_RESPONSE;
+	od_keyword_t *keyword;
+	keyword = od_keyword_match(od_console_keywords, &token);
+	if (keyword == NULL || (keyword->id != OD_LAUTH_CACHE &&
+				keyword->id != OD_LLDAP_CACHE))
+		return NOT_OK_RESPONSE;
+	int cache = keyword->id;
+
+	/* optional user name */
+	char user[KIWI_MAX_VAR_SIZE];
+	int user_len = 0;
+	rc = od_parser_next(parser, &token);
+	switch (rc) {
+	case OD_PARSER_EOF:
+		break;
+	case OD_PARSER_KEYWORD:
+	case OD_PARSER_STRING:
+		if (token.value.string.size >= (int)sizeof(user))
+			return NOT_OK_RESPONSE;
+		memcpy(user, token.value.string.pointer,
+		       token.value.string.size);
+		user[token.value.string.size] = 0;
+		user_len = token.value.string.size + 1;
+		if (od_parser_next(parser, &token) != OD_PARSER_EOF)
+			return NOT_OK_RESPONSE;
+		break;
+	default:
+		return NOT_OK_RESPONSE;
+	}
+
+	od_rules_t *rules = &router->rules;
+	int removed = 0;
+	pthread_mutex_lock(&rules->mu);
+	od_list_t *i;
+	if (cache == OD_LAUTH_CACHE) {
+		od_list_foreach(&rules->rules, i)
+		{
+			od_rule_t *rule;
+			rule = od_container_of(i, od_rule_t, link);
+			if (rule->auth_query == NULL)
+				continue;
+			removed += od_auth_cache_invalidate(
+				&rule->auth_query_cache, user_len ? user : NULL,
+				user_len);
+		}
+	}
+#ifdef LDAP_FOUND
+	if (cache == OD_LLDAP_CACHE) {
+		od_list_foreach(&rules->ldap_endpoints, i)
+		{
+			od_ldap_endpoint_t *le;
+			le = od_container_of(i, od_ldap_endpoint_t, link);
+			removed += od_ldap_cache_invalidate(
+				&le->cache, user_len ? user : NULL, user_len);
+		}
+	}
+#endif
+	pthread_mutex_unlock(&rules->mu);
+
+	od_log(&instance->logger, "console", client, NULL,
+	       "INVALIDATE %s %s: %d entries removed",
+	       cache == OD_LAUTH_CACHE ? "AUTH_CACHE" : "LDAP_CACHE",
+	       user_len ? user : "(all users)", removed);
+	return kiwi_be_write_complete(stream, "INVALIDATE", 11);
+}
+
 int od_console_query(od_client_t *client, machine_msg_t *stream,
 		     char *query_data, uint32_t query_data_size)
 {
@@ -2033,6 +2599,14 @@ int od_console_query(od_client_t *client, machine_msg_t *stream,
 			goto bad_query;
 		}
 		break;
+	case OD_LINVALIDATE:
+		if (client->rule->user_role != OD_RULE_ROLE_ADMIN)
+			goto incorrect_role;
+		rc = od_console_invalidate(client, stream, &parser);
+		if (rc == NOT_OK_RESPONSE) {
+			goto bad_query;
+		}
+		break;
 	default:
 		goto bad_query;
 	}
@@ -19,7 +19,6 @@ static int od_cron_stat_cb(od_route_t *route, od_stat_t *current,
 			   void **argv)
 {
 	od_instance_t *instance = argv[0];
-	(void)current;
 
 	struct {
 		int database_len;
@@ -36,6 +35,9 @@ static int od_cron_stat_cb(od_route_t *route, od_stat_t *current,
 		uint64_t avg_query_time;
 		uint64_t avg_recv_client;
 		uint64_t avg_recv_server;
+		uint64_t buffered;
+		uint64_t maxwait;
+		uint64_t wait_timeouts;
 	} info;
 
 	od_route_lock(route);
@@ -62,6 +64,9 @@ static int od_cron_stat_cb(od_route_t *route, od_stat_t *current,
 	info.avg_tx_time = avg->tx_time;
 	info.avg_recv_server = avg->recv_server;
 	info.avg_recv_client = avg->recv_client;
+	info.buffered = current->buffered;
+	info.maxwait = od_route_maxwait(route, machine_time_us());
+	info.wait_timeouts = od_atomic_u64_of(&route->wait_timeouts);
 
 	od_route_unlock(route);
 
@@ -74,6 +79,18 @@ static int od_cron_stat_cb(od_route_t *route, od_stat_t *current,
 			info.avg_count_tx, info.avg_tx_time,
 			info.avg_count_query, info.avg_query_time,
 			info.avg_recv_client, info.avg_recv_server);
+		int i;
+		for (i = 0; i < OD_LIFECYCLE_MAX; i++) {
+			od_hgram_t *hgram = &route->lifecycle.phases[i];
+			od_prom_metrics_write_lifecycle_stat(
+				metrics, info.user, info.database,
+				od_lifecycle_phase_to_str(i),
+				od_atomic_u64_of(&hgram->count),
+				od_hgram_quantile(hgram, 0.99));
+		}
+		od_prom_metrics_write_pool_wait_stat(metrics, info.user,
+						     info.database, info.maxwait,
+						     info.wait_timeouts);
 		const char *prom_log = od_prom_metrics_get_stat_cb(metrics);
 		od_logger_write_plain(&instance->logger, OD_LOG, "stats", NULL,
 				      NULL, prom_log);
@@ -87,16 +104,33 @@ static int od_cron_stat_cb(od_route_t *route, od_stat_t *current,
 	       "%" PRIu64 " transactions/sec (%" PRIu64 " usec) "
 	       "%" PRIu64 " queries/sec (%" PRIu64 " usec) "
 	       "%" PRIu64 " in bytes/sec, "
-	       "%" PRIu64 " out bytes/sec",
+	       "%" PRIu64 " out bytes/sec, "
+	       "%" PRIu64 " bytes buffered, "
+	       "%" PRIu64 " usec max wait, "
+	       "%" PRIu64 " wait timeouts",
 	       info.database_len, info.database, info.user_len, info.user,
 	       info.obsolete ? " obsolete" : "", info.client_pool_total,
 	       info.server_pool_active, info.server_pool_idle,
 	       info.avg_count_tx, info.avg_tx_time, info.avg_count_query,
-	       info.avg_query_time, info.avg_recv_client, info.avg_recv_server);
+	       info.avg_query_time, info.avg_recv_client, info.avg_recv_server,
+	       info.buffered, info.maxwait, info.wait_timeouts);
 
 	return 0;
 }
 
+#ifdef PROM_FOUND
+static int od_cron_query_stats_prom_cb(od_query_stats_entry_t *entry,
+				       void **argv)
+{
+	od_prom_metrics_t *metrics = argv[0];
+	return od_prom_metrics_write_query_stat(
+		metrics, entry->user, entry->database, entry->fingerprint,
+		entry->calls, entry->time_us,
+		od_query_stats_quantile(entry, 0.99), entry->rows,
+		entry->bytes);
+}
+#endif
+
 static inline void od_cron_stat(od_cron_t *cron)
 {
 	od_router_t *router = cron->global->router;
@@ -118,6 +152,12 @@ static inline void od_cron_stat(od_cron_t *cron)
 		machine_stat(&count_coroutine, &count_coroutine_cache,
 			     &msg_allocated, &msg_cache_count,
 			     &msg_cache_gc_count, &msg_cache_size);
+		uint64_t log_written = 0;
+		uint64_t log_dropped = 0;
+		uint64_t log_spilled = 0;
+		uint64_t log_blocked = 0;
+		od_logger_stat(&instance->logger, &log_written, &log_dropped,
+			       &log_spilled, &log_blocked);
 #ifdef PROM_FOUND
 		if (instance->config.log_stats_prom) {
 			od_prom_metrics_write_stat(
@@ -135,25 +175,29 @@ static inline void od_cron_stat(od_cron_t *cron)
 		       "system worker: msg (%" PRIu64 " allocated, %" PRIu64
 		       " cached, %" PRIu64 " freed, %" PRIu64 " cache_size), "
 		       "coroutines (%" PRIu64 " active, %" PRIu64
-		       " cached) startup errors %" PRIu64,
+		       " cached) startup errors %" PRIu64 ", log (%" PRIu64
+		       " written, %" PRIu64 " dropped, %" PRIu64
+		       " spilled, %" PRIu64 " blocked)",
 		       msg_allocated, msg_cache_count, msg_cache_gc_count,
 		       msg_cache_size, count_coroutine, count_coroutine_cache,
-		       startup_errors);
-
-		/* request stats per worker */
-		int i;
-		for (i = 0; i < worker_pool->count; i++) {
-			od_worker_t *worker = &worker_pool->pool[i];
-			machine_msg_t *msg;
-			msg = machine_msg_create(0);
-			machine_msg_set_type(msg, OD_MSG_STAT);
-			machine_channel_write(worker->task_channel, msg);
-		}
+		       startup_errors, log_written, log_dropped, log_spilled,
+		       log_blocked);
 
 		od_log(&instance->logger, "stats", NULL, NULL, "clients %d",
 		       od_atomic_u32_of(&router->clients));
 	}
 
+	/* request stats per worker, event loop stats are sampled even
+	 * without log_stats for show workers */
+	int i;
+	for (i = 0; i < worker_pool->count; i++) {
+		od_worker_t *worker = &worker_pool->pool[i];
+		machine_msg_t *msg;
+		msg = machine_msg_create(0);
+		machine_msg_set_type(msg, OD_MSG_STAT);
+		machine_channel_write(worker->task_channel, msg);
+	}
+
 	/* update stats per route and print info */
 	od_route_pool_stat_cb_t stat_cb;
 	if (!instance->config.log_stats) {
@@ -168,6 +212,20 @@ static inline void od_cron_stat(od_cron_t *cron)
 #endif
 		       stat_cb, argv);
 
+#ifdef PROM_FOUND
+	if (instance->config.log_stats && instance->config.log_stats_prom &&
+	    instance->config.query_stats_max > 0) {
+		void *argv_prom[] = { cron->metrics };
+		od_query_stats_foreach(&router->query_stats,
+				       od_cron_query_stats_prom_cb, argv_prom);
+		const char *prom_log = od_prom_metrics_get_query_stat(
+			cron->metrics);
+		od_logger_write_plain(&instance->logger, OD_LOG, "stats", NULL,
+				      NULL, prom_log);
+		od_prom_free(prom_log);
+	}
+#endif
+
 	/* update current stat time mark */
 	cron->stat_time_us = machine_time_us();
 }
@@ -235,6 +293,14 @@ static void od_cron_err_stat(od_cron_t *cron)
 	od_route_pool_unlock(router->route_pool)
 }
 
+static void od_cron_query_stats(od_cron_t *cron)
+{
+	od_router_t *router = cron->global->router;
+
+	/* merge per-worker query statistics */
+	od_query_stats_merge(&router->query_stats);
+}
+
 static void od_cron(void *arg)
 {
 	od_cron_t *cron = arg;
@@ -263,6 +329,7 @@ static void od_cron(void *arg)
 			}
 
 			od_cron_err_stat(cron);
+			od_cron_query_stats(cron);
 		}
 		pthread_mutex_unlock(&cron->lock);
 		/* 1 second soft interval */
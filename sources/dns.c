@@ -67,6 +67,23 @@ int od_getpeername(machine_io_t *io, char *buf, int size, int add_addr,
 				  add_port);
 }
 
+/* peer address and port with a single syscall */
+int od_getpeer(machine_io_t *io, char *host, int host_size, char *port,
+	       int port_size)
+{
+	struct sockaddr_storage sa;
+	int salen = sizeof(sa);
+	int rc = machine_getpeername(io, (struct sockaddr *)&sa, &salen);
+	if (rc < 0) {
+		od_snprintf(host, host_size, "%s", "");
+		od_snprintf(port, port_size, "%s", "");
+		return -1;
+	}
+	od_getsockaddrname((struct sockaddr *)&sa, host, host_size, 1, 0);
+	return od_getsockaddrname((struct sockaddr *)&sa, port, port_size, 0,
+				  1);
+}
+
 int od_getsockname(machine_io_t *io, char *buf, int size, int add_addr,
 		   int add_port)
 {
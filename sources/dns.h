@@ -9,6 +9,7 @@
 
 int od_getaddrname(struct addrinfo *, char *, int, int, int);
 int od_getpeername(machine_io_t *, char *, int, int, int);
+int od_getpeer(machine_io_t *, char *, int, char *, int);
 int od_getsockname(machine_io_t *, char *, int, int, int);
 
 #endif /* ODYSSEY_DNS_H */
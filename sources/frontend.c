@@ -111,7 +111,7 @@ od_frontend_error_is_too_many_connections(od_client_t *client)
 	return strcmp(error.code, KIWI_TOO_MANY_CONNECTIONS) == 0;
 }
 
-static int od_frontend_startup(od_client_t *client)
+int od_frontend_startup_tls(od_client_t *client)
 {
 	od_instance_t *instance = client->global->instance;
 	machine_msg_t *msg;
@@ -151,10 +151,36 @@ static int od_frontend_startup(od_client_t *client)
 	}
 
 	/* client ssl request */
+	uint64_t tls_start = machine_time_us();
 	int rc = od_tls_frontend_accept(client, &instance->logger,
 					client->config_listen, client->tls);
 	if (rc == -1)
 		goto error;
+	if (client->startup.is_ssl_request)
+		client->lifecycle[OD_LIFECYCLE_TLS] =
+			machine_time_us() - tls_start;
+	return 0;
+
+error:
+	od_debug(&instance->logger, "startup", client, NULL,
+		 "startup packet read error");
+	od_cron_t *cron = client->global->cron;
+	od_atomic_u64_inc(&cron->startup_errors);
+	return -1;
+}
+
+static int od_frontend_startup(od_client_t *client)
+{
+	od_instance_t *instance = client->global->instance;
+	machine_msg_t *msg;
+	int rc;
+
+	/* handshake machine has already read startup and negotiated ssl */
+	if (!client->tls_offloaded) {
+		rc = od_frontend_startup_tls(client);
+		if (rc == -1)
+			return -1;
+	}
 
 	if (!client->startup.is_ssl_request) {
 		rc = od_compression_frontend_setup(
@@ -193,6 +219,30 @@ error:
 	return -1;
 }
 
+static inline void od_frontend_refresh_params(od_client_t *client,
+					      kiwi_params_t *params)
+{
+	od_instance_t *instance = client->global->instance;
+	od_router_t *router = client->global->router;
+	od_route_t *route = client->route;
+
+	/* params are set by the first client */
+	if (kiwi_params_lock_count(&route->params) == 0) {
+		kiwi_params_free(params);
+		return;
+	}
+
+	int rc;
+	rc = kiwi_params_lock_update(&route->params, params);
+	if (rc != 1) {
+		kiwi_params_free(params);
+		return;
+	}
+	od_log(&instance->logger, "setup", client, client->server,
+	       "server reported changed parameters, route params refreshed");
+	od_router_save_params(router, route);
+}
+
 static inline od_frontend_status_t
 od_frontend_attach(od_client_t *client, char *context,
 		   kiwi_params_t *route_params)
@@ -234,10 +284,27 @@ od_frontend_attach(od_client_t *client, char *context,
 			return OD_OK;
 		}
 
+		/* parameters reported by a new server refresh the route */
+		kiwi_params_t server_params;
+		kiwi_params_init(&server_params);
+
 		int rc;
+		uint64_t connect_start = machine_time_us();
 		od_atomic_u32_inc(&router->servers_routing);
-		rc = od_backend_connect(server, context, route_params, client);
+		rc = od_backend_connect(server, context,
+					route_params ? route_params :
+						       &server_params,
+					client);
 		od_atomic_u32_dec(&router->servers_routing);
+		if (rc == 0) {
+			uint64_t connect_time = machine_time_us() - connect_start;
+			client->lifecycle[OD_LIFECYCLE_CONNECT] += connect_time;
+			od_lifecycle_add(&route->lifecycle,
+					 OD_LIFECYCLE_CONNECT, connect_time);
+			od_frontend_refresh_params(client, &server_params);
+		} else {
+			kiwi_params_free(&server_params);
+		}
 		if (rc == -1) {
 			/* In case of 'too many connections' error, retry attach attempt by
 			 * waiting for a idle server connection for pool_timeout ms
@@ -280,11 +347,42 @@ od_frontend_attach_and_deploy(od_client_t *client, char *context)
 
 	/* set number of replies to discard */
 	client->server->deploy_sync = rc;
+	if (rc > 0)
+		server->deploy_start_us = machine_time_us();
 
 	od_server_sync_request(server, server->deploy_sync);
 	return OD_OK;
 }
 
+static inline void od_frontend_setup_params_log(od_client_t *client)
+{
+	od_instance_t *instance = client->global->instance;
+	od_route_t *route = client->route;
+
+	od_debug(&instance->logger, "setup", client, NULL, "sending params:");
+
+	/* params may be refreshed concurrently */
+	pthread_mutex_lock(&route->params.lock);
+	kiwi_param_t *param = route->params.params.list;
+	for (; param; param = param->next) {
+		kiwi_var_type_t type;
+		type = kiwi_var_find(kiwi_param_name(param), param->name_len);
+		kiwi_var_t *var;
+		var = kiwi_vars_get(&client->vars, type);
+		if (var) {
+			od_debug(&instance->logger, "setup", client, NULL,
+				 " %.*s = %.*s", var->name_len, var->name,
+				 var->value_len, var->value);
+		} else {
+			od_debug(&instance->logger, "setup", client, NULL,
+				 " %.*s = %.*s", param->name_len,
+				 kiwi_param_name(param), param->value_len,
+				 kiwi_param_value(param));
+		}
+	}
+	pthread_mutex_unlock(&route->params.lock);
+}
+
 static inline od_frontend_status_t od_frontend_setup_params(od_client_t *client)
 {
 	od_instance_t *instance = client->global->instance;
@@ -311,59 +409,202 @@ static inline od_frontend_status_t od_frontend_setup_params(od_client_t *client)
 		/* There is possible race here, so we will discard our
 		 * attempt if params are already set */
 		rc = kiwi_params_lock_set_once(&route->params, &route_params);
+		if (rc == -1) {
+			kiwi_params_free(&route_params);
+			return OD_EOOM;
+		}
 		if (!rc)
 			kiwi_params_free(&route_params);
+		else
+			od_router_save_params(router, route);
 	}
 
-	od_debug(&instance->logger, "setup", client, NULL, "sending params:");
+	if (instance->config.log_debug)
+		od_frontend_setup_params_log(client);
 
 	/* send parameters set by client or cached by the route */
-	kiwi_param_t *param = route->params.params.list;
-
-	machine_msg_t *stream = machine_msg_create(0);
+	machine_msg_t *stream;
+	stream = kiwi_params_lock_status_msg(&route->params, &client->vars);
 	if (stream == NULL)
 		return OD_EOOM;
 
-	while (param) {
-		kiwi_var_type_t type;
-		type = kiwi_vars_find(&client->vars, kiwi_param_name(param),
-				      param->name_len);
-		kiwi_var_t *var;
-		var = kiwi_vars_get(&client->vars, type);
+	rc = od_write(&client->io, stream);
+	if (rc == -1)
+		return OD_ECLIENT_WRITE;
 
-		machine_msg_t *msg;
-		if (var) {
-			msg = kiwi_be_write_parameter_status(stream, var->name,
-							     var->name_len,
-							     var->value,
-							     var->value_len);
+	return OD_OK;
+}
 
-			od_debug(&instance->logger, "setup", client, NULL,
-				 " %.*s = %.*s", var->name_len, var->name,
-				 var->value_len, var->value);
-		} else {
-			msg = kiwi_be_write_parameter_status(
-				stream, kiwi_param_name(param), param->name_len,
-				kiwi_param_value(param), param->value_len);
+static inline int od_frontend_prefetch_route(od_global_t *global, char *db,
+					     char *user)
+{
+	od_instance_t *instance = global->instance;
+	od_router_t *router = global->router;
 
-			od_debug(&instance->logger, "setup", client, NULL,
-				 " %.*s = %.*s", param->name_len,
-				 kiwi_param_name(param), param->value_len,
-				 kiwi_param_value(param));
-		}
-		if (msg == NULL) {
-			machine_msg_free(stream);
-			return OD_EOOM;
-		}
+	od_client_t *client;
+	client = od_client_allocate_internal(global, "prefetch");
+	if (client == NULL)
+		return -1;
 
-		param = param->next;
+	/* route as an ordinary client, internal clients are matched
+	 * only by internal rules */
+	client->type = OD_POOL_CLIENT_EXTERNAL;
+	kiwi_var_set(&client->startup.user, KIWI_VAR_UNDEF, user,
+		     strlen(user) + 1);
+	kiwi_var_set(&client->startup.database, KIWI_VAR_UNDEF, db,
+		     strlen(db) + 1);
+
+	od_router_status_t status;
+	status = od_router_route(router, client);
+	if (status != OD_ROUTER_OK) {
+		od_client_free(client);
+		return -1;
 	}
+	od_route_t *route = client->route;
 
-	rc = od_write(&client->io, stream);
-	if (rc == -1)
-		return OD_ECLIENT_WRITE;
+	int rc = 0;
+	if (kiwi_params_lock_count(&route->params) > 0)
+		goto done;
 
-	return OD_OK;
+	status = od_router_attach(router, client, false);
+	if (status != OD_ROUTER_OK) {
+		rc = -1;
+		goto done;
+	}
+	od_server_t *server = client->server;
+
+	kiwi_params_t route_params;
+	kiwi_params_init(&route_params);
+	/* params are reported only on backend startup */
+	rc = -1;
+	if (server->io.io == NULL)
+		rc = od_backend_connect(server, "prefetch", &route_params,
+					client);
+	od_router_close(router, client);
+	if (rc == -1) {
+		kiwi_params_free(&route_params);
+		goto done;
+	}
+
+	rc = kiwi_params_lock_set_once(&route->params, &route_params);
+	if (rc == 1)
+		od_router_save_params(router, route);
+	else
+		kiwi_params_free(&route_params);
+	rc = rc == -1 ? -1 : 0;
+
+done:
+	od_router_unroute(router, client);
+	od_client_free(client);
+	if (rc == 0)
+		od_debug(&instance->logger, "prefetch", NULL, NULL,
+			 "route %s.%s params are cached", db, user);
+	return rc;
+}
+
+void od_frontend_prefetch_params(void *arg)
+{
+	od_global_t *global = arg;
+	od_instance_t *instance = global->instance;
+	od_router_t *router = global->router;
+
+	/* copy names of the client visible remote rules, rules can be
+	 * reloaded while their servers are connected */
+	od_router_lock(router);
+	int count = 0;
+	od_list_t *i;
+	od_list_foreach(&router->rules.rules, i)
+	{
+		od_rule_t *rule;
+		rule = od_container_of(i, od_rule_t, link);
+		if (rule->obsolete || rule->db_is_default ||
+		    rule->user_is_default)
+			continue;
+		if (rule->storage->storage_type != OD_RULE_STORAGE_REMOTE)
+			continue;
+		if (!od_rule_matches_client(rule->pool,
+					    OD_POOL_CLIENT_EXTERNAL))
+			continue;
+		count++;
+	}
+	char **names = calloc(count * 2 + 1, sizeof(char *));
+	if (names == NULL) {
+		od_router_unlock(router);
+		return;
+	}
+	int n = 0;
+	od_list_foreach(&router->rules.rules, i)
+	{
+		od_rule_t *rule;
+		rule = od_container_of(i, od_rule_t, link);
+		if (rule->obsolete || rule->db_is_default ||
+		    rule->user_is_default)
+			continue;
+		if (rule->storage->storage_type != OD_RULE_STORAGE_REMOTE)
+			continue;
+		if (!od_rule_matches_client(rule->pool,
+					    OD_POOL_CLIENT_EXTERNAL))
+			continue;
+		names[n] = strdup(rule->db_name);
+		names[n + 1] = strdup(rule->user_name);
+		n += 2;
+	}
+	od_router_unlock(router);
+
+	int fetched = 0;
+	for (n = 0; n < count * 2; n += 2) {
+		if (names[n] == NULL || names[n + 1] == NULL)
+			continue;
+		int rc;
+		rc = od_frontend_prefetch_route(global, names[n], names[n + 1]);
+		if (rc == -1) {
+			od_error(&instance->logger, "prefetch", NULL, NULL,
+				 "failed to fetch route %s.%s params, "
+				 "first client will fetch them",
+				 names[n], names[n + 1]);
+			continue;
+		}
+		fetched++;
+	}
+	for (n = 0; n < count * 2; n++)
+		free(names[n]);
+	free(names);
+
+	od_log(&instance->logger, "prefetch", NULL, NULL,
+	       "params of %d/%d routes are cached", fetched, count);
+}
+
+/* account login phases, which happened before route was known */
+static inline void od_frontend_lifecycle(od_client_t *client)
+{
+	od_instance_t *instance = client->global->instance;
+	od_route_t *route = client->route;
+
+	uint64_t *phases = client->lifecycle;
+	phases[OD_LIFECYCLE_LOGIN] = client->time_setup - client->time_accept;
+	if (client->startup.is_ssl_request)
+		od_lifecycle_add(&route->lifecycle, OD_LIFECYCLE_TLS,
+				 phases[OD_LIFECYCLE_TLS]);
+	od_lifecycle_add(&route->lifecycle, OD_LIFECYCLE_ROUTE,
+			 phases[OD_LIFECYCLE_ROUTE]);
+	od_lifecycle_add(&route->lifecycle, OD_LIFECYCLE_AUTH,
+			 phases[OD_LIFECYCLE_AUTH]);
+	od_lifecycle_add(&route->lifecycle, OD_LIFECYCLE_LOGIN,
+			 phases[OD_LIFECYCLE_LOGIN]);
+
+	int threshold = instance->config.log_login_min_duration;
+	if (threshold == 0 ||
+	    phases[OD_LIFECYCLE_LOGIN] < (uint64_t)threshold * 1000)
+		return;
+	od_log_duration(&instance->logger, "setup", client, NULL,
+			phases[OD_LIFECYCLE_LOGIN],
+			"slow login: %" PRIu64 " us (tls %" PRIu64
+			", route %" PRIu64 ", auth %" PRIu64 ", queue %" PRIu64
+			", connect %" PRIu64 ")",
+			phases[OD_LIFECYCLE_LOGIN], phases[OD_LIFECYCLE_TLS],
+			phases[OD_LIFECYCLE_ROUTE], phases[OD_LIFECYCLE_AUTH],
+			phases[OD_LIFECYCLE_QUEUE],
+			phases[OD_LIFECYCLE_CONNECT]);
 }
 
 static inline od_frontend_status_t od_frontend_setup(od_client_t *client)
@@ -406,11 +647,14 @@ static inline od_frontend_status_t od_frontend_setup(od_client_t *client)
 	if (rc == -1)
 		return OD_ECLIENT_WRITE;
 
+	client->time_setup = machine_time_us();
+	od_frontend_lifecycle(client);
+
 	if (instance->config.log_session) {
-		client->time_setup = machine_time_us();
-		od_log(&instance->logger, "setup", client, NULL,
-		       "login time: %d microseconds",
-		       (client->time_setup - client->time_accept));
+		od_log_duration(&instance->logger, "setup", client, NULL,
+				client->time_setup - client->time_accept,
+				"login time: %d microseconds",
+				(client->time_setup - client->time_accept));
 		od_log(&instance->logger, "setup", client, NULL,
 		       "client connection from %s to route %s.%s accepted",
 		       client->peer, route->rule->db_name,
@@ -724,6 +968,140 @@ static od_frontend_status_t od_frontend_local(od_client_t *client)
 	return OD_OK;
 }
 
+static inline void od_frontend_deploy_complete(od_client_t *client,
+					       od_server_t *server)
+{
+	od_route_t *route = client->route;
+	uint64_t deploy_time = machine_time_us() - server->deploy_start_us;
+	server->deploy_start_us = 0;
+	client->lifecycle[OD_LIFECYCLE_DEPLOY] += deploy_time;
+	od_lifecycle_add(&route->lifecycle, OD_LIFECYCLE_DEPLOY, deploy_time);
+}
+
+/* statements are tracked from client messages for query statistics,
+ * slow query capture and logging */
+static inline int od_frontend_query_track_enabled(od_rule_t *rule)
+{
+	return rule->query_stats || rule->slow_query_threshold > 0 ||
+	       rule->log_query_min_duration > 0;
+}
+
+static inline void od_frontend_slow_query(od_client_t *client,
+					  od_server_t *server,
+					  od_slow_query_type_t type,
+					  int64_t duration, uint64_t bytes,
+					  od_query_stats_stmt_t *stmt)
+{
+	od_router_t *router = client->global->router;
+
+	od_slow_query_t record;
+	record.type = type;
+	record.time = time(NULL);
+	record.client_id = client->id;
+	record.server_id = server->id;
+	od_snprintf(record.user, sizeof(record.user), "%s",
+		    client->startup.user.value);
+	od_snprintf(record.database, sizeof(record.database), "%s",
+		    client->startup.database.value);
+	record.duration_us = duration;
+	record.bytes = bytes;
+	record.text_len = 0;
+	if (stmt) {
+		record.text_len = stmt->text_len;
+		if (record.text_len > OD_SLOW_QUERY_TEXT_MAX)
+			record.text_len = OD_SLOW_QUERY_TEXT_MAX;
+		memcpy(record.text, stmt->text, record.text_len);
+	}
+	od_slow_query_ring_add(&router->slow_queries, &record);
+}
+
+/* server executes pipelined statements one by one, so each one
+ * starts no earlier than the previous one completes */
+static inline void od_frontend_query_complete(od_client_t *client,
+					      od_server_t *server,
+					      od_query_stats_exec_t *exec)
+{
+	od_router_t *router = client->global->router;
+	od_instance_t *instance = client->global->instance;
+	od_route_t *route = client->route;
+	od_rule_t *rule = route->rule;
+	uint64_t now = machine_time_us();
+	uint64_t start = exec->start_us;
+	if (start < server->query_end_us)
+		start = server->query_end_us;
+	uint64_t time_us = 0;
+	if (now > start)
+		time_us = now - start;
+	server->query_end_us = now;
+
+	uint64_t rows = server->query_rows;
+	uint64_t bytes = server->query_exec_bytes;
+	server->query_rows = 0;
+	server->query_exec_bytes = 0;
+
+	/* text is that of the statement completed, or empty if the
+	 * statement or its portal is unknown */
+	od_query_stats_stmt_t *stmt = &exec->stmt;
+
+	if ((instance->config.log_query || rule->log_query) &&
+	    rule->log_query_min_duration > 0 &&
+	    time_us >= rule->log_query_min_duration * 1000ull &&
+	    od_route_log_query_take(route)) {
+		if (stmt->text_len > 0)
+			od_log_duration(&instance->logger, "slow query",
+					client, server, time_us,
+					"duration: %" PRIu64 " ms, query: %.*s",
+					time_us / 1000, stmt->text_len,
+					stmt->text);
+		else
+			od_log_duration(&instance->logger, "slow query",
+					client, server, time_us,
+					"duration: %" PRIu64 " ms",
+					time_us / 1000);
+	}
+
+	if (rule->slow_query_threshold > 0 &&
+	    time_us >= rule->slow_query_threshold * 1000ull)
+		od_frontend_slow_query(client, server, OD_SLOW_QUERY,
+				       time_us, bytes, stmt);
+
+	if (!rule->query_stats || stmt->text_len == 0)
+		return;
+	od_query_stats_add(&router->query_stats, stmt->fingerprint,
+			   client->startup.user.value,
+			   client->startup.database.value, stmt->text,
+			   stmt->text_len, time_us, rows, bytes);
+}
+
+/* Execute is complete on its own reply */
+static inline void od_frontend_query_stats_execute(od_client_t *client,
+						   od_server_t *server)
+{
+	od_query_stats_pipeline_t *pipeline = &client->query_pipeline;
+	od_query_stats_exec_t *exec = od_query_stats_pipeline_head(pipeline);
+	if (exec == NULL || exec->type != OD_QUERY_STATS_EXEC_EXTENDED)
+		return;
+	od_frontend_query_complete(client, server, exec);
+	od_query_stats_pipeline_pop(pipeline);
+}
+
+/* Query and Sync are complete on ReadyForQuery, Executes left before
+ * them were skipped by the server after an error */
+static inline void od_frontend_query_stats_ready(od_client_t *client,
+						 od_server_t *server)
+{
+	od_query_stats_pipeline_t *pipeline = &client->query_pipeline;
+	od_query_stats_exec_t *exec;
+	while ((exec = od_query_stats_pipeline_head(pipeline))) {
+		od_query_stats_exec_type_t type = exec->type;
+		if (type == OD_QUERY_STATS_EXEC_SIMPLE)
+			od_frontend_query_complete(client, server, exec);
+		od_query_stats_pipeline_pop(pipeline);
+		if (type != OD_QUERY_STATS_EXEC_EXTENDED)
+			break;
+	}
+}
+
 static od_frontend_status_t od_frontend_remote_server(od_relay_t *relay,
 						      char *data, int size)
 {
@@ -739,11 +1117,20 @@ static od_frontend_status_t od_frontend_remote_server(od_relay_t *relay,
 
 	int is_deploy = od_server_in_deploy(server);
 	int is_ready_for_query = 0;
+	int is_query_track =
+		!is_deploy && od_frontend_query_track_enabled(route->rule);
 
 	int rc;
 	switch (type) {
 	case KIWI_BE_ERROR_RESPONSE:
 		od_backend_error(server, "main", data, size);
+		if (is_query_track)
+			od_frontend_query_stats_execute(client, server);
+		break;
+	case KIWI_BE_EMPTY_QUERY_RESPONSE:
+	case KIWI_BE_PORTAL_SUSPENDED:
+		if (is_query_track)
+			od_frontend_query_stats_execute(client, server);
 		break;
 	case KIWI_BE_PARAMETER_STATUS:
 		rc = od_backend_update_parameter(server, "main", data, size, 0);
@@ -757,12 +1144,23 @@ static od_frontend_status_t od_frontend_remote_server(od_relay_t *relay,
 	case KIWI_BE_COPY_DONE:
 		server->is_copy = 0;
 		break;
+	case KIWI_BE_COMMAND_COMPLETE:
+		if (is_query_track) {
+			server->query_rows += od_query_stats_rows(data, size);
+			od_frontend_query_stats_execute(client, server);
+		}
+		break;
 	case KIWI_BE_READY_FOR_QUERY: {
 		is_ready_for_query = 1;
 		od_backend_ready(server, data, size);
 
-		if (is_deploy)
+		if (is_deploy) {
 			server->deploy_sync--;
+			if (server->deploy_sync == 0 && server->deploy_start_us)
+				od_frontend_deploy_complete(client, server);
+		} else if (is_query_track) {
+			od_frontend_query_stats_ready(client, server);
+		}
 
 		if (!server->synced_settings) {
 			server->synced_settings = true;
@@ -770,14 +1168,32 @@ static od_frontend_status_t od_frontend_remote_server(od_relay_t *relay,
 		}
 		/* update server stats */
 		int64_t query_time = 0;
+		int64_t tx_time = 0;
 		od_stat_query_end(&route->stats, &server->stats_state,
-				  server->is_transaction, &query_time);
+				  server->is_transaction, &query_time,
+				  &tx_time);
 		if (instance->config.log_debug && query_time > 0) {
-			od_debug(&instance->logger, "main", server->client,
-				 server, "query time: %" PRIi64 " microseconds",
-				 query_time);
+			od_debug_duration(&instance->logger, "main",
+					  server->client, server, query_time,
+					  "query time: %" PRIi64
+					  " microseconds",
+					  query_time);
 		}
 
+		/* statements are captured on completion, transactions
+		 * here, without text, unless they have single statement */
+		od_rule_t *rule = route->rule;
+		int64_t threshold = rule->slow_query_threshold * 1000ll;
+		if (threshold > 0 && tx_time >= threshold &&
+		    tx_time > query_time)
+			od_frontend_slow_query(client, server,
+					       OD_SLOW_TRANSACTION, tx_time,
+					       server->query_bytes, NULL);
+
+		/* next transaction gets its own sampling decision */
+		if (!server->is_transaction)
+			client->log_query_decided = 0;
+
 		break;
 	}
 	case KIWI_BE_PARSE_COMPLETE:
@@ -945,13 +1361,18 @@ static inline od_retcode_t od_frontend_log_bind(od_instance_t *instance,
 // 8 hex
 #define OD_HASH_LEN 9
 
+/* data may hold only the beginning of a streamed message,
+ * message size is taken from its header */
 static inline machine_msg_t *od_frontend_rewrite_msg(char *data, int size,
 						     int opname_start_offset,
 						     int operator_name_len,
 						     od_hash_t body_hash)
 {
+	int total = kiwi_read_size(data, size) + sizeof(uint8_t);
 	machine_msg_t *msg =
 		machine_msg_create(size - operator_name_len + OD_HASH_LEN);
+	if (msg == NULL)
+		return NULL;
 	char *rewrite_data = machine_msg_data(msg);
 
 	// packet header
@@ -965,11 +1386,200 @@ static inline machine_msg_t *od_frontend_rewrite_msg(char *data, int size,
 	       size - opname_start_offset - operator_name_len);
 	// set proper size to package
 	kiwi_header_set_size((kiwi_header_t *)rewrite_data,
-			     size - operator_name_len + OD_HASH_LEN);
+			     total - operator_name_len + OD_HASH_LEN);
 
 	return msg;
 }
 
+/* cheap check made before any query log formatting */
+static inline int od_frontend_log_query_enabled(od_instance_t *instance,
+						od_client_t *client,
+						od_route_t *route)
+{
+	od_rule_t *rule = route->rule;
+	if (!instance->config.log_query && !rule->log_query)
+		return 0;
+
+	/* only slow queries are logged, on completion */
+	if (rule->log_query_min_duration > 0)
+		return 0;
+
+	if (!client->log_query_decided) {
+		client->log_query_decided = 1;
+		client->log_query_sampled = od_route_log_query_sample(route);
+	}
+	if (!client->log_query_sampled)
+		return 0;
+
+	/* message logged at several places takes a single token,
+	 * so it is either logged whole or not at all */
+	if (client->log_query_message == -1)
+		client->log_query_message = od_route_log_query_take(route);
+	return client->log_query_message;
+}
+
+/* statements are keyed by 'S' and portals by 'P' followed by name,
+ * longer names are not tracked */
+#define OD_FRONTEND_QUERY_STMT_KEY_MAX 256
+
+static inline int od_frontend_query_stmt_key(char *key, char kind, char *name,
+					     uint32_t name_len)
+{
+	if (name_len >= OD_FRONTEND_QUERY_STMT_KEY_MAX)
+		return -1;
+	key[0] = kind;
+	memcpy(key + 1, name, name_len);
+	return name_len + 1;
+}
+
+static inline void od_frontend_query_stmt_set(od_client_t *client, char kind,
+					      char *name, uint32_t name_len,
+					      od_query_stats_stmt_t *stmt)
+{
+	char key_data[OD_FRONTEND_QUERY_STMT_KEY_MAX];
+	int rc;
+	rc = od_frontend_query_stmt_key(key_data, kind, name, name_len);
+	if (rc == -1)
+		return;
+	if (client->query_stmts == NULL) {
+		client->query_stmts =
+			od_hashmap_create(OD_CLIENT_QUERY_STMTS_HASHMAP_SZ);
+		if (client->query_stmts == NULL)
+			return;
+	}
+	od_hashmap_elt_t key;
+	key.data = key_data;
+	key.len = rc;
+	od_hashmap_elt_t value;
+	value.data = stmt;
+	value.len = od_query_stats_stmt_size(stmt);
+	od_hashmap_elt_t *value_ptr = &value;
+	od_hashmap_insert(client->query_stmts,
+			  od_murmur_hash(key.data, key.len), &key, &value_ptr);
+}
+
+static inline od_hashmap_elt_t *od_frontend_query_stmt_find(od_client_t *client,
+							    char kind,
+							    char *name,
+							    uint32_t name_len)
+{
+	if (client->query_stmts == NULL)
+		return NULL;
+	char key_data[OD_FRONTEND_QUERY_STMT_KEY_MAX];
+	int rc;
+	rc = od_frontend_query_stmt_key(key_data, kind, name, name_len);
+	if (rc == -1)
+		return NULL;
+	od_hashmap_elt_t key;
+	key.data = key_data;
+	key.len = rc;
+	return od_hashmap_find(client->query_stmts,
+			       od_murmur_hash(key.data, key.len), &key);
+}
+
+/* queries are pushed even if unreadable, to keep the pipeline in
+ * order with server replies */
+static inline od_query_stats_exec_t *
+od_frontend_query_stats_push(od_client_t *client,
+			     od_query_stats_exec_type_t type)
+{
+	od_query_stats_pipeline_t *pipeline = &client->query_pipeline;
+	/* client wakeup time includes wait for server */
+	uint64_t start = client->time_last_active;
+	if (pipeline->count > 0)
+		start = machine_time_us();
+	return od_query_stats_pipeline_push(pipeline, type, start);
+}
+
+static inline void od_frontend_query_stats_client(od_client_t *client,
+						  char *data, int size)
+{
+	kiwi_fe_type_t type = *data;
+	od_query_stats_stmt_t stmt;
+	od_query_stats_exec_t *exec;
+	od_hashmap_elt_t *elt;
+	char *name;
+	uint32_t name_len;
+	char *query;
+	uint32_t query_len;
+	switch (type) {
+	case KIWI_FE_QUERY:
+		exec = od_frontend_query_stats_push(client,
+						    OD_QUERY_STATS_EXEC_SIMPLE);
+		if (exec == NULL)
+			break;
+		if (kiwi_be_read_query(data, size, &query, &query_len) == 0)
+			od_query_stats_stmt_set(&exec->stmt, query, query_len);
+		break;
+	case KIWI_FE_PARSE:
+		if (kiwi_be_read_parse(data, size, &name, &name_len, &query,
+				       &query_len) == -1)
+			break;
+		od_query_stats_stmt_set(&stmt, query, query_len);
+		od_frontend_query_stmt_set(client, 'S', name, name_len, &stmt);
+		break;
+	case KIWI_FE_BIND: {
+		char *portal;
+		uint32_t portal_len;
+		if (kiwi_be_read_bind_names(data, size, &portal, &portal_len,
+					    &name, &name_len) == -1)
+			break;
+		elt = od_frontend_query_stmt_find(client, 'S', name, name_len);
+		if (elt) {
+			od_frontend_query_stmt_set(client, 'P', portal,
+						   portal_len, elt->data);
+			break;
+		}
+		/* forget statement of the previous portal */
+		stmt.fingerprint = 0;
+		stmt.text_len = 0;
+		od_frontend_query_stmt_set(client, 'P', portal, portal_len,
+					   &stmt);
+		break;
+	}
+	case KIWI_FE_EXECUTE:
+		exec = od_frontend_query_stats_push(
+			client, OD_QUERY_STATS_EXEC_EXTENDED);
+		if (exec == NULL)
+			break;
+		if (kiwi_be_read_execute(data, size, &name, &name_len) == -1)
+			break;
+		elt = od_frontend_query_stmt_find(client, 'P', name, name_len);
+		if (elt)
+			memcpy(&exec->stmt, elt->data, elt->len);
+		break;
+	case KIWI_FE_FUNCTION_CALL:
+	case KIWI_FE_SYNC:
+		od_frontend_query_stats_push(client, OD_QUERY_STATS_EXEC_SYNC);
+		break;
+	default:
+		break;
+	}
+}
+
+/* reply to the client with a preencoded message, in order with
+ * server replies which are already relayed, it is written directly
+ * only when nothing is relayed to the client */
+static inline od_frontend_status_t
+od_frontend_reply_bytes(od_client_t *client, const char *data, int size)
+{
+	int rc;
+	rc = od_relay_write_bytes(&client->server->relay, data, size);
+	if (rc == -1)
+		return OD_EOOM;
+	if (rc == 1)
+		return OD_OK;
+
+	machine_msg_t *msg;
+	msg = kiwi_be_write_bytes(NULL, data, size);
+	if (msg == NULL)
+		return OD_EOOM;
+	rc = od_write(&client->io, msg);
+	if (rc == -1)
+		return OD_ECLIENT_WRITE;
+	return OD_OK;
+}
+
 static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 						      char *data, int size)
 {
@@ -992,16 +1602,21 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 		od_debug(&instance->logger, "remote client", client, server,
 			 "%s", kiwi_fe_type_to_string(type));
 
+	client->log_query_message = -1;
+
 	od_frontend_status_t retstatus = OD_OK;
 	machine_msg_t *msg;
 
+	if (od_frontend_query_track_enabled(route->rule))
+		od_frontend_query_stats_client(client, data, size);
+
 	switch (type) {
 	case KIWI_FE_COPY_DONE:
 	case KIWI_FE_COPY_FAIL:
 		server->is_copy = 0;
 		break;
 	case KIWI_FE_QUERY:
-		if (instance->config.log_query || route->rule->log_query)
+		if (od_frontend_log_query_enabled(instance, client, route))
 			od_frontend_log_query(instance, client, data, size);
 		/* update server sync state */
 		od_server_sync_request(server, 1);
@@ -1012,7 +1627,7 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 		od_server_sync_request(server, 1);
 		break;
 	case KIWI_FE_DESCRIBE:
-		if (instance->config.log_query || route->rule->log_query)
+		if (od_frontend_log_query_enabled(instance, client, route))
 			od_frontend_log_describe(instance, client, data, size);
 
 		if (route->rule->pool->reserve_prepared_statement) {
@@ -1090,8 +1705,8 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 					return OD_ESERVER_WRITE;
 				}
 
-				if (instance->config.log_query ||
-				    route->rule->log_query) {
+				if (od_frontend_log_query_enabled(
+					    instance, client, route)) {
 					od_frontend_log_parse(
 						instance, client,
 						"rewrite parse",
@@ -1100,13 +1715,10 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 				}
 
 				od_stat_parse(&route->stats);
-				rc = od_write(&server->io, msg);
+				rc = machine_iov_add(relay->iov, msg);
 				if (rc == -1) {
-					od_error(&instance->logger, "describe",
-						 NULL, server,
-						 "write error: %s",
-						 od_io_error(&server->io));
-					return OD_ESERVER_WRITE;
+					machine_msg_free(msg);
+					return OD_EOOM;
 				}
 			} else {
 				int *refcnt;
@@ -1121,25 +1733,23 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 				return OD_ESERVER_WRITE;
 			}
 
-			if (instance->config.log_query ||
-			    route->rule->log_query) {
+			if (od_frontend_log_query_enabled(
+				    instance, client, route)) {
 				od_frontend_log_describe(instance, client,
 							 machine_msg_data(msg),
 							 machine_msg_size(msg));
 			}
 
 			// msg if deallocated automaictly
-			rc = od_write(&server->io, msg);
+			rc = machine_iov_add(relay->iov, msg);
 			if (rc == -1) {
-				od_error(&instance->logger, "describe", NULL,
-					 server, "write error: %s",
-					 od_io_error(&server->io));
-				return OD_ESERVER_WRITE;
+				machine_msg_free(msg);
+				return OD_EOOM;
 			}
 		}
 		break;
 	case KIWI_FE_PARSE:
-		if (instance->config.log_query || route->rule->log_query)
+		if (od_frontend_log_query_enabled(instance, client, route))
 			od_frontend_log_parse(instance, client, "parse", data,
 					      size);
 
@@ -1199,15 +1809,14 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 
 					msg = kiwi_fe_write_close(
 						NULL, 'S', buf, OD_HASH_LEN);
-					rc = od_write(&server->io, msg);
-					if (rc == -1) {
-						od_error(&instance->logger,
-							 "parse", NULL, server,
-							 "write error: %s",
-							 od_io_error(
-								 &server->io));
+					if (msg == NULL) {
 						return OD_ESERVER_WRITE;
 					}
+					rc = machine_iov_add(relay->iov, msg);
+					if (rc == -1) {
+						machine_msg_free(msg);
+						return OD_EOOM;
+					}
 					msg = kiwi_fe_write_parse_description(
 						NULL, buf, OD_HASH_LEN,
 						desc.description,
@@ -1259,8 +1868,8 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 				// rewrite msg
 				// allocate prepered statement under name equal to body hash
 
-				if (instance->config.log_query ||
-				    route->rule->log_query) {
+				if (od_frontend_log_query_enabled(
+					    instance, client, route)) {
 					od_frontend_log_parse(
 						instance, client,
 						"rewrite parse",
@@ -1270,20 +1879,18 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 
 				// stat backend parse msg
 				od_stat_parse(&route->stats);
-				rc = od_write(&server->io, msg);
+				rc = machine_iov_add(relay->iov, msg);
 				if (rc == -1) {
-					od_error(&instance->logger, "parse",
-						 NULL, server,
-						 "write error: %s",
-						 od_io_error(&server->io));
-					return OD_ESERVER_WRITE;
+					machine_msg_free(msg);
+					return OD_EOOM;
 				}
 			} else {
 				int *refcnt = value_ptr->data;
 				*refcnt = 1 + *refcnt;
+				machine_msg_free(msg);
 
-				if (instance->config.log_query ||
-				    route->rule->log_query) {
+				if (od_frontend_log_query_enabled(
+					    instance, client, route)) {
 					od_stat_parse_reuse(&route->stats);
 					od_log(&instance->logger, "parse",
 					       client, server,
@@ -1291,22 +1898,20 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 				}
 			}
 
-			machine_msg_t *pmsg;
-			pmsg = kiwi_be_write_parse_complete(NULL);
-			if (pmsg == NULL) {
-				return OD_ESERVER_WRITE;
-			}
-			rc = od_write(&client->io, pmsg);
-			if (rc == -1) {
+			od_frontend_status_t status;
+			status = od_frontend_reply_bytes(
+				client, kiwi_be_parse_complete_bytes,
+				sizeof(kiwi_be_parse_complete_bytes));
+			if (status != OD_OK) {
 				od_error(&instance->logger, "parse", client,
 					 NULL, "write error: %s",
 					 od_io_error(&client->io));
-				return OD_ESERVER_WRITE;
+				return status;
 			}
 		}
 		break;
 	case KIWI_FE_BIND:
-		if (instance->config.log_query || route->rule->log_query)
+		if (od_frontend_log_query_enabled(instance, client, route))
 			od_frontend_log_bind(instance, client, "bind", data,
 					     size);
 
@@ -1383,8 +1988,8 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 					return OD_ESERVER_WRITE;
 				}
 
-				if (instance->config.log_query ||
-				    route->rule->log_query) {
+				if (od_frontend_log_query_enabled(
+					    instance, client, route)) {
 					od_frontend_log_parse(
 						instance, client,
 						"rewrite parse",
@@ -1393,13 +1998,10 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 				}
 
 				od_stat_parse(&route->stats);
-				rc = od_write(&server->io, msg);
+				rc = machine_iov_add(relay->iov, msg);
 				if (rc == -1) {
-					od_error(&instance->logger,
-						 "rewrite parse", NULL, server,
-						 "write error: %s",
-						 od_io_error(&server->io));
-					return OD_ESERVER_WRITE;
+					machine_msg_free(msg);
+					return OD_EOOM;
 				}
 			} else {
 				int *refcnt = value_ptr->data;
@@ -1415,25 +2017,25 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 				return OD_ESERVER_WRITE;
 			}
 
-			if (instance->config.log_query ||
-			    route->rule->log_query) {
+			if (od_frontend_log_query_enabled(
+				    instance, client, route)) {
 				od_frontend_log_bind(instance, client,
 						     "rewrite bind",
 						     machine_msg_data(msg),
 						     machine_msg_size(msg));
 			}
 
-			rc = od_write(&server->io, msg);
+			/* queued in place of the original message, rest
+			 * of the message may still be streamed after it */
+			rc = machine_iov_add(relay->iov, msg);
 			if (rc == -1) {
-				od_error(&instance->logger, "rewrite bind",
-					 NULL, server, "write error: %s",
-					 od_io_error(&server->io));
-				return OD_ESERVER_WRITE;
+				machine_msg_free(msg);
+				return OD_EOOM;
 			}
 		}
 		break;
 	case KIWI_FE_EXECUTE:
-		if (instance->config.log_query || route->rule->log_query)
+		if (od_frontend_log_query_enabled(instance, client, route))
 			od_frontend_log_execute(instance, client, data, size);
 		break;
 	case KIWI_FE_CLOSE:
@@ -1441,7 +2043,6 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 			char *name;
 			uint32_t name_len;
 			kiwi_fe_close_type_t type;
-			int rc;
 
 			if (od_frontend_parse_close(data, size, &name,
 						    &name_len,
@@ -1457,27 +2058,27 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 					client, server, "statement: %.*s",
 					name_len, name);
 
-				machine_msg_t *pmsg;
-				pmsg = kiwi_be_write_close_complete(NULL);
-
-				rc = od_write(&client->io, pmsg);
-				if (rc == -1) {
+				od_frontend_status_t status;
+				status = od_frontend_reply_bytes(
+					client, kiwi_be_close_complete_bytes,
+					sizeof(kiwi_be_close_complete_bytes));
+				if (status != OD_OK) {
 					od_error(&instance->logger,
 						 "close report", NULL, server,
 						 "write error: %s",
 						 od_io_error(&server->io));
-					return OD_ECLIENT_WRITE;
+					return status;
 				}
 			}
 
-			if (instance->config.log_query ||
-			    route->rule->log_query) {
+			if (od_frontend_log_query_enabled(
+				    instance, client, route)) {
 				od_frontend_log_close(instance, client, name,
 						      name_len, type);
 			}
 
-		} else if (instance->config.log_query ||
-			   route->rule->log_query) {
+		} else if (od_frontend_log_query_enabled(
+			    instance, client, route)) {
 			char *name;
 			uint32_t name_len;
 			kiwi_fe_close_type_t type;
@@ -1497,6 +2098,8 @@ static od_frontend_status_t od_frontend_remote_client(od_relay_t *relay,
 	}
 
 	/* update server stats */
+	if (!server->stats_state.query_time_start)
+		server->query_bytes = 0;
 	od_stat_query_start(&server->stats_state);
 	return retstatus;
 }
@@ -1505,6 +2108,9 @@ static void od_frontend_remote_server_on_read(od_relay_t *relay, int size)
 {
 	od_stat_t *stats = relay->on_read_arg;
 	od_stat_recv_server(stats, size);
+	od_server_t *server = od_container_of(relay, od_server_t, relay);
+	server->query_bytes += size;
+	server->query_exec_bytes += size;
 }
 
 static void od_frontend_remote_client_on_read(od_relay_t *relay, int size)
@@ -1513,6 +2119,60 @@ static void od_frontend_remote_client_on_read(od_relay_t *relay, int size)
 	od_stat_recv_client(stats, size);
 }
 
+static void od_frontend_remote_on_buffered(od_relay_t *relay, int delta)
+{
+	od_client_t *client = relay->on_packet_arg;
+	od_route_t *route = client->route;
+	client->buffered += delta;
+	od_stat_buffered(&route->stats, delta);
+}
+
+/* server messages which od_frontend_remote_server() passes as is */
+static const uint8_t od_frontend_remote_server_bulk_types[256] = {
+	[KIWI_BE_DATA_ROW] = 1,		    [KIWI_BE_COPY_DATA] = 1,
+	[KIWI_BE_ROW_DESCRIPTION] = 1,	    [KIWI_BE_PARAMETER_DESCRIPTION] = 1,
+	[KIWI_BE_BIND_COMPLETE] = 1,	    [KIWI_BE_CLOSE_COMPLETE] = 1,
+	[KIWI_BE_NO_DATA] = 1,		    [KIWI_BE_PORTAL_SUSPENDED] = 1,
+	[KIWI_BE_EMPTY_QUERY_RESPONSE] = 1,
+};
+
+/* query statistics complete Execute on PortalSuspended and
+ * EmptyQueryResponse */
+static const uint8_t od_frontend_query_stats_bulk_types[256] = {
+	[KIWI_BE_DATA_ROW] = 1,		    [KIWI_BE_COPY_DATA] = 1,
+	[KIWI_BE_ROW_DESCRIPTION] = 1,	    [KIWI_BE_PARAMETER_DESCRIPTION] = 1,
+	[KIWI_BE_BIND_COMPLETE] = 1,	    [KIWI_BE_CLOSE_COMPLETE] = 1,
+	[KIWI_BE_NO_DATA] = 1,
+};
+
+static int od_frontend_remote_server_bulk(od_relay_t *relay)
+{
+	od_client_t *client = relay->on_packet_arg;
+	od_server_t *server = client->server;
+	od_route_t *route = client->route;
+	od_instance_t *instance = client->global->instance;
+
+	/* every message is logged or discarded */
+	if (instance->config.log_debug || od_server_in_deploy(server))
+		return 0;
+
+	/* replication server is detached on any message when offline */
+	if ((route->id.physical_rep || route->id.logical_rep) &&
+	    server->offline)
+		return 0;
+
+	return 1;
+}
+
+static inline void od_frontend_relay_limits(od_instance_t *instance,
+					    od_relay_t *relay)
+{
+	relay->splice_threshold = instance->config.splice_threshold;
+	relay->buffer_limit = instance->config.relay_buffer_limit;
+	relay->message_limit = instance->config.relay_message_limit;
+	relay->on_buffered = od_frontend_remote_on_buffered;
+}
+
 static inline od_frontend_status_t od_frontend_poll_catchup(od_client_t *client,
 							    od_route_t *route,
 							    uint32_t timeout)
@@ -1603,6 +2263,9 @@ static od_frontend_status_t od_frontend_remote(od_client_t *client)
 	bool reserve_session_server_connection =
 		route->rule->reserve_session_server_connection;
 
+	od_instance_t *instance = client->global->instance;
+	od_frontend_relay_limits(instance, &client->relay);
+
 	status = od_relay_start(&client->relay, client->cond, OD_ECLIENT_READ,
 				OD_ESERVER_WRITE,
 				od_frontend_remote_client_on_read,
@@ -1614,7 +2277,6 @@ static od_frontend_status_t od_frontend_remote(od_client_t *client)
 	}
 
 	od_server_t *server = NULL;
-	od_instance_t *instance = client->global->instance;
 
 	for (;;) {
 		for (;;) {
@@ -1696,6 +2358,14 @@ static od_frontend_status_t od_frontend_remote(od_client_t *client)
 			if (status != OD_OK)
 				break;
 			server = client->server;
+			od_query_stats_pipeline_reset(&client->query_pipeline);
+			od_frontend_relay_limits(instance, &server->relay);
+			server->relay.bulk_types =
+				od_frontend_remote_server_bulk_types;
+			if (od_frontend_query_track_enabled(route->rule))
+				server->relay.bulk_types =
+					od_frontend_query_stats_bulk_types;
+			server->relay.on_bulk = od_frontend_remote_server_bulk;
 			status = od_relay_start(
 				&server->relay, client->cond, OD_ESERVER_READ,
 				OD_ECLIENT_WRITE,
@@ -1729,11 +2399,13 @@ static od_frontend_status_t od_frontend_remote(od_client_t *client)
 		flush_status = od_relay_flush(&curr_server->relay);
 		od_relay_stop(&curr_server->relay);
 		if (flush_status != OD_OK) {
+			od_relay_stop(&client->relay);
 			return flush_status;
 		}
 
 		flush_status = od_relay_flush(&client->relay);
 		if (flush_status != OD_OK) {
+			od_relay_stop(&client->relay);
 			return flush_status;
 		}
 	}
@@ -1878,6 +2550,18 @@ static void od_frontend_cleanup(od_client_t *client, char *context,
 		/* close backend connection */
 		od_router_close(router, client);
 		break;
+	case OD_EMESSAGE_LIMIT:
+		/* protocol stream can not be resumed, close both
+		 * client and server connections */
+		od_error(&instance->logger, context, client, server,
+			 "message size exceeds relay_message_limit (%d bytes)",
+			 instance->config.relay_message_limit);
+		od_frontend_fatal(client, KIWI_PROGRAM_LIMIT_EXCEEDED,
+				  "message size exceeds limit of %d bytes",
+				  instance->config.relay_message_limit);
+		if (client->server)
+			od_router_close(router, client);
+		break;
 	case OD_UNDEF:
 	case OD_SKIP:
 	case OD_ATTACH:
@@ -1931,6 +2615,10 @@ void od_frontend(void *arg)
 	od_extention_t *extentions = client->global->extentions;
 	od_module_t *modules = extentions->modules;
 
+	/* cache peer address, so logger does not ask for it every line */
+	od_getpeer(client->io.io, client->peer_host, sizeof(client->peer_host),
+		   client->peer_port, sizeof(client->peer_port));
+
 	/* log client connection */
 	if (instance->config.log_session) {
 		od_getpeername(client->io.io, client->peer,
@@ -2014,7 +2702,9 @@ void od_frontend(void *arg)
 
 	/* route client */
 	od_router_status_t router_status;
+	uint64_t route_start = machine_time_us();
 	router_status = od_router_route(router, client);
+	client->lifecycle[OD_LIFECYCLE_ROUTE] = machine_time_us() - route_start;
 
 	/* routing is over */
 	od_atomic_u32_dec(&router->clients_routing);
@@ -2123,7 +2813,9 @@ void od_frontend(void *arg)
 	}
 
 	/* client authentication */
+	uint64_t auth_start = machine_time_us();
 	rc = od_auth_frontend(client);
+	client->lifecycle[OD_LIFECYCLE_AUTH] = machine_time_us() - auth_start;
 
 	if (rc != OK_RESPONSE) {
 		/* rc == -1
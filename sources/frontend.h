@@ -79,6 +79,8 @@ od_frontend_infof(od_client_t *client, machine_msg_t *stream, char *fmt, ...)
 int od_frontend_info(od_client_t *, char *, ...);
 int od_frontend_error(od_client_t *, char *, char *, ...);
 int od_frontend_fatal(od_client_t *, char *, char *, ...);
+int od_frontend_startup_tls(od_client_t *);
+void od_frontend_prefetch_params(void *);
 void od_frontend(void *);
 
 #endif /* ODYSSEY_FRONTEND_H */
@@ -15,7 +15,9 @@ struct od_global {
 	void *router;
 	void *cron;
 	void *worker_pool;
+	void *handshake_pool;
 	void *extentions;
+	machine_taskmgr_t *auth_executor;
 };
 
 static inline void od_global_init(od_global_t *global, void *instance,
@@ -27,7 +29,9 @@ static inline void od_global_init(od_global_t *global, void *instance,
 	global->router = router;
 	global->cron = cron;
 	global->worker_pool = worker_pool;
+	global->handshake_pool = NULL;
 	global->extentions = extentions;
+	global->auth_executor = NULL;
 }
 
 #endif /* ODYSSEY_GLOBAL_H */
@@ -0,0 +1,139 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+
+static inline void od_handshake_drop(od_client_t *client)
+{
+	od_router_t *router = client->global->router;
+	od_io_close(&client->io);
+	machine_close(client->notify_io);
+	od_client_free(client);
+	od_atomic_u32_dec(&router->clients_routing);
+}
+
+static inline void od_handshake(void *arg)
+{
+	od_client_t *client = arg;
+	od_instance_t *instance = client->global->instance;
+	od_handshake_pool_t *pool = client->global->handshake_pool;
+	od_worker_pool_t *worker_pool = client->global->worker_pool;
+
+	int rc;
+	rc = od_io_attach(&client->io);
+	if (rc == -1) {
+		od_error(&instance->logger, "handshake", client, NULL,
+			 "failed to transfer client io");
+		od_handshake_drop(client);
+		return;
+	}
+
+	rc = od_frontend_startup_tls(client);
+	client->tls_offloaded = 1;
+
+	/* the worker attaches it again */
+	if (od_io_detach(&client->io) == -1) {
+		od_error(&instance->logger, "handshake", client, NULL,
+			 "failed to detach client io");
+		rc = -1;
+	}
+	if (rc == -1) {
+		od_handshake_drop(client);
+		return;
+	}
+
+	machine_msg_t *msg;
+	msg = machine_msg_create(sizeof(od_client_t *));
+	if (msg == NULL) {
+		od_handshake_drop(client);
+		return;
+	}
+	machine_msg_set_type(msg, OD_MSG_CLIENT_NEW);
+	memcpy(machine_msg_data(msg), &client, sizeof(od_client_t *));
+
+	uint32_t next = od_atomic_u32_inc(&pool->worker_next);
+	od_worker_t *worker;
+	worker = &worker_pool->pool[next % worker_pool->count];
+	machine_channel_write(worker->task_channel, msg);
+}
+
+static inline void od_handshaker(void *arg)
+{
+	od_handshaker_t *handshaker = arg;
+	od_instance_t *instance = handshaker->global->instance;
+
+	for (;;) {
+		machine_msg_t *msg;
+		msg = machine_channel_read(handshaker->task_channel,
+					   UINT32_MAX);
+		if (msg == NULL)
+			break;
+
+		od_client_t *client;
+		client = *(od_client_t **)machine_msg_data(msg);
+		machine_msg_free(msg);
+		client->global = handshaker->global;
+
+		int64_t coroutine_id;
+		coroutine_id = machine_coroutine_create(od_handshake, client);
+		if (coroutine_id == -1) {
+			od_error(&instance->logger, "handshake", client, NULL,
+				 "failed to create coroutine");
+			od_handshake_drop(client);
+		}
+	}
+
+	od_log(&instance->logger, "handshake", NULL, NULL, "stopped");
+	od_logger_release(&instance->logger);
+}
+
+int od_handshake_pool_start(od_handshake_pool_t *pool, od_global_t *global,
+			    int count)
+{
+	od_instance_t *instance = global->instance;
+	if (count == 0)
+		return 0;
+
+	pool->pool = malloc(sizeof(od_handshaker_t) * count);
+	if (pool->pool == NULL)
+		return -1;
+	int i;
+	for (i = 0; i < count; i++) {
+		od_handshaker_t *handshaker = &pool->pool[i];
+		handshaker->id = i;
+		handshaker->global = global;
+		handshaker->task_channel = machine_channel_create();
+		if (handshaker->task_channel == NULL) {
+			od_error(&instance->logger, "handshake", NULL, NULL,
+				 "failed to create task channel");
+			return -1;
+		}
+
+		char name[32];
+		od_snprintf(name, sizeof(name), "handshake: %d", i);
+		handshaker->machine = machine_create(name, od_handshaker,
+						     handshaker);
+		if (handshaker->machine == -1) {
+			machine_channel_free(handshaker->task_channel);
+			od_error(&instance->logger, "handshake", NULL, NULL,
+				 "failed to start handshake machine");
+			return -1;
+		}
+		pool->count++;
+	}
+	return 0;
+}
+
+void od_handshake_pool_stop(od_handshake_pool_t *pool)
+{
+	for (int i = 0; i < pool->count; i++) {
+		od_handshaker_t *handshaker = &pool->pool[i];
+		machine_stop(handshaker->machine);
+	}
+}
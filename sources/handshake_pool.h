@@ -0,0 +1,65 @@
+#ifndef ODYSSEY_HANDSHAKE_POOL_H
+#define ODYSSEY_HANDSHAKE_POOL_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Handshake machines read the startup packet and run the TLS handshake
+ * of new clients, then detach the client io and pass the client to a
+ * worker. Handshake CPU then does not delay relaying on workers.
+ */
+
+typedef struct od_handshaker od_handshaker_t;
+typedef struct od_handshake_pool od_handshake_pool_t;
+
+struct od_handshaker {
+	int64_t machine;
+	int id;
+	machine_channel_t *task_channel;
+	od_global_t *global;
+};
+
+struct od_handshake_pool {
+	od_handshaker_t *pool;
+	int round_robin;
+	int count;
+	/* next worker to receive a client, shared by handshake machines */
+	od_atomic_u32_t worker_next;
+};
+
+static inline void od_handshake_pool_init(od_handshake_pool_t *pool)
+{
+	pool->pool = NULL;
+	pool->round_robin = 0;
+	pool->count = 0;
+	pool->worker_next = 0;
+}
+
+int od_handshake_pool_start(od_handshake_pool_t *, od_global_t *, int);
+void od_handshake_pool_stop(od_handshake_pool_t *);
+
+static inline int od_handshake_pool_active(od_handshake_pool_t *pool)
+{
+	return pool->count > 0;
+}
+
+static inline void od_handshake_pool_feed(od_handshake_pool_t *pool,
+					  machine_msg_t *msg)
+{
+	int next = pool->round_robin;
+	if (pool->round_robin >= pool->count) {
+		pool->round_robin = 0;
+		next = 0;
+	}
+	pool->round_robin++;
+
+	od_handshaker_t *handshaker;
+	handshaker = &pool->pool[next];
+	machine_channel_write(handshaker->task_channel, msg);
+}
+
+#endif /* ODYSSEY_HANDSHAKE_POOL_H */
@@ -0,0 +1,107 @@
+#ifndef ODYSSEY_HGRAM_H
+#define ODYSSEY_HGRAM_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Log-scale histogram of durations in microseconds: two buckets per
+ * power of two, so quantiles are reported within 25% error. It is
+ * small, lock free and mergeable by simple addition.
+ */
+
+#define OD_HGRAM_BUCKETS 64
+
+typedef struct od_hgram od_hgram_t;
+
+struct od_hgram {
+	od_atomic_u64_t count;
+	od_atomic_u64_t sum;
+	od_atomic_u64_t max;
+	od_atomic_u64_t buckets[OD_HGRAM_BUCKETS];
+};
+
+static inline int od_hgram_bucket(uint64_t value)
+{
+	if (value < 2)
+		return 0;
+	int log = 63 - __builtin_clzll(value);
+	/* second half of the power of two */
+	int half = (value >> (log - 1)) & 1;
+	int bucket = log * 2 + half;
+	if (bucket >= OD_HGRAM_BUCKETS)
+		bucket = OD_HGRAM_BUCKETS - 1;
+	return bucket;
+}
+
+/* upper bound of values which fall into the bucket */
+static inline uint64_t od_hgram_bucket_max(int bucket)
+{
+	if (bucket < 2)
+		return 2;
+	int log = bucket / 2;
+	if (bucket % 2 == 0)
+		return 3ULL << (log - 1);
+	return 1ULL << (log + 1);
+}
+
+/* bucket which holds the value of rank q in counts */
+static inline uint64_t od_hgram_quantile_of(uint64_t count, uint64_t *buckets,
+					    double q)
+{
+	if (count == 0)
+		return 0;
+	uint64_t rank = (uint64_t)(q * count);
+	if (rank >= count)
+		rank = count - 1;
+	uint64_t seen = 0;
+	int i;
+	for (i = 0; i < OD_HGRAM_BUCKETS - 1; i++) {
+		seen += buckets[i];
+		if (seen > rank)
+			break;
+	}
+	return od_hgram_bucket_max(i);
+}
+
+static inline void od_hgram_init(od_hgram_t *hgram)
+{
+	memset(hgram, 0, sizeof(*hgram));
+}
+
+static inline void od_hgram_add(od_hgram_t *hgram, uint64_t value)
+{
+	od_atomic_u64_inc(&hgram->buckets[od_hgram_bucket(value)]);
+	od_atomic_u64_inc(&hgram->count);
+	od_atomic_u64_add(&hgram->sum, value);
+	uint64_t max = hgram->max;
+	while (value > max) {
+		if (__sync_bool_compare_and_swap(&hgram->max, max, value))
+			break;
+		max = hgram->max;
+	}
+}
+
+/* consistent enough copy of counters for reporting */
+static inline uint64_t od_hgram_read(od_hgram_t *hgram, uint64_t *buckets)
+{
+	uint64_t count = 0;
+	int i;
+	for (i = 0; i < OD_HGRAM_BUCKETS; i++) {
+		buckets[i] = od_atomic_u64_of(&hgram->buckets[i]);
+		count += buckets[i];
+	}
+	return count;
+}
+
+static inline uint64_t od_hgram_quantile(od_hgram_t *hgram, double q)
+{
+	uint64_t buckets[OD_HGRAM_BUCKETS];
+	uint64_t count = od_hgram_read(hgram, buckets);
+	return od_hgram_quantile_of(count, buckets, q);
+}
+
+#endif /* ODYSSEY_HGRAM_H */
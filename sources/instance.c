@@ -93,6 +93,7 @@ int od_instance_main(od_instance_t *instance, int argc, char **argv)
 	od_router_t router;
 	od_cron_t cron;
 	od_worker_pool_t worker_pool;
+	od_handshake_pool_t handshake_pool;
 	od_extention_t extentions;
 	od_global_t global;
 
@@ -103,6 +104,8 @@ int od_instance_main(od_instance_t *instance, int argc, char **argv)
 	od_extentions_init(&extentions);
 	od_global_init(&global, instance, &system, &router, &cron, &worker_pool,
 		       &extentions);
+	od_handshake_pool_init(&handshake_pool);
+	global.handshake_pool = &handshake_pool;
 
 	/* read config file */
 	od_error_t error;
@@ -136,10 +139,30 @@ int od_instance_main(od_instance_t *instance, int argc, char **argv)
 		goto error;
 	}
 
+	/* slow query ring */
+	rc = od_slow_query_ring_set_size(&router.slow_queries,
+					 instance->config.slow_query_ring_size);
+	if (rc == -1) {
+		goto error;
+	}
+
+	/* query statistics */
+	rc = od_query_stats_set_size(&router.query_stats,
+				     instance->config.query_stats_max);
+	if (rc == -1) {
+		goto error;
+	}
+
 	/* configure logger */
-	od_logger_set_format(&instance->logger, instance->config.log_format);
+	if (instance->config.log_format)
+		od_logger_set_format(&instance->logger,
+				     instance->config.log_format);
+	od_logger_set_output(&instance->logger,
+			     instance->config.log_output_type);
 	od_logger_set_debug(&instance->logger, instance->config.log_debug);
 	od_logger_set_stdout(&instance->logger, instance->config.log_to_stdout);
+	od_logger_set_queue(&instance->logger, instance->config.log_queue_size,
+			    instance->config.log_queue_overflow_policy);
 
 	/* run as daemon */
 	if (instance->config.daemonize) {
@@ -200,6 +223,7 @@ int od_instance_main(od_instance_t *instance, int argc, char **argv)
 	machinarium_set_pool_size(instance->config.resolvers);
 	machinarium_set_coroutine_cache_size(instance->config.cache_coroutine);
 	machinarium_set_msg_cache_gc_size(instance->config.cache_msg_gc_size);
+	machinarium_set_tls_ticket_lifetime(instance->config.tls_ticket_lifetime);
 	rc = machinarium_init();
 	if (rc == -1) {
 		od_error(&instance->logger, "init", NULL, NULL,
@@ -207,6 +231,12 @@ int od_instance_main(od_instance_t *instance, int argc, char **argv)
 		goto error;
 	}
 
+	/* start auth executor threads */
+	rc = od_auth_executor_start(&global, instance->config.auth_workers);
+	if (rc == -1) {
+		goto error;
+	}
+
 	/* create pid file */
 	if (instance->config.pid_file) {
 		rc = od_pid_create(&instance->pid, instance->config.pid_file);
@@ -214,7 +244,7 @@ int od_instance_main(od_instance_t *instance, int argc, char **argv)
 			od_error(&instance->logger, "init", NULL, NULL,
 				 "failed to create pid file %s: %s",
 				 instance->config.pid_file, strerror(errno));
-			goto error;
+			goto error_auth;
 		}
 	}
 
@@ -224,11 +254,15 @@ int od_instance_main(od_instance_t *instance, int argc, char **argv)
 	/* start system machine thread */
 	rc = od_system_start(&system, &global);
 	if (rc == -1) {
-		goto error;
+		goto error_auth;
 	}
 
-	return machine_wait(system.machine);
+	rc = machine_wait(system.machine);
+	od_auth_executor_stop(&global);
+	return rc;
 
+error_auth:
+	od_auth_executor_stop(&global);
 error:
 	od_router_free(&router);
 	return NOT_OK_RESPONSE;
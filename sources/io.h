@@ -112,14 +112,21 @@ static inline int od_io_read(od_io_t *io, char *dest, int size,
 		int unread;
 		unread = od_readahead_unread(&io->readahead);
 		if (unread > 0) {
-			int to_read = unread;
-			if (to_read > size)
-				to_read = size;
-			memcpy(dest + pos,
-			       od_readahead_pos_read(&io->readahead), to_read);
-			size -= to_read;
-			pos += to_read;
-			od_readahead_pos_read_advance(&io->readahead, to_read);
+			/* unread data may wrap around the ring end */
+			while (size > 0 && unread > 0) {
+				int to_read;
+				to_read = od_readahead_read_span(&io->readahead);
+				if (to_read > size)
+					to_read = size;
+				memcpy(dest + pos,
+				       od_readahead_pos_read(&io->readahead),
+				       to_read);
+				size -= to_read;
+				pos += to_read;
+				od_readahead_pos_read_advance(&io->readahead,
+							      to_read);
+				unread = od_readahead_unread(&io->readahead);
+			}
 		} else {
 			od_readahead_reuse(&io->readahead);
 		}
@@ -135,11 +142,14 @@ static inline int od_io_read(od_io_t *io, char *dest, int size,
 			if (rc == -1)
 				return -1;
 
-			int left;
-			left = od_readahead_left(&io->readahead);
+			if (od_readahead_ensure(&io->readahead) == -1)
+				return -1;
+
+			struct iovec iov[2];
+			int iovc;
+			iovc = od_readahead_iov(&io->readahead, iov);
 
-			rc = machine_read_raw(
-				io->io, od_readahead_pos(&io->readahead), left);
+			rc = machine_readv_raw(io->io, iov, iovc);
 			if (rc <= 0) {
 				/* retry using read condition wait */
 				int errno_ = machine_errno();
@@ -91,6 +91,9 @@ od_retcode_t od_ldap_endpoint_prepare(od_ldap_endpoint_t *le)
 	}
 
 	le->ldapurl = NULL;
+	if (le->ldapcachettl < 0 || le->ldapcachesize < 0) {
+		return NOT_OK_RESPONSE;
+	}
 	if (!le->ldapserver) {
 		// TODO: support mulitple ldap servers
 		return NOT_OK_RESPONSE;
@@ -237,11 +240,62 @@ static inline od_retcode_t od_ldap_server_init(od_logger_t *logger,
 	return OK_RESPONSE;
 }
 
+typedef struct {
+	LDAP *conn;
+	char *auth_user;
+	char *password;
+	int rc;
+} od_ldap_bind_task_t;
+
+static void od_ldap_bind_task_free(void *arg)
+{
+	od_ldap_bind_task_t *task = arg;
+	free(task->auth_user);
+	free(task->password);
+	free(task);
+}
+
+static void od_ldap_bind_task_abandon(void *arg)
+{
+	/* connection was handed over to the task on timeout */
+	od_ldap_bind_task_t *task = arg;
+	ldap_unbind(task->conn);
+	od_ldap_bind_task_free(task);
+}
+
+static void od_ldap_bind_task(void *arg)
+{
+	od_ldap_bind_task_t *task = arg;
+	task->rc = ldap_simple_bind_s(task->conn, task->auth_user,
+				      task->password);
+}
+
 static inline int od_ldap_server_auth(od_ldap_server_t *serv, od_client_t *cl,
 				      kiwi_password_t *tok)
 {
+	od_ldap_bind_task_t *task = malloc(sizeof(od_ldap_bind_task_t));
+	if (task == NULL)
+		return LDAP_NO_MEMORY;
+	task->conn = serv->conn;
+	task->auth_user = strdup(serv->auth_user);
+	task->password = strdup(tok->password);
+	task->rc = LDAP_OTHER;
+	if (task->auth_user == NULL || task->password == NULL) {
+		od_ldap_bind_task_free(task);
+		return LDAP_NO_MEMORY;
+	}
+
+	/* simple bind blocks, run it on the auth executor */
 	int rc;
-	rc = ldap_simple_bind_s(serv->conn, serv->auth_user, tok->password);
+	rc = od_auth_executor_run(cl, od_ldap_bind_task,
+				  od_ldap_bind_task_abandon, task);
+	if (rc == -1) {
+		serv->conn = NULL;
+		rc = LDAP_TIMEOUT;
+	} else {
+		rc = task->rc;
+		od_ldap_bind_task_free(task);
+	}
 
 	od_route_t *route = cl->route;
 	if (route->rule->client_fwd_error) {
@@ -356,6 +410,21 @@ od_retcode_t od_auth_ldap(od_client_t *cl, kiwi_password_t *tok)
 	od_route_t *route = cl->route;
 	od_instance_t *instance = cl->global->instance;
 
+	od_ldap_endpoint_t *le = route->rule->ldap_endpoint;
+	char *user = cl->startup.user.value;
+	int user_len = cl->startup.user.value_len;
+	int password_len = tok->password_len;
+	if (password_len > 0 && tok->password[password_len - 1] == 0)
+		password_len--;
+
+	if (le->ldapcachettl > 0 &&
+	    od_ldap_cache_check(&le->cache, user, user_len, tok->password,
+				password_len, machine_time_ms())) {
+		od_debug(&instance->logger, "auth_ldap", cl, NULL,
+			 "ldap bind result found in cache");
+		return OK_RESPONSE;
+	}
+
 	od_debug(&instance->logger, "auth_ldap", cl, NULL,
 		 "%d connections are currently issued to ldap",
 		 od_server_pool_active(&route->ldap_pool));
@@ -369,6 +438,28 @@ od_retcode_t od_auth_ldap(od_client_t *cl, kiwi_password_t *tok)
 
 	int ldap_rc = od_ldap_server_auth(serv, cl, tok);
 
+	if (serv->conn == NULL) {
+		/* bind timed out, connection is owned by the abandoned task */
+		od_route_lock(route);
+		od_ldap_server_pool_set(&route->ldap_pool, serv,
+					OD_SERVER_UNDEF);
+		od_route_unlock(route);
+		od_ldap_server_free(serv);
+		return NOT_OK_RESPONSE;
+	}
+
+	if (le->ldapcachettl > 0) {
+		if (ldap_rc == LDAP_SUCCESS)
+			od_ldap_cache_add(&le->cache, user, user_len,
+					  tok->password, password_len,
+					  machine_time_ms() +
+						  le->ldapcachettl * 1000ULL,
+					  le->ldapcachesize);
+		else if (ldap_rc == LDAP_INVALID_CREDENTIALS)
+			od_ldap_cache_reject(&le->cache, user, user_len,
+					     tok->password, password_len);
+	}
+
 	switch (ldap_rc) {
 	case LDAP_SUCCESS: {
 #ifndef USE_POOL
@@ -444,6 +535,10 @@ od_ldap_endpoint_t *od_ldap_endpoint_alloc()
 	// preparsed connect url
 	le->ldapurl = NULL;
 
+	le->ldapcachettl = 0;
+	le->ldapcachesize = 1024;
+	od_ldap_cache_init(&le->cache);
+
 	return le;
 }
 
@@ -485,6 +580,7 @@ od_retcode_t od_ldap_endpoint_free(od_ldap_endpoint_t *le)
 	if (le->ldapurl) {
 		free(le->ldapurl);
 	}
+	od_ldap_cache_free(&le->cache);
 
 	od_list_unlink(&le->link);
 
@@ -0,0 +1,219 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+
+#include <openssl/crypto.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+void od_ldap_cache_init(od_ldap_cache_t *cache)
+{
+	pthread_mutex_init(&cache->lock, NULL);
+	cache->buckets = NULL;
+	od_list_init(&cache->order);
+	cache->count = 0;
+	cache->hits = 0;
+	cache->misses = 0;
+}
+
+static inline void od_ldap_cache_remove(od_ldap_cache_t *cache,
+					od_ldap_cache_entry_t *entry)
+{
+	od_list_unlink(&entry->link);
+	od_list_unlink(&entry->link_order);
+	memset(entry->hash, 0, sizeof(entry->hash));
+	free(entry);
+	cache->count--;
+}
+
+void od_ldap_cache_free(od_ldap_cache_t *cache)
+{
+	od_list_t *i, *n;
+	od_list_foreach_safe(&cache->order, i, n)
+	{
+		od_ldap_cache_entry_t *entry;
+		entry = od_container_of(i, od_ldap_cache_entry_t, link_order);
+		od_ldap_cache_remove(cache, entry);
+	}
+	free(cache->buckets);
+	cache->buckets = NULL;
+	pthread_mutex_destroy(&cache->lock);
+}
+
+static inline od_list_t *od_ldap_cache_bucket(od_ldap_cache_t *cache,
+					      char *user, int user_len)
+{
+	od_hash_t hash = od_murmur_hash(user, user_len);
+	return &cache->buckets[hash % OD_LDAP_CACHE_BUCKETS];
+}
+
+static inline od_ldap_cache_entry_t *
+od_ldap_cache_find(od_ldap_cache_t *cache, char *user, int user_len)
+{
+	if (cache->buckets == NULL)
+		return NULL;
+	od_list_t *bucket = od_ldap_cache_bucket(cache, user, user_len);
+	od_list_t *i;
+	od_list_foreach(bucket, i)
+	{
+		od_ldap_cache_entry_t *entry;
+		entry = od_container_of(i, od_ldap_cache_entry_t, link);
+		if (entry->user_len == user_len &&
+		    memcmp(entry->user, user, user_len) == 0)
+			return entry;
+	}
+	return NULL;
+}
+
+static inline void od_ldap_cache_hash(uint8_t *salt, char *password,
+				      int password_len, uint8_t *hash)
+{
+	/* salt is used as the HMAC key */
+	HMAC(EVP_sha256(), salt, OD_LDAP_CACHE_SALT_LEN, (uint8_t *)password,
+	     password_len, hash, NULL);
+}
+
+/* returns 1 if password of the user was verified recently */
+int od_ldap_cache_check(od_ldap_cache_t *cache, char *user, int user_len,
+			char *password, int password_len, uint64_t now_ms)
+{
+	pthread_mutex_lock(&cache->lock);
+	od_ldap_cache_entry_t *entry;
+	entry = od_ldap_cache_find(cache, user, user_len);
+	if (entry && entry->expire_ms <= now_ms) {
+		od_ldap_cache_remove(cache, entry);
+		entry = NULL;
+	}
+	int hit = 0;
+	if (entry) {
+		uint8_t hash[OD_LDAP_CACHE_HASH_LEN];
+		od_ldap_cache_hash(entry->salt, password, password_len, hash);
+		hit = CRYPTO_memcmp(hash, entry->hash, sizeof(hash)) == 0;
+	}
+	if (hit)
+		cache->hits++;
+	else
+		cache->misses++;
+	pthread_mutex_unlock(&cache->lock);
+	return hit;
+}
+
+/* remember successful bind, replacing the oldest entry when full */
+void od_ldap_cache_add(od_ldap_cache_t *cache, char *user, int user_len,
+		       char *password, int password_len, uint64_t expire_ms,
+		       int max)
+{
+	if (max <= 0)
+		return;
+
+	pthread_mutex_lock(&cache->lock);
+	if (cache->buckets == NULL) {
+		cache->buckets =
+			malloc(sizeof(od_list_t) * OD_LDAP_CACHE_BUCKETS);
+		if (cache->buckets == NULL) {
+			pthread_mutex_unlock(&cache->lock);
+			return;
+		}
+		int i;
+		for (i = 0; i < OD_LDAP_CACHE_BUCKETS; i++)
+			od_list_init(&cache->buckets[i]);
+	}
+
+	od_ldap_cache_entry_t *entry;
+	entry = od_ldap_cache_find(cache, user, user_len);
+	if (entry)
+		od_ldap_cache_remove(cache, entry);
+
+	while (cache->count >= max) {
+		entry = od_container_of(cache->order.next,
+					od_ldap_cache_entry_t, link_order);
+		od_ldap_cache_remove(cache, entry);
+	}
+
+	entry = malloc(sizeof(od_ldap_cache_entry_t) + user_len);
+	if (entry == NULL) {
+		pthread_mutex_unlock(&cache->lock);
+		return;
+	}
+	if (RAND_bytes(entry->salt, sizeof(entry->salt)) != 1) {
+		free(entry);
+		pthread_mutex_unlock(&cache->lock);
+		return;
+	}
+	od_ldap_cache_hash(entry->salt, password, password_len, entry->hash);
+	entry->expire_ms = expire_ms;
+	entry->user_len = user_len;
+	memcpy(entry->user, user, user_len);
+	od_list_init(&entry->link);
+	od_list_init(&entry->link_order);
+	od_list_append(od_ldap_cache_bucket(cache, user, user_len),
+		       &entry->link);
+	od_list_append(&cache->order, &entry->link_order);
+	cache->count++;
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/* drop entry of the user if it holds the password rejected by
+ * LDAP, a wrong password does not evict a verified one */
+int od_ldap_cache_reject(od_ldap_cache_t *cache, char *user, int user_len,
+			 char *password, int password_len)
+{
+	int removed = 0;
+	pthread_mutex_lock(&cache->lock);
+	od_ldap_cache_entry_t *entry;
+	entry = od_ldap_cache_find(cache, user, user_len);
+	if (entry) {
+		uint8_t hash[OD_LDAP_CACHE_HASH_LEN];
+		od_ldap_cache_hash(entry->salt, password, password_len, hash);
+		if (CRYPTO_memcmp(hash, entry->hash, sizeof(hash)) == 0) {
+			od_ldap_cache_remove(cache, entry);
+			removed++;
+		}
+	}
+	pthread_mutex_unlock(&cache->lock);
+	return removed;
+}
+
+/* drop entry of the user or all entries, if user is NULL */
+int od_ldap_cache_invalidate(od_ldap_cache_t *cache, char *user, int user_len)
+{
+	int removed = 0;
+	pthread_mutex_lock(&cache->lock);
+	if (user) {
+		od_ldap_cache_entry_t *entry;
+		entry = od_ldap_cache_find(cache, user, user_len);
+		if (entry) {
+			od_ldap_cache_remove(cache, entry);
+			removed++;
+		}
+	} else {
+		od_list_t *i, *n;
+		od_list_foreach_safe(&cache->order, i, n)
+		{
+			od_ldap_cache_entry_t *entry;
+			entry = od_container_of(i, od_ldap_cache_entry_t,
+						link_order);
+			od_ldap_cache_remove(cache, entry);
+			removed++;
+		}
+	}
+	pthread_mutex_unlock(&cache->lock);
+	return removed;
+}
+
+void od_ldap_cache_stat(od_ldap_cache_t *cache, int *count, uint64_t *hits,
+			uint64_t *misses)
+{
+	pthread_mutex_lock(&cache->lock);
+	*count = cache->count;
+	*hits = cache->hits;
+	*misses = cache->misses;
+	pthread_mutex_unlock(&cache->lock);
+}
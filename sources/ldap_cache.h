@@ -0,0 +1,56 @@
+#ifndef ODYSSEY_LDAP_CACHE_H
+#define ODYSSEY_LDAP_CACHE_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Cache of successful LDAP binds of an ldap_endpoint.
+ *
+ * For every user only a salted HMAC-SHA-256 of the last verified
+ * password is kept, never the password itself. Entries live for
+ * ldapcachettl seconds; when ldapcachesize entries are cached, the
+ * oldest one is replaced.
+ */
+
+#define OD_LDAP_CACHE_BUCKETS 256
+#define OD_LDAP_CACHE_SALT_LEN 16
+#define OD_LDAP_CACHE_HASH_LEN 32
+
+typedef struct od_ldap_cache_entry od_ldap_cache_entry_t;
+typedef struct od_ldap_cache od_ldap_cache_t;
+
+struct od_ldap_cache_entry {
+	uint64_t expire_ms;
+	uint8_t salt[OD_LDAP_CACHE_SALT_LEN];
+	uint8_t hash[OD_LDAP_CACHE_HASH_LEN];
+	od_list_t link;
+	od_list_t link_order;
+	int user_len;
+	char user[];
+};
+
+struct od_ldap_cache {
+	pthread_mutex_t lock;
+	od_list_t *buckets;
+	od_list_t order;
+	int count;
+	uint64_t hits;
+	uint64_t misses;
+};
+
+extern void od_ldap_cache_init(od_ldap_cache_t *);
+extern void od_ldap_cache_free(od_ldap_cache_t *);
+extern int od_ldap_cache_check(od_ldap_cache_t *, char *, int, char *, int,
+			       uint64_t);
+extern void od_ldap_cache_add(od_ldap_cache_t *, char *, int, char *, int,
+			      uint64_t, int);
+extern int od_ldap_cache_reject(od_ldap_cache_t *, char *, int, char *, int);
+extern int od_ldap_cache_invalidate(od_ldap_cache_t *, char *, int);
+extern void od_ldap_cache_stat(od_ldap_cache_t *, int *, uint64_t *,
+			       uint64_t *);
+
+#endif /* ODYSSEY_LDAP_CACHE_H */
@@ -23,6 +23,11 @@ typedef struct {
 	// preparsed connect url
 	char *ldapurl;
 
+	// successful binds cache, disabled when ttl is zero
+	int ldapcachettl;
+	int ldapcachesize;
+	od_ldap_cache_t cache;
+
 	od_list_t link;
 } od_ldap_endpoint_t;
 
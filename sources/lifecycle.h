@@ -0,0 +1,69 @@
+#ifndef ODYSSEY_LIFECYCLE_H
+#define ODYSSEY_LIFECYCLE_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Connection lifecycle phases. Each client keeps durations of its
+ * login phases, each route keeps histograms of all phases of its
+ * clients and servers.
+ */
+
+typedef enum {
+	OD_LIFECYCLE_TLS,
+	OD_LIFECYCLE_ROUTE,
+	OD_LIFECYCLE_AUTH,
+	OD_LIFECYCLE_QUEUE,
+	OD_LIFECYCLE_CONNECT,
+	OD_LIFECYCLE_DEPLOY,
+	OD_LIFECYCLE_LOGIN,
+	OD_LIFECYCLE_MAX
+} od_lifecycle_phase_t;
+
+typedef struct od_lifecycle od_lifecycle_t;
+
+struct od_lifecycle {
+	od_hgram_t phases[OD_LIFECYCLE_MAX];
+};
+
+static inline char *od_lifecycle_phase_to_str(od_lifecycle_phase_t phase)
+{
+	switch (phase) {
+	case OD_LIFECYCLE_TLS:
+		return "tls";
+	case OD_LIFECYCLE_ROUTE:
+		return "route";
+	case OD_LIFECYCLE_AUTH:
+		return "auth";
+	case OD_LIFECYCLE_QUEUE:
+		return "queue";
+	case OD_LIFECYCLE_CONNECT:
+		return "connect";
+	case OD_LIFECYCLE_DEPLOY:
+		return "deploy";
+	case OD_LIFECYCLE_LOGIN:
+		return "login";
+	case OD_LIFECYCLE_MAX:
+		break;
+	}
+	return "unknown";
+}
+
+static inline void od_lifecycle_init(od_lifecycle_t *lifecycle)
+{
+	int i;
+	for (i = 0; i < OD_LIFECYCLE_MAX; i++)
+		od_hgram_init(&lifecycle->phases[i]);
+}
+
+static inline void od_lifecycle_add(od_lifecycle_t *lifecycle,
+				    od_lifecycle_phase_t phase, uint64_t time_us)
+{
+	od_hgram_add(&lifecycle->phases[phase], time_us);
+}
+
+#endif /* ODYSSEY_LIFECYCLE_H */
@@ -33,6 +33,8 @@ static int od_log_syslog_level[] = { LOG_INFO, LOG_ERR, LOG_DEBUG, LOG_CRIT };
 
 static char *od_log_level[] = { "info", "error", "debug", "fatal" };
 
+static int od_log_level_len[] = { 4, 5, 5, 5 };
+
 od_retcode_t od_logger_init(od_logger_t *logger, od_pid_t *pid)
 {
 	logger->pid = pid;
@@ -41,8 +43,20 @@ od_retcode_t od_logger_init(od_logger_t *logger, od_pid_t *pid)
 	logger->log_syslog = 0;
 	logger->format = NULL;
 	logger->format_len = 0;
+	logger->format_ops = NULL;
+	logger->format_ops_count = 0;
+	logger->format_text = NULL;
+	logger->output = OD_LOGGER_TEXT;
 	logger->fd = -1;
 	logger->loaded = 0;
+	logger->queue_size = 0;
+	logger->queue_overflow = OD_LOGGER_SPILL;
+	logger->queues = NULL;
+	pthread_mutex_init(&logger->drain_lock, NULL);
+	logger->released_written = 0;
+	logger->released_dropped = 0;
+	logger->released_spilled = 0;
+	logger->released_blocked = 0;
 
 	/* set temporary format */
 	od_logger_set_format(logger, "%p %t %l (%c) %h %m\n");
@@ -124,6 +138,8 @@ int od_logger_open_syslog(od_logger_t *logger, char *ident, char *facility)
 
 void od_logger_close(od_logger_t *logger)
 {
+	if (logger->loaded)
+		od_logger_flush(logger);
 	if (logger->fd != -1)
 		close(logger->fd);
 	logger->fd = -1;
@@ -166,234 +182,569 @@ __attribute__((hot)) static inline int od_logger_escape(char *dest, int size,
 	return dst_pos - dest;
 }
 
-__attribute__((hot)) static inline int
-od_logger_format(od_logger_t *logger, od_logger_level_t level, char *context,
-		 od_client_t *client, od_server_t *server, char *fmt,
-		 va_list args, char *output, int output_len)
+static od_logger_op_type_t od_logger_op_of(char symbol)
 {
-	char *dst_pos = output;
-	char *dst_end = output + output_len;
-	char *format_pos = logger->format;
-	char *format_end = logger->format + logger->format_len;
-	char peer[128];
+	switch (symbol) {
+	case 'n':
+		return OD_LOGGER_OP_UNIXTIME;
+	case 't':
+		return OD_LOGGER_OP_TIMESTAMP;
+	case 'e':
+		return OD_LOGGER_OP_MILLIS;
+	case 'p':
+		return OD_LOGGER_OP_PID;
+	case 'i':
+		return OD_LOGGER_OP_CLIENT_ID;
+	case 's':
+		return OD_LOGGER_OP_SERVER_ID;
+	case 'u':
+		return OD_LOGGER_OP_USER;
+	case 'd':
+		return OD_LOGGER_OP_DATABASE;
+	case 'c':
+		return OD_LOGGER_OP_CONTEXT;
+	case 'l':
+		return OD_LOGGER_OP_LEVEL;
+	case 'm':
+		return OD_LOGGER_OP_MESSAGE;
+	case 'M':
+		return OD_LOGGER_OP_MESSAGE_ESCAPED;
+	case 'h':
+		return OD_LOGGER_OP_CLIENT_HOST;
+	case 'r':
+		return OD_LOGGER_OP_CLIENT_PORT;
+	}
+	return OD_LOGGER_OP_TEXT;
+}
 
-	int len;
+int od_logger_set_format(od_logger_t *logger, char *format)
+{
+	int format_len = strlen(format);
+
+	/* every format symbol produces at most one operation and
+	 * literal text is never longer than the format */
+	od_logger_op_t *ops;
+	ops = malloc(sizeof(od_logger_op_t) * (format_len + 1));
+	char *text = malloc(format_len + 1);
+	if (ops == NULL || text == NULL) {
+		free(ops);
+		free(text);
+		return -1;
+	}
+
+	od_logger_op_t *op = NULL;
+	char *text_pos = text;
+	char *format_pos = format;
+	char *format_end = format + format_len;
+	int count = 0;
 	while (format_pos < format_end) {
+		char literal[2];
+		int literal_len = 0;
 		if (*format_pos == '\\') {
 			format_pos++;
-			if (od_unlikely(format_pos == format_end))
-				break;
-			if (od_unlikely((dst_end - dst_pos) < 1))
+			if (format_pos == format_end)
 				break;
 			switch (*format_pos) {
 			case '\\':
-				dst_pos[0] = '\\';
-				dst_pos += 1;
+				literal[literal_len++] = '\\';
 				break;
 			case 'n':
-				dst_pos[0] = '\n';
-				dst_pos += 1;
+				literal[literal_len++] = '\n';
 				break;
 			case 't':
-				dst_pos[0] = '\t';
-				dst_pos += 1;
+				literal[literal_len++] = '\t';
 				break;
 			case 'r':
-				dst_pos[0] = '\r';
-				dst_pos += 1;
+				literal[literal_len++] = '\r';
 				break;
 			default:
-				if (od_unlikely((dst_end - dst_pos) < 2))
-					break;
-				dst_pos[0] = '\\';
-				dst_pos[1] = *format_pos;
-				dst_pos += 2;
+				literal[literal_len++] = '\\';
+				literal[literal_len++] = *format_pos;
 				break;
 			}
 		} else if (*format_pos == '%') {
 			format_pos++;
-			if (od_unlikely(format_pos == format_end))
-				break;
-			switch (*format_pos) {
-			/* unixtime */
-			case 'n': {
-				time_t tm = time(NULL);
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "%lu", tm);
-				dst_pos += len;
+			if (format_pos == format_end)
 				break;
+			od_logger_op_type_t type = od_logger_op_of(*format_pos);
+			if (type != OD_LOGGER_OP_TEXT) {
+				op = &ops[count++];
+				op->type = type;
+				op->text = NULL;
+				op->text_len = 0;
+				format_pos++;
+				/* next literal starts a new operation */
+				op = NULL;
+				continue;
 			}
-			/* timestamp */
-			case 't': {
-				struct timeval tv;
-				gettimeofday(&tv, NULL);
-				len = strftime(dst_pos, dst_end - dst_pos,
-					       "%FT%TZ", gmtime(&tv.tv_sec));
-				dst_pos += len;
+			if (*format_pos != '%')
+				literal[literal_len++] = '%';
+			literal[literal_len++] = *format_pos;
+		} else {
+			literal[literal_len++] = *format_pos;
+		}
+		format_pos++;
+
+		/* merge adjacent literals */
+		if (op == NULL) {
+			op = &ops[count++];
+			op->type = OD_LOGGER_OP_TEXT;
+			op->text = text_pos;
+			op->text_len = 0;
+		}
+		memcpy(text_pos, literal, literal_len);
+		text_pos += literal_len;
+		op->text_len += literal_len;
+	}
+
+	/* format is set on startup, before other threads are started */
+	free(logger->format_ops);
+	free(logger->format_text);
+	logger->format = format;
+	logger->format_len = format_len;
+	logger->format_ops = ops;
+	logger->format_ops_count = count;
+	logger->format_text = text;
+	return 0;
+}
+
+/* formatted time of the current second, cached per thread */
+typedef struct {
+	time_t sec;
+	int timestamp_len;
+	char timestamp[32];
+	int unixtime_len;
+	char unixtime[24];
+} od_logger_time_t;
 
+static __thread od_logger_time_t od_logger_time;
+
+static inline od_logger_time_t *od_logger_time_of(struct timespec *now)
+{
+	od_logger_time_t *cache = &od_logger_time;
+	if (od_likely(cache->sec == now->tv_sec && cache->timestamp_len))
+		return cache;
+	struct tm tm;
+	gmtime_r(&now->tv_sec, &tm);
+	cache->sec = now->tv_sec;
+	cache->timestamp_len = strftime(cache->timestamp,
+					sizeof(cache->timestamp), "%FT%TZ", &tm);
+	cache->unixtime_len = od_snprintf(cache->unixtime,
+					  sizeof(cache->unixtime), "%lu",
+					  (unsigned long)now->tv_sec);
+	return cache;
+}
+
+static inline int od_logger_copy(char *dst, char *dst_end, char *src,
+				 int src_len)
+{
+	if (od_unlikely(src_len > dst_end - dst))
+		src_len = dst_end - dst;
+	memcpy(dst, src, src_len);
+	return src_len;
+}
+
+__attribute__((hot)) static inline int
+od_logger_format(od_logger_t *logger, od_logger_level_t level, char *context,
+		 od_client_t *client, od_server_t *server, char *fmt,
+		 va_list args, char *output, int output_len)
+{
+	char *dst_pos = output;
+	char *dst_end = output + output_len;
+
+	/* wall clock is read at most once per line */
+	struct timespec now;
+	now.tv_sec = 0;
+	now.tv_nsec = 0;
+
+	int len;
+	int i;
+	for (i = 0; i < logger->format_ops_count; i++) {
+		od_logger_op_t *op = &logger->format_ops[i];
+		switch (op->type) {
+		case OD_LOGGER_OP_TEXT:
+			dst_pos += od_logger_copy(dst_pos, dst_end, op->text,
+						  op->text_len);
+			break;
+		/* unixtime */
+		case OD_LOGGER_OP_UNIXTIME: {
+			if (now.tv_sec == 0)
+				clock_gettime(CLOCK_REALTIME, &now);
+			od_logger_time_t *cache = od_logger_time_of(&now);
+			dst_pos += od_logger_copy(dst_pos, dst_end,
+						  cache->unixtime,
+						  cache->unixtime_len);
+			break;
+		}
+		/* timestamp */
+		case OD_LOGGER_OP_TIMESTAMP: {
+			if (now.tv_sec == 0)
+				clock_gettime(CLOCK_REALTIME, &now);
+			od_logger_time_t *cache = od_logger_time_of(&now);
+			dst_pos += od_logger_copy(dst_pos, dst_end,
+						  cache->timestamp,
+						  cache->timestamp_len);
+			break;
+		}
+		/* millis */
+		case OD_LOGGER_OP_MILLIS: {
+			if (now.tv_sec == 0)
+				clock_gettime(CLOCK_REALTIME, &now);
+			if (od_unlikely((dst_end - dst_pos) < 3))
 				break;
-			}
-			/* millis */
-			case 'e': {
-				struct timeval tv;
-				gettimeofday(&tv, NULL);
+			int millis = now.tv_nsec / 1000000;
+			dst_pos[0] = '0' + millis / 100;
+			dst_pos[1] = '0' + millis / 10 % 10;
+			dst_pos[2] = '0' + millis % 10;
+			dst_pos += 3;
+			break;
+		}
+		/* pid */
+		case OD_LOGGER_OP_PID:
+			dst_pos += od_logger_copy(dst_pos, dst_end,
+						  logger->pid->pid_sz,
+						  logger->pid->pid_len);
+			break;
+		/* client id */
+		case OD_LOGGER_OP_CLIENT_ID:
+			if (client && client->id.id_prefix != NULL) {
 				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "%03d",
-						  (signed)tv.tv_usec / 1000);
+						  "%s%.*s", client->id.id_prefix,
+						  (signed)sizeof(client->id.id),
+						  client->id.id);
 				dst_pos += len;
 				break;
 			}
-			/* pid */
-			case 'p':
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "%s", logger->pid->pid_sz);
-				dst_pos += len;
-				break;
-			/* client id */
-			case 'i':
-				if (client && client->id.id_prefix != NULL) {
-					len = od_snprintf(
-						dst_pos, dst_end - dst_pos,
-						"%s%.*s", client->id.id_prefix,
-						(signed)sizeof(client->id.id),
-						client->id.id);
-					dst_pos += len;
-					break;
-				}
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "none");
-				dst_pos += len;
-				break;
-			/* server id */
-			case 's':
-				if (server && server->id.id_prefix != NULL) {
-					len = od_snprintf(
-						dst_pos, dst_end - dst_pos,
-						"%s%.*s", server->id.id_prefix,
-						(signed)sizeof(server->id.id),
-						server->id.id);
-					dst_pos += len;
-					break;
-				}
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "none");
-				dst_pos += len;
-				break;
-			/* user name */
-			case 'u':
-				if (client && client->startup.user.value_len) {
-					len = od_snprintf(
-						dst_pos, dst_end - dst_pos,
-						client->startup.user.value);
-					dst_pos += len;
-					break;
-				}
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "none");
-				dst_pos += len;
-				break;
-			/* database name */
-			case 'd':
-				if (client &&
-				    client->startup.database.value_len) {
-					len = od_snprintf(
-						dst_pos, dst_end - dst_pos,
-						client->startup.database.value);
-					dst_pos += len;
-					break;
-				}
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "none");
-				dst_pos += len;
-				break;
-			/* context */
-			case 'c':
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "%s", context);
-				dst_pos += len;
-				break;
-			/* level */
-			case 'l':
+			dst_pos += od_logger_copy(dst_pos, dst_end, "none", 4);
+			break;
+		/* server id */
+		case OD_LOGGER_OP_SERVER_ID:
+			if (server && server->id.id_prefix != NULL) {
 				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "%s", od_log_level[level]);
-				dst_pos += len;
-				break;
-			/* message */
-			case 'm':
-				len = od_vsnprintf(dst_pos, dst_end - dst_pos,
-						   fmt, args);
-				dst_pos += len;
-				break;
-			/* message (escaped) */
-			case 'M':
-				len = od_logger_escape(
-					dst_pos, dst_end - dst_pos, fmt, args);
+						  "%s%.*s", server->id.id_prefix,
+						  (signed)sizeof(server->id.id),
+						  server->id.id);
 				dst_pos += len;
 				break;
-			/* client host */
-			case 'h':
-				if (client && client->io.io) {
-					od_getpeername(client->io.io, peer,
-						       sizeof(peer), 1, 0);
-					len = od_snprintf(dst_pos,
-							  dst_end - dst_pos,
-							  "%s", peer);
-					dst_pos += len;
-					break;
-				}
+			}
+			dst_pos += od_logger_copy(dst_pos, dst_end, "none", 4);
+			break;
+		/* user name */
+		case OD_LOGGER_OP_USER:
+			if (client && client->startup.user.value_len) {
 				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "none");
+						  "%s",
+						  client->startup.user.value);
 				dst_pos += len;
 				break;
-			/* client port */
-			case 'r':
-				if (client && client->io.io) {
-					od_getpeername(client->io.io, peer,
-						       sizeof(peer), 0, 1);
-					len = od_snprintf(dst_pos,
-							  dst_end - dst_pos,
-							  "%s", peer);
-					dst_pos += len;
-					break;
-				}
-				len = od_snprintf(dst_pos, dst_end - dst_pos,
-						  "none");
+			}
+			dst_pos += od_logger_copy(dst_pos, dst_end, "none", 4);
+			break;
+		/* database name */
+		case OD_LOGGER_OP_DATABASE:
+			if (client && client->startup.database.value_len) {
+				len = od_snprintf(
+					dst_pos, dst_end - dst_pos, "%s",
+					client->startup.database.value);
 				dst_pos += len;
 				break;
-			case '%':
-				if (od_unlikely((dst_end - dst_pos) < 1))
-					break;
-				dst_pos[0] = '%';
-				dst_pos += 1;
-				break;
-			default:
-				if (od_unlikely((dst_end - dst_pos) < 2))
-					break;
-				dst_pos[0] = '%';
-				dst_pos[1] = *format_pos;
-				dst_pos += 2;
+			}
+			dst_pos += od_logger_copy(dst_pos, dst_end, "none", 4);
+			break;
+		/* context */
+		case OD_LOGGER_OP_CONTEXT:
+			dst_pos += od_logger_copy(dst_pos, dst_end, context,
+						  strlen(context));
+			break;
+		/* level */
+		case OD_LOGGER_OP_LEVEL:
+			dst_pos += od_logger_copy(dst_pos, dst_end,
+						  od_log_level[level],
+						  od_log_level_len[level]);
+			break;
+		/* message */
+		case OD_LOGGER_OP_MESSAGE:
+			len = od_vsnprintf(dst_pos, dst_end - dst_pos, fmt,
+					   args);
+			dst_pos += len;
+			break;
+		/* message (escaped) */
+		case OD_LOGGER_OP_MESSAGE_ESCAPED:
+			len = od_logger_escape(dst_pos, dst_end - dst_pos, fmt,
+					       args);
+			dst_pos += len;
+			break;
+		/* client host */
+		case OD_LOGGER_OP_CLIENT_HOST:
+			if (client && client->peer_host[0]) {
+				dst_pos += od_logger_copy(
+					dst_pos, dst_end, client->peer_host,
+					strlen(client->peer_host));
 				break;
 			}
-		} else {
-			if (od_unlikely((dst_end - dst_pos) < 1))
+			dst_pos += od_logger_copy(dst_pos, dst_end, "none", 4);
+			break;
+		/* client port */
+		case OD_LOGGER_OP_CLIENT_PORT:
+			if (client && client->peer_port[0]) {
+				dst_pos += od_logger_copy(
+					dst_pos, dst_end, client->peer_port,
+					strlen(client->peer_port));
 				break;
-			dst_pos[0] = *format_pos;
-			dst_pos += 1;
+			}
+			dst_pos += od_logger_copy(dst_pos, dst_end, "none", 4);
+			break;
 		}
-		format_pos++;
 	}
 	return dst_pos - output;
 }
 
+/*
+ * Structured output (json or logfmt) is written field by field
+ * straight into the line buffer, message is formatted in place and
+ * escaped backwards without intermediate copy. Line size is bounded,
+ * truncated values are still properly closed.
+ */
 typedef struct {
-	od_logger_level_t lvl;
-	char msg[FLEXIBLE_ARRAY_MEMBER];
-} _od_log_entry;
+	char *pos;
+	char *end;
+	int json;
+	int count;
+} od_logger_out_t;
+
+static char od_logger_hex[] = "0123456789abcdef";
+
+static inline int od_logger_quote_len(unsigned char c)
+{
+	if (od_likely(c >= 0x20 && c != '"' && c != '\\'))
+		return 1;
+	if (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t')
+		return 2;
+	return 6;
+}
+
+static inline int od_logger_quote_char(char *dst, unsigned char c)
+{
+	if (od_likely(c >= 0x20 && c != '"' && c != '\\')) {
+		dst[0] = c;
+		return 1;
+	}
+	dst[0] = '\\';
+	switch (c) {
+	case '"':
+	case '\\':
+		dst[1] = c;
+		return 2;
+	case '\n':
+		dst[1] = 'n';
+		return 2;
+	case '\r':
+		dst[1] = 'r';
+		return 2;
+	case '\t':
+		dst[1] = 't';
+		return 2;
+	}
+	dst[1] = 'u';
+	dst[2] = '0';
+	dst[3] = '0';
+	dst[4] = od_logger_hex[c >> 4];
+	dst[5] = od_logger_hex[c & 0xf];
+	return 6;
+}
+
+static inline int od_logger_quote(char *dst, char *dst_end, char *src,
+				  int src_len)
+{
+	char *dst_pos = dst;
+	int i;
+	for (i = 0; i < src_len; i++) {
+		unsigned char c = src[i];
+		if (od_unlikely(od_logger_quote_len(c) > dst_end - dst_pos))
+			break;
+		dst_pos += od_logger_quote_char(dst_pos, c);
+	}
+	return dst_pos - dst;
+}
+
+static inline int od_logger_quote_inplace(char *data, int len, char *end)
+{
+	/* escaped size, truncated where it does not fit */
+	int size = 0;
+	int i;
+	for (i = 0; i < len; i++) {
+		int char_size = od_logger_quote_len(data[i]);
+		if (od_unlikely(char_size > end - data - size))
+			break;
+		size += char_size;
+	}
+	if (od_likely(size == i))
+		return size;
 
-static inline size_t od_log_entry_req_size(size_t msg_len)
+	/* expand from the end, so no byte is overwritten before read */
+	char *dst = data + size;
+	while (i > 0) {
+		unsigned char c = data[--i];
+		dst -= od_logger_quote_len(c);
+		od_logger_quote_char(dst, c);
+	}
+	return size;
+}
+
+static inline void od_logger_out_raw(od_logger_out_t *out, char *data,
+				     int len)
+{
+	out->pos += od_logger_copy(out->pos, out->end, data, len);
+}
+
+/* returns 0 and skips the field when there is no room for it */
+static inline int od_logger_out_key(od_logger_out_t *out, char *key,
+				    int key_len, int reserve)
 {
-	return sizeof(od_logger_level_t) +
-	       sizeof(char) * (msg_len + /* NULL */ 1);
+	if (out->end - out->pos < key_len + 4 + reserve)
+		return 0;
+	if (out->json) {
+		*out->pos++ = out->count ? ',' : '{';
+		*out->pos++ = '"';
+		memcpy(out->pos, key, key_len);
+		out->pos += key_len;
+		*out->pos++ = '"';
+		*out->pos++ = ':';
+	} else {
+		if (out->count)
+			*out->pos++ = ' ';
+		memcpy(out->pos, key, key_len);
+		out->pos += key_len;
+		*out->pos++ = '=';
+	}
+	out->count++;
+	return 1;
+}
+
+#define od_logger_out_key_of(out, key, reserve) \
+	od_logger_out_key(out, key, sizeof(key) - 1, reserve)
+
+static inline void od_logger_out_string(od_logger_out_t *out, char *key,
+					int key_len, char *value,
+					int value_len)
+{
+	if (!od_logger_out_key(out, key, key_len, 2))
+		return;
+	*out->pos++ = '"';
+	out->pos += od_logger_quote(out->pos, out->end - 1, value, value_len);
+	*out->pos++ = '"';
+}
+
+#define od_logger_out_string_of(out, key, value, value_len) \
+	od_logger_out_string(out, key, sizeof(key) - 1, value, value_len)
+
+static inline void od_logger_out_id(od_logger_out_t *out, char *key,
+				    int key_len, od_id_t *id)
+{
+	int prefix_len = strlen(id->id_prefix);
+	if (!od_logger_out_key(out, key, key_len,
+			       2 + prefix_len + sizeof(id->id)))
+		return;
+	*out->pos++ = '"';
+	memcpy(out->pos, id->id_prefix, prefix_len);
+	out->pos += prefix_len;
+	memcpy(out->pos, id->id, sizeof(id->id));
+	out->pos += sizeof(id->id);
+	*out->pos++ = '"';
+}
+
+__attribute__((hot)) static inline int
+od_logger_format_structured(od_logger_t *logger, od_logger_level_t level,
+			    char *context, od_client_t *client,
+			    od_server_t *server, int64_t duration, char *fmt,
+			    va_list args, char *output, int output_len)
+{
+	od_logger_out_t out;
+	out.pos = output;
+	/* room for the line end */
+	out.end = output + output_len - 2;
+	out.json = logger->output == OD_LOGGER_JSON;
+	out.count = 0;
+
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	od_logger_time_t *cache = od_logger_time_of(&now);
+	int millis = now.tv_nsec / 1000000;
+	if (od_logger_out_key_of(&out, "time", cache->timestamp_len + 6)) {
+		*out.pos++ = '"';
+		/* timestamp without trailing 'Z' */
+		memcpy(out.pos, cache->timestamp, cache->timestamp_len - 1);
+		out.pos += cache->timestamp_len - 1;
+		out.pos[0] = '.';
+		out.pos[1] = '0' + millis / 100;
+		out.pos[2] = '0' + millis / 10 % 10;
+		out.pos[3] = '0' + millis % 10;
+		out.pos[4] = 'Z';
+		out.pos[5] = '"';
+		out.pos += 6;
+	}
+	if (od_logger_out_key_of(&out, "pid", logger->pid->pid_len))
+		od_logger_out_raw(&out, logger->pid->pid_sz,
+				  logger->pid->pid_len);
+	od_logger_out_string_of(&out, "level", od_log_level[level],
+				od_log_level_len[level]);
+	od_logger_out_string_of(&out, "context", context, strlen(context));
+
+	if (client) {
+		if (client->id.id_prefix)
+			od_logger_out_id(&out, "client", sizeof("client") - 1,
+					 &client->id);
+		if (client->startup.user.value_len)
+			od_logger_out_string_of(
+				&out, "user", client->startup.user.value,
+				client->startup.user.value_len - 1);
+		if (client->startup.database.value_len)
+			od_logger_out_string_of(
+				&out, "database",
+				client->startup.database.value,
+				client->startup.database.value_len - 1);
+		if (client->peer_host[0])
+			od_logger_out_string_of(&out, "host",
+						client->peer_host,
+						strlen(client->peer_host));
+		if (client->peer_port[0])
+			od_logger_out_string_of(&out, "port",
+						client->peer_port,
+						strlen(client->peer_port));
+	}
+	if (server && server->id.id_prefix)
+		od_logger_out_id(&out, "server", sizeof("server") - 1,
+				 &server->id);
+	if (duration >= 0 && od_logger_out_key_of(&out, "duration_us", 20))
+		out.pos += od_snprintf(out.pos, out.end - out.pos,
+				       "%" PRIi64, duration);
+
+	/* message is formatted in place and escaped afterwards */
+	if (od_logger_out_key_of(&out, "msg", 2)) {
+		*out.pos++ = '"';
+		int len = od_vsnprintf(out.pos, out.end - out.pos, fmt, args);
+		out.pos += od_logger_quote_inplace(out.pos, len, out.end - 1);
+		*out.pos++ = '"';
+	}
+
+	if (out.json)
+		*out.pos++ = '}';
+	*out.pos++ = '\n';
+	return out.pos - output;
+}
+
+static inline int od_logger_format_structured_plain(
+	od_logger_t *logger, od_logger_level_t level, char *context,
+	od_client_t *client, od_server_t *server, char *output,
+	int output_len, char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	int len = od_logger_format_structured(logger, level, context, client,
+					      server, -1, fmt, args, output,
+					      output_len);
+	va_end(args);
+	return len;
 }
 
 static inline void _od_logger_write(od_logger_t *l, char *data, int len,
@@ -412,75 +763,346 @@ static inline void _od_logger_write(od_logger_t *l, char *data, int len,
 	(void)rc;
 }
 
+typedef struct {
+	uint32_t len;
+	uint32_t level;
+} od_logger_record_t;
+
+#define OD_LOGGER_RECORD_PAD UINT32_MAX
+#define OD_LOGGER_BATCH 128
+#define OD_LOGGER_IDLE_MS 100
+#define OD_LOGGER_BLOCK_US 50
+
+static __thread od_logger_queue_t *od_logger_queue_self = NULL;
+static __thread int od_logger_thread = 0;
+
+static inline uint64_t od_logger_record_size(int len)
+{
+	return (sizeof(od_logger_record_t) + len + 7) & ~(uint64_t)7;
+}
+
+static inline od_logger_queue_t *od_logger_queue(od_logger_t *logger)
+{
+	od_logger_queue_t *queue = od_logger_queue_self;
+	if (od_likely(queue))
+		return queue;
+	queue = malloc(sizeof(od_logger_queue_t));
+	if (queue == NULL)
+		return NULL;
+	queue->data = malloc(logger->queue_size);
+	if (queue->data == NULL) {
+		free(queue);
+		return NULL;
+	}
+	queue->size = logger->queue_size;
+	queue->head = 0;
+	queue->tail = 0;
+	queue->written = 0;
+	queue->dropped = 0;
+	queue->spilled = 0;
+	queue->blocked = 0;
+
+	/* queues are removed only under drain_lock by their own
+	 * thread, so lock-free push is enough */
+	do {
+		queue->next = logger->queues;
+	} while (!__sync_bool_compare_and_swap(&logger->queues, queue->next,
+					       queue));
+	od_logger_queue_self = queue;
+	return queue;
+}
+
+/* returns -1 when queue is full and 1 when it was empty */
+static inline int od_logger_queue_push(od_logger_queue_t *queue,
+				       od_logger_level_t level, char *data,
+				       int len)
+{
+	uint64_t size = od_logger_record_size(len);
+	uint64_t tail = queue->tail;
+	uint64_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+	uint64_t pos = tail % queue->size;
+
+	/* record is never wrapped, skip the rest of the ring instead */
+	uint64_t pad = 0;
+	if (queue->size - pos < size)
+		pad = queue->size - pos;
+	if (tail + pad + size - head > queue->size)
+		return -1;
+
+	od_logger_record_t *record;
+	if (pad) {
+		record = (od_logger_record_t *)(queue->data + pos);
+		record->len = pad;
+		record->level = OD_LOGGER_RECORD_PAD;
+		pos = 0;
+	}
+	record = (od_logger_record_t *)(queue->data + pos);
+	record->len = len;
+	record->level = level;
+	memcpy(record + 1, data, len);
+
+	__atomic_store_n(&queue->tail, tail + pad + size, __ATOMIC_RELEASE);
+	return tail == head;
+}
+
+static inline void od_logger_writev(int fd, struct iovec *iov, int count)
+{
+	ssize_t rc = writev(fd, iov, count);
+	if (rc == -1)
+		return;
+
+	/* finish partial write */
+	int i;
+	for (i = 0; i < count; i++) {
+		if ((size_t)rc >= iov[i].iov_len) {
+			rc -= iov[i].iov_len;
+			continue;
+		}
+		char *pos = (char *)iov[i].iov_base + rc;
+		size_t left = iov[i].iov_len - rc;
+		rc = 0;
+		while (left > 0) {
+			ssize_t n = write(fd, pos, left);
+			if (n <= 0)
+				return;
+			pos += n;
+			left -= n;
+		}
+	}
+}
+
+static inline int od_logger_queue_drain(od_logger_t *logger,
+					od_logger_queue_t *queue)
+{
+	struct iovec iov[OD_LOGGER_BATCH];
+	int count = 0;
+	uint64_t head = queue->head;
+	uint64_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+	while (head < tail && count < OD_LOGGER_BATCH) {
+		od_logger_record_t *record;
+		record = (od_logger_record_t *)(queue->data +
+						head % queue->size);
+		if (record->level == OD_LOGGER_RECORD_PAD) {
+			head += record->len;
+			continue;
+		}
+		iov[count].iov_base = record + 1;
+		iov[count].iov_len = record->len;
+		count++;
+		if (logger->log_syslog)
+			syslog(od_log_syslog_level[record->level], "%.*s",
+			       (int)record->len, (char *)(record + 1));
+		head += od_logger_record_size(record->len);
+	}
+	if (count > 0) {
+		if (logger->fd != -1)
+			od_logger_writev(logger->fd, iov, count);
+		if (logger->log_stdout)
+			od_logger_writev(STDOUT_FILENO, iov, count);
+		od_atomic_u64_add(&queue->written, count);
+	}
+
+	/* lines are written, give space back to the producer */
+	__atomic_store_n(&queue->head, head, __ATOMIC_RELEASE);
+	return count;
+}
+
+int od_logger_flush(od_logger_t *logger)
+{
+	int total = 0;
+	int count;
+	pthread_mutex_lock(&logger->drain_lock);
+	do {
+		count = 0;
+		od_logger_queue_t *queue;
+		for (queue = logger->queues; queue; queue = queue->next)
+			count += od_logger_queue_drain(logger, queue);
+		total += count;
+	} while (count > 0);
+	pthread_mutex_unlock(&logger->drain_lock);
+	return total;
+}
+
+/* drain and free the queue of the calling thread, must be
+ * called when the thread logs nothing more */
+void od_logger_release(od_logger_t *logger)
+{
+	od_logger_queue_t *queue = od_logger_queue_self;
+	if (queue == NULL)
+		return;
+	od_logger_queue_self = NULL;
+
+	pthread_mutex_lock(&logger->drain_lock);
+	while (od_logger_queue_drain(logger, queue) > 0)
+		;
+
+	/* head is replaced by concurrent push, other links are
+	 * changed only under drain_lock */
+	if (!__sync_bool_compare_and_swap(&logger->queues, queue,
+					  queue->next)) {
+		od_logger_queue_t *prev = logger->queues;
+		while (prev->next != queue)
+			prev = prev->next;
+		prev->next = queue->next;
+	}
+
+	logger->released_written += od_atomic_u64_of(&queue->written);
+	logger->released_dropped += od_atomic_u64_of(&queue->dropped);
+	logger->released_spilled += od_atomic_u64_of(&queue->spilled);
+	logger->released_blocked += od_atomic_u64_of(&queue->blocked);
+	pthread_mutex_unlock(&logger->drain_lock);
+
+	free(queue->data);
+	free(queue);
+}
+
+void od_logger_stat(od_logger_t *logger, uint64_t *written, uint64_t *dropped,
+		    uint64_t *spilled, uint64_t *blocked)
+{
+	pthread_mutex_lock(&logger->drain_lock);
+	*written += logger->released_written;
+	*dropped += logger->released_dropped;
+	*spilled += logger->released_spilled;
+	*blocked += logger->released_blocked;
+	od_logger_queue_t *queue;
+	for (queue = logger->queues; queue; queue = queue->next) {
+		*written += od_atomic_u64_of(&queue->written);
+		*dropped += od_atomic_u64_of(&queue->dropped);
+		*spilled += od_atomic_u64_of(&queue->spilled);
+		*blocked += od_atomic_u64_of(&queue->blocked);
+	}
+	pthread_mutex_unlock(&logger->drain_lock);
+}
+
+static inline void od_logger_wakeup(od_logger_t *logger)
+{
+	machine_msg_t *msg;
+	msg = machine_msg_create(0);
+	if (msg == NULL)
+		return;
+	machine_msg_set_type(msg, OD_MSG_LOG);
+	machine_channel_write(logger->task_channel, msg);
+}
+
 static inline void od_logger(void *arg)
 {
 	od_logger_t *logger = arg;
+	od_logger_thread = 1;
 
 	for (;;) {
 		machine_msg_t *msg;
-		msg = machine_channel_read(logger->task_channel, UINT32_MAX);
-		if (msg == NULL)
+		msg = machine_channel_read(logger->task_channel,
+					   OD_LOGGER_IDLE_MS);
+		if (msg)
+			machine_msg_free(msg);
+		else if (machine_cancelled())
 			break;
 
-		od_msg_t msg_type;
-		msg_type = machine_msg_type(msg);
-		switch (msg_type) {
-		case OD_MSG_LOG: {
-			_od_log_entry *le = machine_msg_data(msg);
-			int len = strlen(le->msg);
-
-			_od_logger_write(logger, le->msg, len, le->lvl);
-		} break;
-		default: {
-			assert(0);
-		} break;
+		/* producers wake logger up only when their queue was
+		 * empty, so drain until nothing is left */
+		od_logger_flush(logger);
+	}
+}
+
+static inline void od_logger_enqueue(od_logger_t *logger,
+				     od_logger_level_t level, char *data,
+				     int len)
+{
+	if (!logger->loaded || !logger->queue_size || od_logger_thread) {
+		_od_logger_write(logger, data, len, level);
+		return;
+	}
+
+	/* process is about to exit, keep lines order */
+	if (level == OD_FATAL) {
+		od_logger_flush(logger);
+		_od_logger_write(logger, data, len, level);
+		return;
+	}
+
+	od_logger_queue_t *queue = od_logger_queue(logger);
+	if (od_unlikely(queue == NULL ||
+			od_logger_record_size(len) > queue->size)) {
+		_od_logger_write(logger, data, len, level);
+		return;
+	}
+
+	int rc;
+	for (;;) {
+		rc = od_logger_queue_push(queue, level, data, len);
+		if (od_likely(rc != -1))
+			break;
+		switch (logger->queue_overflow) {
+		case OD_LOGGER_DROP:
+			od_atomic_u64_inc(&queue->dropped);
+			return;
+		case OD_LOGGER_SPILL:
+			/* lines already queued by this thread go first */
+			od_atomic_u64_inc(&queue->spilled);
+			pthread_mutex_lock(&logger->drain_lock);
+			while (od_logger_queue_drain(logger, queue) > 0)
+				;
+			_od_logger_write(logger, data, len, level);
+			pthread_mutex_unlock(&logger->drain_lock);
+			return;
+		case OD_LOGGER_BLOCK:
+			/* do not yield: caller may hold a thread lock
+			 * shared with other coroutines of this worker,
+			 * so the whole worker thread is stalled here */
+			od_atomic_u64_inc(&queue->blocked);
+			od_logger_wakeup(logger);
+			usleep(OD_LOGGER_BLOCK_US);
+			break;
 		}
+	}
+	if (rc == 1)
+		od_logger_wakeup(logger);
+}
 
-		machine_msg_free(msg);
+static inline int od_logger_is_debug(od_logger_t *logger, void *client,
+				     void *server)
+{
+	if (logger->log_debug)
+		return 1;
+	od_client_t *client_ref = client;
+	od_server_t *server_ref = server;
+	if (client_ref && client_ref->rule) {
+		return client_ref->rule->log_debug;
+	} else if (server_ref && server_ref->route) {
+		od_route_t *route = server_ref->route;
+		return route->rule->log_debug;
 	}
+	return 0;
 }
 
-void od_logger_write(od_logger_t *logger, od_logger_level_t level,
-		     char *context, void *client, void *server, char *fmt,
-		     va_list args)
+void od_logger_write_duration(od_logger_t *logger, od_logger_level_t level,
+			      char *context, void *client, void *server,
+			      int64_t duration, char *fmt, va_list args)
 {
 	if (logger->fd == -1 && !logger->log_stdout && !logger->log_syslog)
 		return;
 
-	if (level == OD_DEBUG) {
-		int is_debug = logger->log_debug;
-		if (!is_debug) {
-			od_client_t *client_ref = client;
-			od_server_t *server_ref = server;
-			if (client_ref && client_ref->rule) {
-				is_debug = client_ref->rule->log_debug;
-			} else if (server_ref && server_ref->route) {
-				od_route_t *route = server_ref->route;
-				is_debug = route->rule->log_debug;
-			}
-		}
-		if (!is_debug)
-			return;
-	}
+	if (level == OD_DEBUG && !od_logger_is_debug(logger, client, server))
+		return;
 
 	char output[OD_LOGLINE_MAXLEN];
 	int len;
-	len = od_logger_format(logger, level, context, client, server, fmt,
-			       args, output, sizeof(output));
-	if (logger->loaded && false) {
-		/* create new log event and pass it to logger pool */
-		machine_msg_t *msg;
-		msg = machine_msg_create(od_log_entry_req_size(len));
-
-		machine_msg_set_type(msg, OD_MSG_LOG);
-		_od_log_entry *le = machine_msg_data(msg);
-		strncpy(le->msg, output, len);
-		le->msg[len] = '\0';
+	if (logger->output == OD_LOGGER_TEXT)
+		len = od_logger_format(logger, level, context, client, server,
+				       fmt, args, output, sizeof(output));
+	else
+		len = od_logger_format_structured(logger, level, context,
+						  client, server, duration, fmt,
+						  args, output, sizeof(output));
+	od_logger_enqueue(logger, level, output, len);
+}
 
-		machine_channel_write(logger->task_channel, msg);
-	} else {
-		_od_logger_write(logger, output, len, level);
-	}
+void od_logger_write(od_logger_t *logger, od_logger_level_t level,
+		     char *context, void *client, void *server, char *fmt,
+		     va_list args)
+{
+	od_logger_write_duration(logger, level, context, client, server, -1,
+				 fmt, args);
 }
 
 extern void od_logger_write_plain(od_logger_t *logger, od_logger_level_t level,
@@ -490,40 +1112,21 @@ extern void od_logger_write_plain(od_logger_t *logger, od_logger_level_t level,
 	if (logger->fd == -1 && !logger->log_stdout && !logger->log_syslog)
 		return;
 
-	if (level == OD_DEBUG) {
-		int is_debug = logger->log_debug;
-		if (!is_debug) {
-			od_client_t *client_ref = client;
-			od_server_t *server_ref = server;
-			if (client_ref && client_ref->rule) {
-				is_debug = client_ref->rule->log_debug;
-			} else if (server_ref && server_ref->route) {
-				od_route_t *route = server_ref->route;
-				is_debug = route->rule->log_debug;
-			}
-		}
-		if (!is_debug)
-			return;
-	}
+	if (level == OD_DEBUG && !od_logger_is_debug(logger, client, server))
+		return;
 
 	int len = strlen(string);
 	char output[len + OD_LOGLINE_MAXLEN];
-	va_list empty_va_list;
-	len = od_logger_format(logger, level, context, client, server, string,
-			       empty_va_list, output, len + 100);
-
-	if (logger->loaded) {
-		/* create new log event and pass it to logger pool */
-		machine_msg_t *msg;
-		msg = machine_msg_create(od_log_entry_req_size(len));
-
-		machine_msg_set_type(msg, OD_MSG_LOG);
-		_od_log_entry *le = machine_msg_data(msg);
-		strncpy(le->msg, output, len);
-		le->msg[len] = '\0';
-
-		machine_channel_write(logger->task_channel, msg);
+	if (logger->output == OD_LOGGER_TEXT) {
+		va_list empty_va_list;
+		len = od_logger_format(logger, level, context, client, server,
+				       string, empty_va_list, output,
+				       len + 100);
 	} else {
-		_od_logger_write(logger, output, len, level);
+		len = od_logger_format_structured_plain(
+			logger, level, context, client, server, output,
+			sizeof(output), "%s", string);
 	}
+
+	od_logger_enqueue(logger, level, output, len);
 }
@@ -9,10 +9,68 @@
 
 #define OD_LOGLINE_MAXLEN 1024
 
+typedef struct od_logger_op od_logger_op_t;
+typedef struct od_logger_queue od_logger_queue_t;
 typedef struct od_logger od_logger_t;
 
 typedef enum { OD_LOG, OD_ERROR, OD_DEBUG, OD_FATAL } od_logger_level_t;
 
+typedef enum {
+	OD_LOGGER_TEXT,
+	OD_LOGGER_JSON,
+	OD_LOGGER_LOGFMT
+} od_logger_output_t;
+
+/* log format is compiled once into a list of operations */
+typedef enum {
+	OD_LOGGER_OP_TEXT,
+	OD_LOGGER_OP_UNIXTIME,
+	OD_LOGGER_OP_TIMESTAMP,
+	OD_LOGGER_OP_MILLIS,
+	OD_LOGGER_OP_PID,
+	OD_LOGGER_OP_CLIENT_ID,
+	OD_LOGGER_OP_SERVER_ID,
+	OD_LOGGER_OP_USER,
+	OD_LOGGER_OP_DATABASE,
+	OD_LOGGER_OP_CONTEXT,
+	OD_LOGGER_OP_LEVEL,
+	OD_LOGGER_OP_MESSAGE,
+	OD_LOGGER_OP_MESSAGE_ESCAPED,
+	OD_LOGGER_OP_CLIENT_HOST,
+	OD_LOGGER_OP_CLIENT_PORT
+} od_logger_op_type_t;
+
+struct od_logger_op {
+	od_logger_op_type_t type;
+	/* literal text for OD_LOGGER_OP_TEXT */
+	char *text;
+	int text_len;
+};
+
+/* what to do with a line when thread log queue is full */
+typedef enum {
+	OD_LOGGER_SPILL,
+	OD_LOGGER_DROP,
+	OD_LOGGER_BLOCK
+} od_logger_overflow_t;
+
+/*
+ * Every thread writes formatted lines into its own single-producer
+ * ring of records, logger machine is the only consumer: it drains
+ * all rings and writes collected lines with a single writev().
+ */
+struct od_logger_queue {
+	char *data;
+	uint64_t size;
+	uint64_t head;
+	uint64_t tail;
+	od_atomic_u64_t written;
+	od_atomic_u64_t dropped;
+	od_atomic_u64_t spilled;
+	od_atomic_u64_t blocked;
+	od_logger_queue_t *next;
+};
+
 struct od_logger {
 	od_pid_t *pid;
 	int log_debug;
@@ -20,17 +78,34 @@ struct od_logger {
 	int log_syslog;
 	char *format;
 	int format_len;
+	od_logger_op_t *format_ops;
+	int format_ops_count;
+	char *format_text;
+	od_logger_output_t output;
 
 	int fd;
 
 	int loaded;
 	int64_t machine;
-	/* makes sence only with use_asynclog option on */
 	machine_channel_t *task_channel;
+
+	int queue_size;
+	od_logger_overflow_t queue_overflow;
+	od_logger_queue_t *queues;
+	pthread_mutex_t drain_lock;
+	/* counters of queues released by finished threads */
+	uint64_t released_written;
+	uint64_t released_dropped;
+	uint64_t released_spilled;
+	uint64_t released_blocked;
 };
 
 extern od_retcode_t od_logger_init(od_logger_t *, od_pid_t *);
 extern od_retcode_t od_logger_load(od_logger_t *logger);
+extern int od_logger_flush(od_logger_t *);
+extern void od_logger_release(od_logger_t *);
+extern void od_logger_stat(od_logger_t *, uint64_t *, uint64_t *, uint64_t *,
+			   uint64_t *);
 
 static inline void od_logger_set_debug(od_logger_t *logger, int enable)
 {
@@ -42,18 +117,29 @@ static inline void od_logger_set_stdout(od_logger_t *logger, int enable)
 	logger->log_stdout = enable;
 }
 
-static inline void od_logger_set_format(od_logger_t *logger, char *format)
+static inline void od_logger_set_output(od_logger_t *logger,
+					od_logger_output_t output)
+{
+	logger->output = output;
+}
+
+static inline void od_logger_set_queue(od_logger_t *logger, int size,
+				       od_logger_overflow_t overflow)
 {
-	logger->format = format;
-	logger->format_len = strlen(format);
+	/* keep records aligned */
+	logger->queue_size = size & ~7;
+	logger->queue_overflow = overflow;
 }
 
+extern int od_logger_set_format(od_logger_t *, char *);
 extern int od_logger_open(od_logger_t *, char *);
 extern int od_logger_reopen(od_logger_t *, char *);
 extern int od_logger_open_syslog(od_logger_t *, char *, char *);
 extern void od_logger_close(od_logger_t *);
 extern void od_logger_write(od_logger_t *, od_logger_level_t, char *, void *,
 			    void *, char *, va_list);
+extern void od_logger_write_duration(od_logger_t *, od_logger_level_t, char *,
+				     void *, void *, int64_t, char *, va_list);
 extern void od_logger_write_plain(od_logger_t *, od_logger_level_t, char *,
 				  void *, void *, char *);
 
@@ -75,6 +161,29 @@ static inline void od_debug(od_logger_t *logger, char *context, void *client,
 	va_end(args);
 }
 
+/* duration in microseconds is a separate field of structured output */
+static inline void od_log_duration(od_logger_t *logger, char *context,
+				   void *client, void *server,
+				   int64_t duration, char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	od_logger_write_duration(logger, OD_LOG, context, client, server,
+				 duration, fmt, args);
+	va_end(args);
+}
+
+static inline void od_debug_duration(od_logger_t *logger, char *context,
+				     void *client, void *server,
+				     int64_t duration, char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	od_logger_write_duration(logger, OD_DEBUG, context, client, server,
+				 duration, fmt, args);
+	va_end(args);
+}
+
 static inline void od_error(od_logger_t *logger, char *context, void *client,
 			    void *server, char *fmt, ...)
 {
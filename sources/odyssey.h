@@ -43,6 +43,7 @@
 #include "sources/tls_config.h"
 #include "sources/config.h"
 
+#include "sources/ldap_cache.h"
 #ifdef LDAP_FOUND
 #include "sources/ldap_endpoint.h"
 #endif
@@ -53,6 +54,10 @@
 
 #include "sources/storage.h"
 #include "sources/pool.h"
+#include "sources/auth_cache.h"
+#ifdef USE_SCRAM
+#include "sources/scram_cache.h"
+#endif
 #include "sources/rules.h"
 
 #include "sources/config_common.h"
@@ -73,7 +78,11 @@
 #include "sources/relay.h"
 
 #include "sources/tdigest.h"
+#include "sources/hgram.h"
+#include "sources/lifecycle.h"
 #include "sources/stat.h"
+#include "sources/slow_query.h"
+#include "sources/query_stats.h"
 
 /* server */
 #include "sources/ejection.h"
@@ -98,6 +107,7 @@
 #include "sources/config_reader.h"
 
 #include "sources/auth.h"
+#include "sources/auth_executor.h"
 #include "sources/query.h"
 #include "sources/auth_query.h"
 
@@ -129,6 +139,7 @@
 
 #include "sources/worker.h"
 #include "sources/worker_pool.h"
+#include "sources/handshake_pool.h"
 
 #include "sources/watchdog.h"
 
@@ -69,7 +69,7 @@ static int od_pam_conversation(int msgc, const struct pam_message **msgv,
 }
 
 int od_pam_auth(char *od_pam_service, char *usrname,
-		od_pam_auth_data_t *auth_data, machine_io_t *io)
+		od_pam_auth_data_t *auth_data, char *peer)
 {
 	struct pam_conv conv = {
 		od_pam_conversation,
@@ -82,8 +82,6 @@ int od_pam_auth(char *od_pam_service, char *usrname,
 	if (rc != PAM_SUCCESS)
 		goto error;
 
-	char peer[128];
-	od_getpeername(io, peer, sizeof(peer), 1, 0);
 	rc = pam_set_item(pamh, PAM_RHOST, peer);
 	if (rc != PAM_SUCCESS) {
 		goto error;
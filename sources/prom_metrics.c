@@ -47,6 +47,31 @@ int od_prom_metrics_init(struct od_prom_metrics *self)
 			       "Number of processed clients", 1, worker_label);
 	prom_collector_add_metric(stat_metrics_collector,
 				  self->clients_processed);
+	self->loop_ready = prom_gauge_new(
+		"loop_ready", "Coroutines ready to run", 1, worker_label);
+	prom_collector_add_metric(stat_metrics_collector, self->loop_ready);
+	self->loop_timers = prom_gauge_new("loop_timers", "Active timers", 1,
+					   worker_label);
+	prom_collector_add_metric(stat_metrics_collector, self->loop_timers);
+	self->loop_switch_rate =
+		prom_gauge_new("loop_switch_rate",
+			       "Coroutine switches per second", 1, worker_label);
+	prom_collector_add_metric(stat_metrics_collector,
+				  self->loop_switch_rate);
+	self->loop_wait_pct = prom_gauge_new(
+		"loop_wait_pct", "Percent of time blocked in epoll_wait", 1,
+		worker_label);
+	prom_collector_add_metric(stat_metrics_collector, self->loop_wait_pct);
+	self->loop_run_max = prom_gauge_new(
+		"loop_run_max", "Longest coroutine run without yield in usec",
+		1, worker_label);
+	prom_collector_add_metric(stat_metrics_collector, self->loop_run_max);
+	self->loop_ready_delay_max = prom_gauge_new(
+		"loop_ready_delay_max",
+		"Longest delay between coroutine wakeup and run in usec", 1,
+		worker_label);
+	prom_collector_add_metric(stat_metrics_collector,
+				  self->loop_ready_delay_max);
 
 	self->stat_cb_metrics = prom_collector_registry_new("stat_cb_metrics");
 	prom_collector_t *stat_cb_metrics_collector =
@@ -108,6 +133,64 @@ int od_prom_metrics_init(struct od_prom_metrics *self)
 			       user_database_labels);
 	prom_collector_add_metric(stat_cb_metrics_collector,
 				  self->database_len);
+	const char *lifecycle_labels[3] = { "user", "database", "phase" };
+	self->lifecycle_count =
+		prom_gauge_new("lifecycle_count",
+			       "Connection lifecycle phases count", 3,
+			       lifecycle_labels);
+	prom_collector_add_metric(stat_cb_metrics_collector,
+				  self->lifecycle_count);
+	self->lifecycle_p99_time = prom_gauge_new(
+		"lifecycle_p99_time",
+		"99th percentile of connection lifecycle phase time in usec", 3,
+		lifecycle_labels);
+	prom_collector_add_metric(stat_cb_metrics_collector,
+				  self->lifecycle_p99_time);
+	self->pool_maxwait = prom_gauge_new(
+		"pool_maxwait",
+		"Wait time of the oldest client queued for server in usec", 2,
+		user_database_labels);
+	prom_collector_add_metric(stat_cb_metrics_collector,
+				  self->pool_maxwait);
+	self->pool_wait_timeouts = prom_gauge_new(
+		"pool_wait_timeouts",
+		"Clients which did not get server within pool_timeout", 2,
+		user_database_labels);
+	prom_collector_add_metric(stat_cb_metrics_collector,
+				  self->pool_wait_timeouts);
+
+	self->query_stat_metrics =
+		prom_collector_registry_new("query_stat_metrics");
+	prom_collector_t *query_stat_metrics_collector =
+		prom_collector_new("query_stat_metrics_collector");
+	err = prom_collector_registry_register_collector(
+		self->query_stat_metrics, query_stat_metrics_collector);
+	if (err)
+		return err;
+	const char *query_labels[3] = { "user", "database", "fingerprint" };
+	self->query_calls = prom_gauge_new(
+		"query_calls", "Query calls count", 3, query_labels);
+	prom_collector_add_metric(query_stat_metrics_collector,
+				  self->query_calls);
+	self->query_time = prom_gauge_new(
+		"query_time", "Total query time in usec", 3, query_labels);
+	prom_collector_add_metric(query_stat_metrics_collector,
+				  self->query_time);
+	self->query_p99_time =
+		prom_gauge_new("query_p99_time",
+			       "99th percentile of query time in usec", 3,
+			       query_labels);
+	prom_collector_add_metric(query_stat_metrics_collector,
+				  self->query_p99_time);
+	self->query_rows = prom_gauge_new(
+		"query_rows", "Total rows processed", 3, query_labels);
+	prom_collector_add_metric(query_stat_metrics_collector,
+				  self->query_rows);
+	self->query_bytes = prom_gauge_new(
+		"query_bytes", "Total bytes received from server", 3,
+		query_labels);
+	prom_collector_add_metric(query_stat_metrics_collector,
+				  self->query_bytes);
 	return 0;
 }
 
@@ -193,6 +276,40 @@ int od_prom_metrics_write_worker_stat(
 	return 0;
 }
 
+int od_prom_metrics_write_worker_loop_stat(
+	od_prom_metrics_t *self, int worker_id, u_int64_t count_ready,
+	u_int64_t count_timer, u_int64_t switch_rate, u_int64_t wait_pct,
+	u_int64_t run_max_us, u_int64_t ready_delay_max_us)
+{
+	if (self == NULL)
+		return 1;
+	char worker_label[12];
+	sprintf(worker_label, "worker[%d]", worker_id);
+	const char *labels[1] = { worker_label };
+	int err;
+	err = prom_gauge_set(self->loop_ready, (double)count_ready, labels);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->loop_timers, (double)count_timer, labels);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->loop_switch_rate, (double)switch_rate,
+			     labels);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->loop_wait_pct, (double)wait_pct, labels);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->loop_run_max, (double)run_max_us, labels);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->loop_ready_delay_max,
+			     (double)ready_delay_max_us, labels);
+	if (err)
+		return err;
+	return 0;
+}
+
 const char *od_prom_metrics_get_stat(od_prom_metrics_t *self)
 {
 	if (self == NULL)
@@ -258,6 +375,44 @@ int od_prom_metrics_write_stat_cb(
 	return 0;
 }
 
+int od_prom_metrics_write_lifecycle_stat(od_prom_metrics_t *self,
+					 const char *user, const char *database,
+					 const char *phase, u_int64_t count,
+					 u_int64_t p99_time)
+{
+	if (self == NULL)
+		return 1;
+	const char *lifecycle_label[3] = { user, database, phase };
+	int err = prom_gauge_set(self->lifecycle_count, (double)count,
+				 lifecycle_label);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->lifecycle_p99_time, (double)p99_time,
+			     lifecycle_label);
+	if (err)
+		return err;
+	return 0;
+}
+
+int od_prom_metrics_write_pool_wait_stat(od_prom_metrics_t *self,
+					 const char *user, const char *database,
+					 u_int64_t maxwait,
+					 u_int64_t wait_timeouts)
+{
+	if (self == NULL)
+		return 1;
+	const char *user_database_label[2] = { user, database };
+	int err = prom_gauge_set(self->pool_maxwait, (double)maxwait,
+				 user_database_label);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->pool_wait_timeouts, (double)wait_timeouts,
+			     user_database_label);
+	if (err)
+		return err;
+	return 0;
+}
+
 extern const char *od_prom_metrics_get_stat_cb(od_prom_metrics_t *self)
 {
 	if (self == NULL)
@@ -265,6 +420,44 @@ extern const char *od_prom_metrics_get_stat_cb(od_prom_metrics_t *self)
 	return prom_collector_registry_bridge(self->stat_cb_metrics);
 }
 
+int od_prom_metrics_write_query_stat(od_prom_metrics_t *self,
+				     const char *user, const char *database,
+				     u_int64_t fingerprint, u_int64_t calls,
+				     u_int64_t time, u_int64_t p99_time,
+				     u_int64_t rows, u_int64_t bytes)
+{
+	if (self == NULL)
+		return 1;
+	char fingerprint_str[17];
+	od_snprintf(fingerprint_str, sizeof(fingerprint_str), "%016" PRIx64,
+		    (uint64_t)fingerprint);
+	const char *query_label[3] = { user, database, fingerprint_str };
+	int err = prom_gauge_set(self->query_calls, (double)calls, query_label);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->query_time, (double)time, query_label);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->query_p99_time, (double)p99_time,
+			     query_label);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->query_rows, (double)rows, query_label);
+	if (err)
+		return err;
+	err = prom_gauge_set(self->query_bytes, (double)bytes, query_label);
+	if (err)
+		return err;
+	return 0;
+}
+
+extern const char *od_prom_metrics_get_query_stat(od_prom_metrics_t *self)
+{
+	if (self == NULL)
+		return NULL;
+	return prom_collector_registry_bridge(self->query_stat_metrics);
+}
+
 void od_prom_free(void *__ptr)
 {
 	prom_free(__ptr);
@@ -281,6 +474,12 @@ extern int od_prom_metrics_destroy(od_prom_metrics_t *self)
 	prom_free(self->count_coroutine);
 	prom_free(self->count_coroutine_cache);
 	prom_free(self->clients_processed);
+	prom_free(self->loop_ready);
+	prom_free(self->loop_timers);
+	prom_free(self->loop_switch_rate);
+	prom_free(self->loop_wait_pct);
+	prom_free(self->loop_run_max);
+	prom_free(self->loop_ready_delay_max);
 	prom_free(self->stat_metrics);
 
 	prom_free(self->database_len);
@@ -294,8 +493,19 @@ extern int od_prom_metrics_destroy(od_prom_metrics_t *self)
 	prom_free(self->avg_query_time);
 	prom_free(self->avg_recv_client);
 	prom_free(self->avg_recv_server);
+	prom_free(self->lifecycle_count);
+	prom_free(self->lifecycle_p99_time);
+	prom_free(self->pool_maxwait);
+	prom_free(self->pool_wait_timeouts);
 	prom_free(self->stat_cb_metrics);
 
+	prom_free(self->query_calls);
+	prom_free(self->query_time);
+	prom_free(self->query_p99_time);
+	prom_free(self->query_rows);
+	prom_free(self->query_bytes);
+	prom_free(self->query_stat_metrics);
+
 	free(self);
 	return 0;
 }
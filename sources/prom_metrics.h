@@ -17,6 +17,12 @@ struct od_prom_metrics {
 	prom_gauge_t *count_coroutine;
 	prom_gauge_t *count_coroutine_cache;
 	prom_gauge_t *clients_processed;
+	prom_gauge_t *loop_ready;
+	prom_gauge_t *loop_timers;
+	prom_gauge_t *loop_switch_rate;
+	prom_gauge_t *loop_wait_pct;
+	prom_gauge_t *loop_run_max;
+	prom_gauge_t *loop_ready_delay_max;
 
 	prom_collector_registry_t *stat_cb_metrics;
 	prom_gauge_t *database_len;
@@ -30,6 +36,17 @@ struct od_prom_metrics {
 	prom_gauge_t *avg_query_time;
 	prom_gauge_t *avg_recv_client;
 	prom_gauge_t *avg_recv_server;
+	prom_gauge_t *lifecycle_count;
+	prom_gauge_t *lifecycle_p99_time;
+	prom_gauge_t *pool_maxwait;
+	prom_gauge_t *pool_wait_timeouts;
+
+	prom_collector_registry_t *query_stat_metrics;
+	prom_gauge_t *query_calls;
+	prom_gauge_t *query_time;
+	prom_gauge_t *query_p99_time;
+	prom_gauge_t *query_rows;
+	prom_gauge_t *query_bytes;
 };
 
 extern int od_prom_metrics_init(od_prom_metrics_t *self);
@@ -48,6 +65,11 @@ extern int od_prom_metrics_write_worker_stat(
 	u_int64_t msg_cache_size, u_int64_t count_coroutine,
 	u_int64_t count_coroutine_cache, u_int64_t clients_processed);
 
+extern int od_prom_metrics_write_worker_loop_stat(
+	od_prom_metrics_t *self, int worker_id, u_int64_t count_ready,
+	u_int64_t count_timer, u_int64_t switch_rate, u_int64_t wait_pct,
+	u_int64_t run_max_us, u_int64_t ready_delay_max_us);
+
 extern const char *od_prom_metrics_get_stat(od_prom_metrics_t *self);
 
 extern int od_prom_metrics_write_stat_cb(
@@ -60,6 +82,26 @@ extern int od_prom_metrics_write_stat_cb(
 
 extern const char *od_prom_metrics_get_stat_cb(od_prom_metrics_t *self);
 
+extern int od_prom_metrics_write_lifecycle_stat(od_prom_metrics_t *self,
+						const char *user,
+						const char *database,
+						const char *phase,
+						u_int64_t count,
+						u_int64_t p99_time);
+
+extern int od_prom_metrics_write_pool_wait_stat(od_prom_metrics_t *self,
+						const char *user,
+						const char *database,
+						u_int64_t maxwait,
+						u_int64_t wait_timeouts);
+
+extern int od_prom_metrics_write_query_stat(
+	od_prom_metrics_t *self, const char *user, const char *database,
+	u_int64_t fingerprint, u_int64_t calls, u_int64_t time,
+	u_int64_t p99_time, u_int64_t rows, u_int64_t bytes);
+
+extern const char *od_prom_metrics_get_query_stat(od_prom_metrics_t *self);
+
 extern void od_prom_free(void *__ptr);
 
 extern int od_prom_metrics_destroy(od_prom_metrics_t *self);
@@ -10,8 +10,10 @@
 #include <odyssey.h>
 
 machine_msg_t *od_query_do(od_server_t *server, char *context, char *query,
-			   char *param)
+			   char *param, int *empty)
 {
+	if (empty)
+		*empty = 0;
 	od_instance_t *instance = server->global->instance;
 	od_debug(&instance->logger, context, server->client, server, "%s",
 		 query);
@@ -66,6 +68,8 @@ machine_msg_t *od_query_do(od_server_t *server, char *context, char *query,
 					 machine_msg_size(msg));
 
 			machine_msg_free(msg);
+			if (empty && !has_result)
+				*empty = 1;
 			return ret_msg;
 		default:
 			break;
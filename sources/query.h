@@ -7,9 +7,10 @@
  * Scalable PostgreSQL connection pooler.
  */
 
-// execute query with (optional) single string param
+// execute query with (optional) single string param,
+// empty (optional) is set when query succeeded without rows
 extern machine_msg_t *od_query_do(od_server_t *server, char *context,
-				  char *query, char *param);
+				  char *query, char *param, int *empty);
 
 __attribute__((hot)) extern int od_query_format(char *format_pos,
 						char *format_end,
@@ -0,0 +1,461 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+
+static __thread od_query_stats_table_t *od_query_stats_self = NULL;
+
+#define OD_QUERY_STATS_FNV_OFFSET 14695981039346656037ULL
+#define OD_QUERY_STATS_FNV_PRIME 1099511628211ULL
+
+typedef struct {
+	char *dest;
+	int dest_size;
+	int dest_len;
+	uint64_t hash;
+	char last;
+	int space;
+} od_query_stats_norm_t;
+
+static inline void od_query_stats_emit(od_query_stats_norm_t *norm, char c)
+{
+	if (norm->space) {
+		norm->space = 0;
+		if (norm->last != 0)
+			od_query_stats_emit(norm, ' ');
+	}
+	norm->hash = (norm->hash ^ (unsigned char)c) * OD_QUERY_STATS_FNV_PRIME;
+	if (norm->dest_len < norm->dest_size)
+		norm->dest[norm->dest_len++] = c;
+	norm->last = c;
+}
+
+static inline int od_query_stats_is_ident(char c)
+{
+	return isalnum((unsigned char)c) || c == '_' || c == '$' ||
+	       (unsigned char)c >= 0x80;
+}
+
+/* previous output token is an identifier which continues here */
+static inline int od_query_stats_in_ident(od_query_stats_norm_t *norm)
+{
+	return !norm->space && od_query_stats_is_ident(norm->last);
+}
+
+/* skip quoted string starting at pos, returns position after it */
+static inline char *od_query_stats_skip_quoted(char *pos, char *end, char q)
+{
+	pos++;
+	while (pos < end) {
+		if (*pos == q) {
+			/* doubled quote is escaped quote */
+			if (pos + 1 < end && pos[1] == q) {
+				pos += 2;
+				continue;
+			}
+			return pos + 1;
+		}
+		if (*pos == '\\' && q == '\'' && pos + 1 < end) {
+			pos += 2;
+			continue;
+		}
+		pos++;
+	}
+	return end;
+}
+
+/* skip $tag$ ... $tag$, returns NULL if pos is not a dollar quote */
+static inline char *od_query_stats_skip_dollar(char *pos, char *end)
+{
+	char *tag = pos + 1;
+	char *tag_end = tag;
+	while (tag_end < end && *tag_end != '$') {
+		if (!isalpha((unsigned char)*tag_end) && *tag_end != '_')
+			return NULL;
+		tag_end++;
+	}
+	if (tag_end == end)
+		return NULL;
+	int tag_len = tag_end - pos + 1;
+	char *body = tag_end + 1;
+	while (body + tag_len <= end) {
+		if (*body == '$' && memcmp(body, pos, tag_len) == 0)
+			return body + tag_len;
+		body++;
+	}
+	return end;
+}
+
+uint64_t od_query_stats_normalize(char *query, int query_len, char *dest,
+				  int dest_size, int *dest_len)
+{
+	od_query_stats_norm_t norm;
+	norm.dest = dest;
+	norm.dest_size = dest_size;
+	norm.dest_len = 0;
+	norm.hash = OD_QUERY_STATS_FNV_OFFSET;
+	norm.last = 0;
+	norm.space = 0;
+
+	char *pos = query;
+	char *end = query + query_len;
+	/* Parse query text is zero terminated */
+	if (end > pos && end[-1] == 0)
+		end--;
+
+	while (pos < end) {
+		char c = *pos;
+		/* whitespace */
+		if (isspace((unsigned char)c)) {
+			norm.space = 1;
+			pos++;
+			continue;
+		}
+		/* comments */
+		if (c == '-' && pos + 1 < end && pos[1] == '-') {
+			while (pos < end && *pos != '\n')
+				pos++;
+			norm.space = 1;
+			continue;
+		}
+		if (c == '/' && pos + 1 < end && pos[1] == '*') {
+			pos += 2;
+			while (pos + 1 < end && !(pos[0] == '*' && pos[1] == '/'))
+				pos++;
+			pos = (pos + 1 < end) ? pos + 2 : end;
+			norm.space = 1;
+			continue;
+		}
+		/* quoted identifier is kept as is */
+		if (c == '"') {
+			char *next = od_query_stats_skip_quoted(pos, end, '"');
+			for (; pos < next; pos++)
+				od_query_stats_emit(&norm, *pos);
+			continue;
+		}
+		/* string literal, including E'', B'', X'' and N'' */
+		if (c == '\'') {
+			pos = od_query_stats_skip_quoted(pos, end, '\'');
+			od_query_stats_emit(&norm, '?');
+			continue;
+		}
+		if (strchr("eEbBxXnN", c) && pos + 1 < end && pos[1] == '\'' &&
+		    !od_query_stats_in_ident(&norm)) {
+			pos = od_query_stats_skip_quoted(pos + 1, end, '\'');
+			od_query_stats_emit(&norm, '?');
+			continue;
+		}
+		/* dollar quoted literal, $1 parameters are kept */
+		if (c == '$' && !od_query_stats_in_ident(&norm)) {
+			char *next = od_query_stats_skip_dollar(pos, end);
+			if (next) {
+				pos = next;
+				od_query_stats_emit(&norm, '?');
+				continue;
+			}
+		}
+		/* numeric literal */
+		if ((isdigit((unsigned char)c) ||
+		     (c == '.' && pos + 1 < end &&
+		      isdigit((unsigned char)pos[1]))) &&
+		    !od_query_stats_in_ident(&norm)) {
+			while (pos < end) {
+				char n = *pos;
+				if (isalnum((unsigned char)n) || n == '.') {
+					pos++;
+					continue;
+				}
+				/* exponent sign */
+				if ((n == '+' || n == '-') &&
+				    (pos[-1] == 'e' || pos[-1] == 'E')) {
+					pos++;
+					continue;
+				}
+				break;
+			}
+			od_query_stats_emit(&norm, '?');
+			continue;
+		}
+		/* keywords and identifiers are case insensitive */
+		od_query_stats_emit(&norm, tolower((unsigned char)c));
+		pos++;
+	}
+
+	*dest_len = norm.dest_len;
+	return norm.hash;
+}
+
+static int od_query_stats_table_init(od_query_stats_table_t *table,
+				     od_query_stats_t *owner, int size)
+{
+	int hash_size = 16;
+	while (hash_size < size * 2)
+		hash_size *= 2;
+	table->entries = malloc(sizeof(od_query_stats_entry_t) * size);
+	if (table->entries == NULL)
+		return -1;
+	table->hash = malloc(sizeof(int) * hash_size);
+	if (table->hash == NULL) {
+		free(table->entries);
+		table->entries = NULL;
+		return -1;
+	}
+	memset(table->hash, 0xff, sizeof(int) * hash_size);
+	pthread_mutex_init(&table->lock, NULL);
+	table->owner = owner;
+	table->hash_mask = hash_size - 1;
+	table->size = size;
+	table->count = 0;
+	table->evicted = 0;
+	table->next = NULL;
+	return 0;
+}
+
+static void od_query_stats_table_free(od_query_stats_table_t *table)
+{
+	free(table->entries);
+	free(table->hash);
+	table->entries = NULL;
+	table->hash = NULL;
+	pthread_mutex_destroy(&table->lock);
+}
+
+static inline void od_query_stats_table_reset(od_query_stats_table_t *table)
+{
+	memset(table->hash, 0xff, sizeof(int) * (table->hash_mask + 1));
+	table->count = 0;
+}
+
+static inline od_query_stats_entry_t *
+od_query_stats_table_find(od_query_stats_table_t *table, uint64_t fingerprint,
+			  char *user, char *database)
+{
+	int i = table->hash[fingerprint & table->hash_mask];
+	while (i != -1) {
+		od_query_stats_entry_t *entry = &table->entries[i];
+		if (entry->fingerprint == fingerprint &&
+		    strcmp(entry->user, user) == 0 &&
+		    strcmp(entry->database, database) == 0)
+			return entry;
+		i = entry->next;
+	}
+	return NULL;
+}
+
+/* evict entry with the least calls, returns its slot */
+static inline int od_query_stats_table_evict(od_query_stats_table_t *table)
+{
+	int min = 0;
+	int i;
+	for (i = 1; i < table->count; i++) {
+		if (table->entries[i].calls < table->entries[min].calls)
+			min = i;
+	}
+	od_query_stats_entry_t *entry = &table->entries[min];
+	int *link = &table->hash[entry->fingerprint & table->hash_mask];
+	while (*link != min)
+		link = &table->entries[*link].next;
+	*link = entry->next;
+	table->evicted++;
+	return min;
+}
+
+static inline od_query_stats_entry_t *
+od_query_stats_table_insert(od_query_stats_table_t *table, uint64_t fingerprint,
+			    char *user, char *database, char *text,
+			    int text_len)
+{
+	int slot;
+	if (table->count < table->size)
+		slot = table->count++;
+	else
+		slot = od_query_stats_table_evict(table);
+
+	od_query_stats_entry_t *entry = &table->entries[slot];
+	memset(entry, 0, offsetof(od_query_stats_entry_t, text));
+	entry->fingerprint = fingerprint;
+	od_snprintf(entry->user, sizeof(entry->user), "%s", user);
+	od_snprintf(entry->database, sizeof(entry->database), "%s", database);
+	if (text_len > OD_QUERY_STATS_TEXT_MAX)
+		text_len = OD_QUERY_STATS_TEXT_MAX;
+	memcpy(entry->text, text, text_len);
+	entry->text_len = text_len;
+
+	int *head = &table->hash[fingerprint & table->hash_mask];
+	entry->next = *head;
+	*head = slot;
+	return entry;
+}
+
+uint64_t od_query_stats_quantile(od_query_stats_entry_t *entry, double q)
+{
+	return od_hgram_quantile_of(entry->calls, entry->hgram, q);
+}
+
+void od_query_stats_init(od_query_stats_t *stats)
+{
+	stats->size = 0;
+	memset(&stats->global, 0, sizeof(stats->global));
+	pthread_mutex_init(&stats->lock, NULL);
+	stats->list = NULL;
+}
+
+int od_query_stats_set_size(od_query_stats_t *stats, int size)
+{
+	if (size == 0)
+		return 0;
+	int rc;
+	rc = od_query_stats_table_init(&stats->global, stats, size);
+	if (rc == -1)
+		return -1;
+	stats->size = size;
+	return 0;
+}
+
+void od_query_stats_free(od_query_stats_t *stats)
+{
+	od_query_stats_table_t *table = stats->list;
+	while (table) {
+		od_query_stats_table_t *next = table->next;
+		od_query_stats_table_free(table);
+		free(table);
+		table = next;
+	}
+	stats->list = NULL;
+	if (stats->size > 0)
+		od_query_stats_table_free(&stats->global);
+	stats->size = 0;
+	pthread_mutex_destroy(&stats->lock);
+}
+
+static od_query_stats_table_t *od_query_stats_local(od_query_stats_t *stats)
+{
+	od_query_stats_table_t *table = od_query_stats_self;
+	if (od_likely(table && table->owner == stats))
+		return table;
+	table = malloc(sizeof(od_query_stats_table_t));
+	if (table == NULL)
+		return NULL;
+	if (od_query_stats_table_init(table, stats, stats->size) == -1) {
+		free(table);
+		return NULL;
+	}
+	pthread_mutex_lock(&stats->lock);
+	table->next = stats->list;
+	stats->list = table;
+	pthread_mutex_unlock(&stats->lock);
+	od_query_stats_self = table;
+	return table;
+}
+
+void od_query_stats_add(od_query_stats_t *stats, uint64_t fingerprint,
+			char *user, char *database, char *text, int text_len,
+			uint64_t time_us, uint64_t rows, uint64_t bytes)
+{
+	if (stats->size == 0)
+		return;
+	od_query_stats_table_t *table = od_query_stats_local(stats);
+	if (table == NULL)
+		return;
+
+	/* lock is only contended by cron merge */
+	pthread_mutex_lock(&table->lock);
+	od_query_stats_entry_t *entry;
+	entry = od_query_stats_table_find(table, fingerprint, user, database);
+	if (entry == NULL)
+		entry = od_query_stats_table_insert(table, fingerprint, user,
+						    database, text, text_len);
+	entry->calls++;
+	entry->time_us += time_us;
+	entry->rows += rows;
+	entry->bytes += bytes;
+	entry->hgram[od_hgram_bucket(time_us)]++;
+	pthread_mutex_unlock(&table->lock);
+}
+
+static inline void od_query_stats_merge_table(od_query_stats_table_t *global,
+					      od_query_stats_table_t *table)
+{
+	int i;
+	for (i = 0; i < table->count; i++) {
+		od_query_stats_entry_t *entry = &table->entries[i];
+		od_query_stats_entry_t *dest;
+		dest = od_query_stats_table_find(global, entry->fingerprint,
+						 entry->user, entry->database);
+		if (dest == NULL)
+			dest = od_query_stats_table_insert(
+				global, entry->fingerprint, entry->user,
+				entry->database, entry->text, entry->text_len);
+		dest->calls += entry->calls;
+		dest->time_us += entry->time_us;
+		dest->rows += entry->rows;
+		dest->bytes += entry->bytes;
+		int j;
+		for (j = 0; j < OD_HGRAM_BUCKETS; j++)
+			dest->hgram[j] += entry->hgram[j];
+	}
+	global->evicted += table->evicted;
+	table->evicted = 0;
+	od_query_stats_table_reset(table);
+}
+
+void od_query_stats_merge(od_query_stats_t *stats)
+{
+	if (stats->size == 0)
+		return;
+	pthread_mutex_lock(&stats->lock);
+	pthread_mutex_lock(&stats->global.lock);
+	od_query_stats_table_t *table;
+	for (table = stats->list; table; table = table->next) {
+		pthread_mutex_lock(&table->lock);
+		od_query_stats_merge_table(&stats->global, table);
+		pthread_mutex_unlock(&table->lock);
+	}
+	pthread_mutex_unlock(&stats->global.lock);
+	pthread_mutex_unlock(&stats->lock);
+}
+
+static int od_query_stats_cmp(const void *a, const void *b)
+{
+	const od_query_stats_entry_t *ea = *(od_query_stats_entry_t **)a;
+	const od_query_stats_entry_t *eb = *(od_query_stats_entry_t **)b;
+	if (ea->time_us == eb->time_us)
+		return 0;
+	return (ea->time_us < eb->time_us) ? 1 : -1;
+}
+
+/* iterate merged entries, most time consuming first */
+int od_query_stats_foreach(od_query_stats_t *stats,
+			   od_query_stats_cb_t callback, void **argv)
+{
+	if (stats->size == 0)
+		return 0;
+	int rc = 0;
+	pthread_mutex_lock(&stats->global.lock);
+	od_query_stats_table_t *global = &stats->global;
+	od_query_stats_entry_t **sorted;
+	sorted = malloc(sizeof(od_query_stats_entry_t *) * (global->count + 1));
+	if (sorted == NULL) {
+		pthread_mutex_unlock(&global->lock);
+		return -1;
+	}
+	int i;
+	for (i = 0; i < global->count; i++)
+		sorted[i] = &global->entries[i];
+	qsort(sorted, global->count, sizeof(od_query_stats_entry_t *),
+	      od_query_stats_cmp);
+	for (i = 0; i < global->count; i++) {
+		rc = callback(sorted[i], argv);
+		if (rc == -1)
+			break;
+	}
+	free(sorted);
+	pthread_mutex_unlock(&global->lock);
+	return rc;
+}
@@ -0,0 +1,206 @@
+#ifndef ODYSSEY_QUERY_STATS_H
+#define ODYSSEY_QUERY_STATS_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Per normalized query statistics.
+ *
+ * Query text is normalized (literals replaced by '?', comments and
+ * extra whitespace removed, keywords lowercased) and hashed into
+ * a fingerprint. Each worker thread aggregates its samples into own
+ * table, cron merges them into global table once a second.
+ *
+ * Both tables are bounded by the same size: when a new fingerprint
+ * does not fit, entry with the least number of calls is evicted,
+ * so most frequent queries stay.
+ */
+
+#define OD_QUERY_STATS_TEXT_MAX 512
+#define OD_QUERY_STATS_NAME_MAX 64
+#define OD_QUERY_STATS_PIPELINE 16
+
+typedef struct od_query_stats_entry od_query_stats_entry_t;
+typedef struct od_query_stats_table od_query_stats_table_t;
+typedef struct od_query_stats od_query_stats_t;
+typedef struct od_query_stats_stmt od_query_stats_stmt_t;
+typedef struct od_query_stats_exec od_query_stats_exec_t;
+typedef struct od_query_stats_pipeline od_query_stats_pipeline_t;
+
+struct od_query_stats_entry {
+	uint64_t fingerprint;
+	char user[OD_QUERY_STATS_NAME_MAX];
+	char database[OD_QUERY_STATS_NAME_MAX];
+	uint64_t calls;
+	uint64_t time_us;
+	uint64_t rows;
+	uint64_t bytes;
+	uint64_t hgram[OD_HGRAM_BUCKETS];
+	int text_len;
+	char text[OD_QUERY_STATS_TEXT_MAX];
+	int next;
+};
+
+struct od_query_stats_table {
+	pthread_mutex_t lock;
+	od_query_stats_t *owner;
+	od_query_stats_entry_t *entries;
+	int *hash;
+	int hash_mask;
+	int size;
+	int count;
+	uint64_t evicted;
+	od_query_stats_table_t *next;
+};
+
+struct od_query_stats {
+	int size;
+	od_query_stats_table_t global;
+	/* per-thread tables */
+	pthread_mutex_t lock;
+	od_query_stats_table_t *list;
+};
+
+/* normalized statement, kept per client for prepared statements
+ * and portals, only text_len bytes of text are stored */
+struct od_query_stats_stmt {
+	uint64_t fingerprint;
+	int text_len;
+	char text[OD_QUERY_STATS_TEXT_MAX];
+};
+
+typedef enum {
+	OD_QUERY_STATS_EXEC_SIMPLE,
+	OD_QUERY_STATS_EXEC_EXTENDED,
+	OD_QUERY_STATS_EXEC_SYNC
+} od_query_stats_exec_type_t;
+
+/*
+ * Query, Execute or Sync sent to the server and not yet replied.
+ * Execute is complete on CommandComplete, EmptyQueryResponse,
+ * PortalSuspended or ErrorResponse, Query and Sync on ReadyForQuery.
+ * Executes skipped by the server after an error are dropped on
+ * ReadyForQuery.
+ */
+struct od_query_stats_exec {
+	od_query_stats_exec_type_t type;
+	uint64_t start_us;
+	od_query_stats_stmt_t stmt;
+};
+
+struct od_query_stats_pipeline {
+	od_query_stats_exec_t *list;
+	int head;
+	int count;
+};
+
+typedef int (*od_query_stats_cb_t)(od_query_stats_entry_t *, void **);
+
+extern void od_query_stats_init(od_query_stats_t *);
+extern int od_query_stats_set_size(od_query_stats_t *, int);
+extern void od_query_stats_free(od_query_stats_t *);
+extern uint64_t od_query_stats_normalize(char *, int, char *, int, int *);
+extern void od_query_stats_add(od_query_stats_t *, uint64_t, char *, char *,
+			       char *, int, uint64_t, uint64_t, uint64_t);
+extern void od_query_stats_merge(od_query_stats_t *);
+extern int od_query_stats_foreach(od_query_stats_t *, od_query_stats_cb_t,
+				  void **);
+extern uint64_t od_query_stats_quantile(od_query_stats_entry_t *, double);
+
+static inline size_t od_query_stats_stmt_size(od_query_stats_stmt_t *stmt)
+{
+	return offsetof(od_query_stats_stmt_t, text) + stmt->text_len;
+}
+
+static inline void od_query_stats_stmt_set(od_query_stats_stmt_t *stmt,
+					   char *query, int query_len)
+{
+	stmt->fingerprint = od_query_stats_normalize(query, query_len,
+						     stmt->text,
+						     OD_QUERY_STATS_TEXT_MAX,
+						     &stmt->text_len);
+}
+
+static inline void
+od_query_stats_pipeline_init(od_query_stats_pipeline_t *pipeline)
+{
+	pipeline->list = NULL;
+	pipeline->head = 0;
+	pipeline->count = 0;
+}
+
+static inline void
+od_query_stats_pipeline_free(od_query_stats_pipeline_t *pipeline)
+{
+	free(pipeline->list);
+	od_query_stats_pipeline_init(pipeline);
+}
+
+static inline void
+od_query_stats_pipeline_reset(od_query_stats_pipeline_t *pipeline)
+{
+	pipeline->head = 0;
+	pipeline->count = 0;
+}
+
+/* returns slot to fill, NULL if pipeline is too deep to track */
+static inline od_query_stats_exec_t *
+od_query_stats_pipeline_push(od_query_stats_pipeline_t *pipeline,
+			     od_query_stats_exec_type_t type, uint64_t start_us)
+{
+	if (pipeline->list == NULL) {
+		pipeline->list = malloc(sizeof(od_query_stats_exec_t) *
+					OD_QUERY_STATS_PIPELINE);
+		if (pipeline->list == NULL)
+			return NULL;
+	}
+	if (pipeline->count == OD_QUERY_STATS_PIPELINE)
+		return NULL;
+	int pos = (pipeline->head + pipeline->count) % OD_QUERY_STATS_PIPELINE;
+	pipeline->count++;
+	od_query_stats_exec_t *exec = &pipeline->list[pos];
+	exec->type = type;
+	exec->start_us = start_us;
+	exec->stmt.fingerprint = 0;
+	exec->stmt.text_len = 0;
+	return exec;
+}
+
+static inline od_query_stats_exec_t *
+od_query_stats_pipeline_head(od_query_stats_pipeline_t *pipeline)
+{
+	if (pipeline->count == 0)
+		return NULL;
+	return &pipeline->list[pipeline->head];
+}
+
+static inline void od_query_stats_pipeline_pop(od_query_stats_pipeline_t *pipeline)
+{
+	assert(pipeline->count > 0);
+	pipeline->head = (pipeline->head + 1) % OD_QUERY_STATS_PIPELINE;
+	pipeline->count--;
+}
+
+/* number of rows from CommandComplete tag, like 'INSERT 0 5' */
+static inline uint64_t od_query_stats_rows(char *data, int size)
+{
+	char *tag = data + sizeof(kiwi_header_t);
+	char *end = data + size;
+	if (end > tag && end[-1] == 0)
+		end--;
+	char *pos = end;
+	while (pos > tag && isdigit(pos[-1]))
+		pos--;
+	if (pos == end || pos == tag || pos[-1] != ' ')
+		return 0;
+	uint64_t rows = 0;
+	for (; pos < end; pos++)
+		rows = rows * 10 + (*pos - '0');
+	return rows;
+}
+
+#endif /* ODYSSEY_QUERY_STATS_H */
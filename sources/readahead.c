@@ -0,0 +1,78 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+
+/* per worker pool of free buffers, one list per buffer size */
+static __thread od_readahead_pool_t od_readahead_pool;
+
+/* buffers move between threads with their connections, so memory
+ * held by connections is counted process wide */
+static od_atomic_u64_t od_readahead_used = 0;
+
+static inline int od_readahead_pool_class(int size, int create)
+{
+	od_readahead_pool_t *pool = &od_readahead_pool;
+	int i;
+	for (i = 0; i < OD_READAHEAD_POOL_CLASSES; i++) {
+		if (pool->size[i] == size)
+			return i;
+		if (pool->size[i] == 0) {
+			if (!create)
+				return -1;
+			pool->size[i] = size;
+			return i;
+		}
+	}
+	return -1;
+}
+
+char *od_readahead_pool_get(int size)
+{
+	od_readahead_pool_t *pool = &od_readahead_pool;
+	char *buf;
+	int i = od_readahead_pool_class(size, 0);
+	if (i != -1 && pool->count[i] > 0) {
+		/* next free buffer pointer is stored in buffer itself */
+		buf = pool->list[i];
+		memcpy(&pool->list[i], buf, sizeof(char *));
+		pool->count[i]--;
+		pool->cached -= size;
+	} else {
+		buf = malloc(size);
+		if (buf == NULL)
+			return NULL;
+	}
+	od_atomic_u64_add(&od_readahead_used, size);
+	return buf;
+}
+
+void od_readahead_pool_put(char *buf, int size)
+{
+	od_readahead_pool_t *pool = &od_readahead_pool;
+	od_atomic_u64_sub(&od_readahead_used, size);
+	int i = -1;
+	if (size >= (int)sizeof(char *))
+		i = od_readahead_pool_class(size, 1);
+	if (i == -1 || pool->count[i] >= OD_READAHEAD_POOL_MAX) {
+		free(buf);
+		return;
+	}
+	memcpy(buf, &pool->list[i], sizeof(char *));
+	pool->list[i] = buf;
+	pool->count[i]++;
+	pool->cached += size;
+}
+
+/* memory held by all connections and cached by current thread pool */
+void od_readahead_stat(int64_t *used, int64_t *cached)
+{
+	*used = od_atomic_u64_of(&od_readahead_used);
+	*cached = od_readahead_pool.cached;
+}
@@ -7,86 +7,247 @@
  * Scalable PostgreSQL connection pooler.
  */
 
+/*
+ * Readahead buffer is allocated on first read and starts small.
+ * It grows each time a read fills it up (streaming connection),
+ * shrinks back after a number of small reads and is returned
+ * to per-thread pool as soon as everything read is processed,
+ * so idle connections do not hold memory.
+ *
+ * Buffer is used as a ring: socket is read into both free spans
+ * at once and processed data is never moved. Bytes between start
+ * and pos_read are processed but may still be referenced by relay
+ * iov, they are given back by od_readahead_reuse() once written.
+ * Message header wrapped around the ring end is copied into the
+ * tail right after the ring, so it is always seen contiguous.
+ */
+
+#define OD_READAHEAD_SIZE_MIN 1024
+#define OD_READAHEAD_SHRINK_AFTER 16
+#define OD_READAHEAD_POOL_CLASSES 16
+#define OD_READAHEAD_POOL_MAX 256
+#define OD_READAHEAD_TAIL ((int)sizeof(kiwi_header_t))
+
 typedef struct od_readahead od_readahead_t;
+typedef struct od_readahead_pool od_readahead_pool_t;
 
 struct od_readahead {
-	machine_msg_t *buf;
+	char *buf;
 	int size;
+	int size_max;
+	int start;
 	int pos;
 	int pos_read;
+	int used;
+	int unread;
+	int filled;
+	int unfilled;
+};
+
+struct od_readahead_pool {
+	int size[OD_READAHEAD_POOL_CLASSES];
+	char *list[OD_READAHEAD_POOL_CLASSES];
+	int count[OD_READAHEAD_POOL_CLASSES];
+	int64_t cached;
 };
 
+char *od_readahead_pool_get(int);
+void od_readahead_pool_put(char *, int);
+void od_readahead_stat(int64_t *, int64_t *);
+
+static inline void od_readahead_reset(od_readahead_t *readahead)
+{
+	readahead->start = 0;
+	readahead->pos = 0;
+	readahead->pos_read = 0;
+	readahead->used = 0;
+	readahead->unread = 0;
+}
+
 static inline void od_readahead_init(od_readahead_t *readahead)
 {
 	readahead->buf = NULL;
 	readahead->size = 0;
-	readahead->pos = 0;
-	readahead->pos_read = 0;
+	readahead->size_max = 0;
+	readahead->filled = 0;
+	readahead->unfilled = 0;
+	od_readahead_reset(readahead);
 }
 
 static inline void od_readahead_free(od_readahead_t *readahead)
 {
-	if (readahead->buf)
-		machine_msg_free(readahead->buf);
+	if (readahead->buf) {
+		od_readahead_pool_put(readahead->buf,
+				      readahead->size + OD_READAHEAD_TAIL);
+		readahead->buf = NULL;
+	}
 }
 
 static inline int od_readahead_prepare(od_readahead_t *readahead, int size)
 {
+	readahead->size_max = size;
 	readahead->size = size;
-	readahead->buf = machine_msg_create(size);
+	if (readahead->size > OD_READAHEAD_SIZE_MIN)
+		readahead->size = OD_READAHEAD_SIZE_MIN;
+	return 0;
+}
+
+static inline int od_readahead_ensure(od_readahead_t *readahead)
+{
+	if (readahead->buf)
+		return 0;
+	readahead->buf =
+		od_readahead_pool_get(readahead->size + OD_READAHEAD_TAIL);
 	if (readahead->buf == NULL)
 		return -1;
+	readahead->filled = 0;
+	od_readahead_reset(readahead);
 	return 0;
 }
 
 static inline int od_readahead_left(od_readahead_t *readahead)
 {
 	assert(readahead->buf);
-	return readahead->size - readahead->pos;
+	return readahead->size - readahead->used;
 }
 
 static inline int od_readahead_unread(od_readahead_t *readahead)
 {
-	return readahead->pos - readahead->pos_read;
+	return readahead->unread;
 }
 
-static inline char *od_readahead_pos(od_readahead_t *readahead)
+static inline char *od_readahead_pos_read(od_readahead_t *readahead)
 {
-	return (char *)machine_msg_data(readahead->buf) + readahead->pos;
+	return readahead->buf + readahead->pos_read;
 }
 
-static inline char *od_readahead_pos_read(od_readahead_t *readahead)
+/* fill iov with free spans of the ring, returns number of spans */
+static inline int od_readahead_iov(od_readahead_t *readahead,
+				   struct iovec *iov)
+{
+	assert(readahead->buf);
+	if (readahead->used == readahead->size)
+		return 0;
+	if (readahead->pos < readahead->start) {
+		iov[0].iov_base = readahead->buf + readahead->pos;
+		iov[0].iov_len = readahead->start - readahead->pos;
+		return 1;
+	}
+	iov[0].iov_base = readahead->buf + readahead->pos;
+	iov[0].iov_len = readahead->size - readahead->pos;
+	if (readahead->start == 0)
+		return 1;
+	iov[1].iov_base = readahead->buf;
+	iov[1].iov_len = readahead->start;
+	return 2;
+}
+
+/* size of unread data available contiguously at pos_read */
+static inline int od_readahead_read_span(od_readahead_t *readahead)
 {
-	return (char *)machine_msg_data(readahead->buf) + readahead->pos_read;
+	int span = readahead->size - readahead->pos_read;
+	if (span >= readahead->unread)
+		return readahead->unread;
+	if (span >= OD_READAHEAD_TAIL)
+		return span;
+
+	/* header is wrapped, copy its beginning into the tail */
+	int wrapped = OD_READAHEAD_TAIL - span;
+	if (wrapped > readahead->unread - span)
+		wrapped = readahead->unread - span;
+	memcpy(readahead->buf + readahead->size, readahead->buf, wrapped);
+	return span + wrapped;
 }
 
 static inline void od_readahead_pos_advance(od_readahead_t *readahead,
 					    int value)
 {
 	readahead->pos += value;
+	if (readahead->pos >= readahead->size)
+		readahead->pos -= readahead->size;
+	readahead->used += value;
+	readahead->unread += value;
+	if (readahead->used == readahead->size)
+		readahead->filled = 1;
 }
 
 static inline void od_readahead_pos_read_advance(od_readahead_t *readahead,
 						 int value)
 {
 	readahead->pos_read += value;
+	if (readahead->pos_read >= readahead->size)
+		readahead->pos_read -= readahead->size;
+	readahead->unread -= value;
 }
 
-static inline void od_readahead_reuse(od_readahead_t *readahead)
+static inline void od_readahead_release(od_readahead_t *readahead)
 {
-	size_t unread = od_readahead_unread(readahead);
-	if (unread > sizeof(sizeof(kiwi_header_t)))
+	if (readahead->buf == NULL)
 		return;
-	if (unread == 0) {
-		readahead->pos = 0;
-		readahead->pos_read = 0;
+	if (od_readahead_unread(readahead) > 0)
+		return;
+	od_readahead_pool_put(readahead->buf,
+			      readahead->size + OD_READAHEAD_TAIL);
+	readahead->buf = NULL;
+	od_readahead_reset(readahead);
+
+	/* choose size for the next allocation */
+	if (readahead->filled) {
+		readahead->unfilled = 0;
+		readahead->size *= 2;
+		if (readahead->size > readahead->size_max)
+			readahead->size = readahead->size_max;
 		return;
 	}
-	/* save next packet header */
-	char *data = machine_msg_data(readahead->buf);
-	memmove(data, data + readahead->pos_read, unread);
+	if (++readahead->unfilled < OD_READAHEAD_SHRINK_AFTER)
+		return;
+	readahead->unfilled = 0;
+	if (readahead->size / 2 >= OD_READAHEAD_SIZE_MIN)
+		readahead->size /= 2;
+}
+
+static inline int od_readahead_grow(od_readahead_t *readahead)
+{
+	int size = readahead->size * 2;
+	if (size > readahead->size_max)
+		size = readahead->size_max;
+	char *buf = od_readahead_pool_get(size + OD_READAHEAD_TAIL);
+	if (buf == NULL)
+		return -1;
+	int unread = readahead->unread;
+	int span = readahead->size - readahead->pos_read;
+	if (span > unread)
+		span = unread;
+	memcpy(buf, readahead->buf + readahead->pos_read, span);
+	memcpy(buf + span, readahead->buf, unread - span);
+	od_readahead_pool_put(readahead->buf,
+			      readahead->size + OD_READAHEAD_TAIL);
+	readahead->buf = buf;
+	readahead->size = size;
+	readahead->filled = 0;
+	od_readahead_reset(readahead);
 	readahead->pos = unread;
-	readahead->pos_read = 0;
+	readahead->used = unread;
+	readahead->unread = unread;
+	return 0;
+}
+
+/* processed data is not referenced anymore */
+static inline void od_readahead_reuse(od_readahead_t *readahead)
+{
+	if (readahead->buf == NULL)
+		return;
+	/* buffer was filled up, streaming data expected */
+	if (readahead->filled && readahead->size < readahead->size_max) {
+		if (od_readahead_grow(readahead) == 0)
+			return;
+	}
+	if (readahead->unread == 0) {
+		od_readahead_reset(readahead);
+		return;
+	}
+	readahead->start = readahead->pos_read;
+	readahead->used = readahead->unread;
 }
 
 #endif /* ODYSSEY_READAHEAD_H */
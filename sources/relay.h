@@ -16,6 +16,8 @@ typedef struct od_relay od_relay_t;
 typedef od_frontend_status_t (*od_relay_on_packet_t)(od_relay_t *, char *data,
 						     int size);
 typedef void (*od_relay_on_read_t)(od_relay_t *, int size);
+typedef void (*od_relay_on_buffered_t)(od_relay_t *, int delta);
+typedef int (*od_relay_on_bulk_t)(od_relay_t *);
 
 struct od_relay {
 	int packet;
@@ -24,7 +26,21 @@ struct od_relay {
 
 	machine_msg_t *packet_full;
 	int packet_full_pos;
+	/* beginning of a streamed message, collected until
+	 * fields required by on_packet are read */
+	machine_msg_t *packet_head;
 	machine_iov_t *iov;
+	/* constant messages queued while a message is relayed,
+	 * they follow it once it is complete */
+	machine_msg_t *deferred;
+	/* zero-copy path for large pass-through messages */
+	machine_splice_t *splice;
+	int splice_threshold;
+	/* bytes queued for write, source is not read above the limit */
+	int buffered;
+	int buffer_limit;
+	int message_limit;
+	od_relay_on_buffered_t on_buffered;
 	machine_cond_t *base;
 	od_io_t *src;
 	od_io_t *dst;
@@ -34,6 +50,10 @@ struct od_relay {
 	void *on_packet_arg;
 	od_relay_on_read_t on_read;
 	void *on_read_arg;
+	/* runs of complete messages of these types are queued as one
+	 * iovec without calling on_packet, while on_bulk allows it */
+	const uint8_t *bulk_types;
+	od_relay_on_bulk_t on_bulk;
 };
 
 static inline od_frontend_status_t od_relay_read(od_relay_t *relay);
@@ -44,7 +64,15 @@ static inline void od_relay_init(od_relay_t *relay, od_io_t *io)
 	relay->packet_skip = 0;
 	relay->packet_full = NULL;
 	relay->packet_full_pos = 0;
+	relay->packet_head = NULL;
 	relay->iov = NULL;
+	relay->deferred = NULL;
+	relay->splice = NULL;
+	relay->splice_threshold = 0;
+	relay->buffered = 0;
+	relay->buffer_limit = 0;
+	relay->message_limit = 0;
+	relay->on_buffered = NULL;
 	relay->base = NULL;
 	relay->src = io;
 	relay->dst = NULL;
@@ -54,6 +82,8 @@ static inline void od_relay_init(od_relay_t *relay, od_io_t *io)
 	relay->on_packet_arg = NULL;
 	relay->on_read = NULL;
 	relay->on_read_arg = NULL;
+	relay->bulk_types = NULL;
+	relay->on_bulk = NULL;
 }
 
 static inline void od_relay_free(od_relay_t *relay)
@@ -62,16 +92,26 @@ static inline void od_relay_free(od_relay_t *relay)
 		machine_msg_free(relay->packet_full);
 	}
 
+	if (relay->packet_head) {
+		machine_msg_free(relay->packet_head);
+	}
+
 	if (relay->iov) {
 		machine_iov_free(relay->iov);
 	}
+
+	if (relay->deferred) {
+		machine_msg_free(relay->deferred);
+	}
+
+	if (relay->splice) {
+		machine_splice_free(relay->splice);
+	}
 }
 
 static inline bool od_relay_data_pending(od_relay_t *relay)
 {
-	char *current = od_readahead_pos_read(&relay->src->readahead);
-	char *end = od_readahead_pos(&relay->src->readahead);
-	return current < end;
+	return od_readahead_unread(&relay->src->readahead) > 0;
 }
 
 static inline od_frontend_status_t
@@ -136,8 +176,29 @@ static inline void od_relay_detach(od_relay_t *relay)
 	relay->dst = NULL;
 }
 
+static inline void od_relay_account(od_relay_t *relay)
+{
+	int buffered = 0;
+	if (relay->iov)
+		buffered += machine_iov_size(relay->iov);
+	if (relay->packet_full)
+		buffered += machine_msg_size(relay->packet_full);
+	if (relay->packet_head)
+		buffered += machine_msg_size(relay->packet_head);
+	if (relay->deferred)
+		buffered += machine_msg_size(relay->deferred);
+	if (buffered == relay->buffered)
+		return;
+	if (relay->on_buffered)
+		relay->on_buffered(relay, buffered - relay->buffered);
+	relay->buffered = buffered;
+}
+
 static inline int od_relay_stop(od_relay_t *relay)
 {
+	if (relay->buffered > 0 && relay->on_buffered)
+		relay->on_buffered(relay, -relay->buffered);
+	relay->buffered = 0;
 	od_relay_detach(relay);
 	od_io_read_stop(relay->src);
 	return 0;
@@ -156,6 +217,35 @@ static inline int od_relay_full_packet_required(char *data)
 	return 0;
 }
 
+/*
+ * Bind may carry megabytes of parameters, while on_packet only
+ * needs portal and statement names. Such message is passed to
+ * on_packet as soon as its head is read and the rest is streamed.
+ */
+#define OD_RELAY_PACKET_HEAD_MAX 4096
+
+static inline int od_relay_head_required(char *data)
+{
+	kiwi_header_t *header;
+	header = (kiwi_header_t *)data;
+	return header->type == KIWI_FE_BIND;
+}
+
+static inline int od_relay_head_complete(char *data, int size)
+{
+	/* portal and statement names */
+	char *pos = data + sizeof(kiwi_header_t);
+	char *end = data + size;
+	int i;
+	for (i = 0; i < 2; i++) {
+		pos = memchr(pos, 0, end - pos);
+		if (pos == NULL)
+			return 0;
+		pos++;
+	}
+	return 1;
+}
+
 static inline od_frontend_status_t od_relay_on_packet_msg(od_relay_t *relay,
 							  machine_msg_t *msg)
 {
@@ -210,6 +300,90 @@ static inline od_frontend_status_t od_relay_on_packet(od_relay_t *relay,
 	return status;
 }
 
+/* on_packet returns OD_SKIP when it has queued a replacement
+ * for the head, rest of the message is still forwarded */
+static inline od_frontend_status_t
+od_relay_on_packet_head(od_relay_t *relay, char *data, int size)
+{
+	int rc;
+	od_frontend_status_t status;
+	status = relay->on_packet(relay, data, size);
+
+	switch (status) {
+	case OD_OK:
+		rc = machine_iov_add_pointer(relay->iov, data, size);
+		if (rc == -1)
+			return OD_EOOM;
+		break;
+	case OD_SKIP:
+		status = OD_OK;
+		break;
+	default:
+		break;
+	}
+
+	return status;
+}
+
+static inline od_frontend_status_t
+od_relay_on_packet_head_msg(od_relay_t *relay, machine_msg_t *msg)
+{
+	int rc;
+	od_frontend_status_t status;
+	char *data = machine_msg_data(msg);
+	int size = machine_msg_size(msg);
+
+	status = relay->on_packet(relay, data, size);
+
+	switch (status) {
+	case OD_OK:
+		rc = machine_iov_add(relay->iov, msg);
+		if (rc == -1)
+			return OD_EOOM;
+		break;
+	case OD_SKIP:
+		status = OD_OK;
+	/* fallthrough */
+	default:
+		machine_msg_free(msg);
+		break;
+	}
+	return status;
+}
+
+static inline od_frontend_status_t od_relay_head_full(od_relay_t *relay)
+{
+	/* head is too long or message is malformed,
+	 * buffer the whole message instead */
+	machine_msg_t *head = relay->packet_head;
+	int head_size = machine_msg_size(head);
+	int total = head_size + relay->packet;
+	relay->packet_head = NULL;
+
+	if (relay->message_limit > 0 && total > relay->message_limit) {
+		machine_msg_free(head);
+		return OD_EMESSAGE_LIMIT;
+	}
+
+	relay->packet_full = machine_msg_create(total);
+	if (relay->packet_full == NULL) {
+		machine_msg_free(head);
+		return OD_EOOM;
+	}
+	memcpy(machine_msg_data(relay->packet_full), machine_msg_data(head),
+	       head_size);
+	relay->packet_full_pos = head_size;
+	machine_msg_free(head);
+
+	if (relay->packet > 0)
+		return OD_OK;
+
+	machine_msg_t *msg = relay->packet_full;
+	relay->packet_full = NULL;
+	relay->packet_full_pos = 0;
+	return od_relay_on_packet_msg(relay, msg);
+}
+
 __attribute__((hot)) static inline od_frontend_status_t
 od_relay_process(od_relay_t *relay, int *progress, char *data, int size)
 {
@@ -239,10 +413,30 @@ od_relay_process(od_relay_t *relay, int *progress, char *data, int size)
 		relay->packet = total - size;
 		relay->packet_skip = 0;
 
+		if (od_relay_head_required(data)) {
+			if (od_relay_head_complete(data, size))
+				return od_relay_on_packet_head(relay, data,
+							       size);
+			if (size < OD_RELAY_PACKET_HEAD_MAX) {
+				relay->packet_head = machine_msg_create(0);
+				if (relay->packet_head == NULL)
+					return OD_EOOM;
+				rc = machine_msg_write(relay->packet_head, data,
+						       size);
+				if (rc == -1)
+					return OD_EOOM;
+				return OD_OK;
+			}
+		}
+
 		rc = od_relay_full_packet_required(data);
 		if (!rc)
 			return od_relay_on_packet(relay, data, size);
 
+		/* message has to be buffered as a whole */
+		if (relay->message_limit > 0 && total > relay->message_limit)
+			return OD_EMESSAGE_LIMIT;
+
 		relay->packet_full = machine_msg_create(total);
 		if (relay->packet_full == NULL)
 			return OD_EOOM;
@@ -257,9 +451,33 @@ od_relay_process(od_relay_t *relay, int *progress, char *data, int size)
 	int to_parse = relay->packet;
 	if (to_parse > size)
 		to_parse = size;
+	if (relay->packet_head) {
+		/* collect no more than required */
+		machine_msg_t *head = relay->packet_head;
+		int head_left =
+			OD_RELAY_PACKET_HEAD_MAX - machine_msg_size(head);
+		if (to_parse > head_left)
+			to_parse = head_left;
+	}
 	*progress = to_parse;
 	relay->packet -= to_parse;
 
+	if (relay->packet_head) {
+		machine_msg_t *head = relay->packet_head;
+		rc = machine_msg_write(head, data, to_parse);
+		if (rc == -1)
+			return OD_EOOM;
+		if (od_relay_head_complete(machine_msg_data(head),
+					   machine_msg_size(head))) {
+			relay->packet_head = NULL;
+			return od_relay_on_packet_head_msg(relay, head);
+		}
+		if (relay->packet == 0 ||
+		    machine_msg_size(head) >= OD_RELAY_PACKET_HEAD_MAX)
+			return od_relay_head_full(relay);
+		return OD_OK;
+	}
+
 	if (relay->packet_full) {
 		char *dest;
 		dest = machine_msg_data(relay->packet_full);
@@ -284,16 +502,80 @@ od_relay_process(od_relay_t *relay, int *progress, char *data, int size)
 	return OD_OK;
 }
 
+/* find the longest run of complete messages which on_packet passes
+ * as is, headers are chained by length so the scan is sequential */
+static inline int od_relay_bulk_run(od_relay_t *relay, char *data, int size)
+{
+	const uint8_t *types = relay->bulk_types;
+	int pos = 0;
+	while (size - pos >= (int)sizeof(kiwi_header_t)) {
+		char *header = data + pos;
+		if (!types[(uint8_t)*header])
+			break;
+		uint32_t len;
+		len = kiwi_read_size(header, sizeof(kiwi_header_t));
+		/* malformed header is reported by the regular path */
+		if (len < sizeof(uint32_t) || len >= KIWI_LONG_MESSAGE_SIZE)
+			break;
+		if ((int)len >= size - pos)
+			break;
+		pos += 1 + len;
+	}
+	return pos;
+}
+
+static inline int od_relay_bulk(od_relay_t *relay, char *data, int size)
+{
+	if (relay->bulk_types == NULL || relay->packet > 0)
+		return 0;
+	if (!relay->on_bulk(relay))
+		return 0;
+	int run = od_relay_bulk_run(relay, data, size);
+	if (run == 0)
+		return 0;
+	int rc;
+	rc = machine_iov_add_pointer(relay->iov, data, run);
+	if (rc == -1)
+		return -1;
+	return run;
+}
+
+static inline int od_relay_in_packet(od_relay_t *relay)
+{
+	return relay->packet > 0 || relay->packet_full != NULL ||
+	       relay->packet_head != NULL;
+}
+
+static inline int od_relay_flush_deferred(od_relay_t *relay)
+{
+	if (relay->deferred == NULL || od_relay_in_packet(relay))
+		return 0;
+	machine_msg_t *msg = relay->deferred;
+	relay->deferred = NULL;
+	return machine_iov_add(relay->iov, msg);
+}
+
 static inline od_frontend_status_t od_relay_pipeline(od_relay_t *relay)
 {
-	char *current = od_readahead_pos_read(&relay->src->readahead);
-	char *end = od_readahead_pos(&relay->src->readahead);
-	while (current < end) {
+	od_readahead_t *readahead = &relay->src->readahead;
+	for (;;) {
+		int size = od_readahead_read_span(readahead);
+		if (size == 0)
+			break;
+		char *data = od_readahead_pos_read(readahead);
 		int progress;
+		progress = od_relay_bulk(relay, data, size);
+		if (progress == -1)
+			return OD_EOOM;
+		if (progress > 0) {
+			od_readahead_pos_read_advance(readahead, progress);
+			continue;
+		}
 		od_frontend_status_t rc;
-		rc = od_relay_process(relay, &progress, current, end - current);
-		current += progress;
-		od_readahead_pos_read_advance(&relay->src->readahead, progress);
+		rc = od_relay_process(relay, &progress, data, size);
+		od_readahead_pos_read_advance(readahead, progress);
+		if (od_relay_flush_deferred(relay) == -1)
+			return OD_EOOM;
 		if (rc != OD_OK) {
 			if (rc == OD_UNDEF)
 				rc = OD_OK;
@@ -305,31 +587,135 @@ static inline od_frontend_status_t od_relay_pipeline(od_relay_t *relay)
 
 static inline od_frontend_status_t od_relay_read(od_relay_t *relay)
 {
-	int to_read;
-	to_read = od_readahead_left(&relay->src->readahead);
-	if (to_read == 0)
-		return OD_OK;
+	/* in edge-triggered mode socket is drained until EAGAIN
+	 * or readahead is full, otherwise single read is enough */
+	int drain = machine_edge_triggered(relay->src->io);
+	int total = 0;
+
+	if (od_readahead_ensure(&relay->src->readahead) == -1)
+		return OD_EOOM;
+	for (;;) {
+		struct iovec iov[2];
+		int iovc;
+		iovc = od_readahead_iov(&relay->src->readahead, iov);
+		if (iovc == 0)
+			break;
+
+		int rc;
+		rc = machine_readv_raw(relay->src->io, iov, iovc);
+		if (rc <= 0) {
+			/* retry */
+			int errno_ = machine_errno();
+			if (errno_ == EAGAIN || errno_ == EWOULDBLOCK ||
+			    errno_ == EINTR)
+				break;
+			/* error or eof, process already read data first */
+			if (total > 0)
+				break;
+			return relay->error_read;
+		}
+
+		od_readahead_pos_advance(&relay->src->readahead, rc);
+		total += rc;
+
+		if (!drain)
+			break;
+	}
+
+	/* update recv stats */
+	if (total > 0)
+		relay->on_read(relay, total);
+
+	return OD_OK;
+}
+
+static inline int od_relay_splice_pending(od_relay_t *relay)
+{
+	return relay->splice && machine_splice_pending(relay->splice) > 0;
+}
+
+static inline int od_relay_write_pending(od_relay_t *relay)
+{
+	return machine_iov_pending(relay->iov) || od_relay_splice_pending(relay);
+}
 
-	char *pos;
-	pos = od_readahead_pos(&relay->src->readahead);
+/* queue constant message behind relayed ones, a message which is
+ * relayed only partially is completed first, returns 0 when relay
+ * is not attached */
+static inline int od_relay_write_bytes(od_relay_t *relay, const char *data,
+				       int size)
+{
+	if (relay->iov == NULL || relay->dst == NULL)
+		return 0;
 
 	int rc;
-	rc = machine_read_raw(relay->src->io, pos, to_read);
+	if (od_relay_in_packet(relay)) {
+		if (relay->deferred == NULL) {
+			relay->deferred = machine_msg_create(0);
+			if (relay->deferred == NULL)
+				return -1;
+		}
+		rc = machine_msg_write(relay->deferred, (void *)data, size);
+		if (rc == -1)
+			return -1;
+		return 1;
+	}
+
+	rc = machine_iov_add_pointer(relay->iov, (void *)data, size);
+	if (rc == -1)
+		return -1;
+	machine_cond_signal(relay->dst->on_write);
+	return 1;
+}
+
+static inline int od_relay_splice_possible(od_relay_t *relay)
+{
+	if (relay->splice_threshold == 0)
+		return 0;
+
+	/* only the rest of a large message which is passed as is */
+	if (relay->packet < relay->splice_threshold ||
+	    relay->packet_full != NULL || relay->packet_head != NULL ||
+	    relay->packet_skip)
+		return 0;
+
+	/* everything read before must be written first */
+	if (od_readahead_unread(&relay->src->readahead) > 0 ||
+	    machine_iov_pending(relay->iov))
+		return 0;
+
+	return machine_splice_supported(relay->src->io) &&
+	       machine_splice_supported(relay->dst->io);
+}
+
+static inline od_frontend_status_t od_relay_splice_read(od_relay_t *relay)
+{
+	if (relay->splice == NULL) {
+		relay->splice = machine_splice_create();
+		if (relay->splice == NULL)
+			return OD_EOOM;
+	}
+
+	int rc;
+	rc = machine_splice_read(relay->splice, relay->src->io, relay->packet);
 	if (rc <= 0) {
 		/* retry */
 		int errno_ = machine_errno();
-		if (errno_ == EAGAIN || errno_ == EWOULDBLOCK ||
-		    errno_ == EINTR)
+		if (rc == -1 && (errno_ == EAGAIN || errno_ == EWOULDBLOCK ||
+				 errno_ == EINTR))
 			return OD_OK;
 		/* error or eof */
 		return relay->error_read;
 	}
 
-	od_readahead_pos_advance(&relay->src->readahead, rc);
+	relay->packet -= rc;
 
 	/* update recv stats */
 	relay->on_read(relay, rc);
 
+	if (od_relay_flush_deferred(relay) == -1)
+		return OD_EOOM;
+
 	return OD_OK;
 }
 
@@ -337,10 +723,25 @@ static inline od_frontend_status_t od_relay_write(od_relay_t *relay)
 {
 	assert(relay->dst);
 
+	int rc;
+	if (od_relay_splice_pending(relay)) {
+		rc = machine_splice_write(relay->splice, relay->dst->io);
+		if (rc < 0) {
+			/* retry or error */
+			int errno_ = machine_errno();
+			if (errno_ == EAGAIN || errno_ == EWOULDBLOCK ||
+			    errno_ == EINTR)
+				return OD_OK;
+			return relay->error_write;
+		}
+		/* keep message order */
+		if (od_relay_splice_pending(relay))
+			return OD_OK;
+	}
+
 	if (!machine_iov_pending(relay->iov))
 		return OD_OK;
 
-	int rc;
 	rc = machine_writev_raw(relay->dst->io, relay->iov);
 	if (rc < 0) {
 		/* retry or error */
@@ -354,6 +755,16 @@ static inline od_frontend_status_t od_relay_write(od_relay_t *relay)
 	return OD_OK;
 }
 
+static inline void od_relay_reuse(od_relay_t *relay)
+{
+	/* everything is processed, buffer is not needed until next read */
+	if (od_readahead_unread(&relay->src->readahead) == 0) {
+		od_readahead_release(&relay->src->readahead);
+		return;
+	}
+	od_readahead_reuse(&relay->src->readahead);
+}
+
 static inline od_frontend_status_t od_relay_step(od_relay_t *relay)
 {
 	/* on read event */
@@ -365,20 +776,43 @@ static inline od_frontend_status_t od_relay_step(od_relay_t *relay)
 			return OD_ATTACH;
 		}
 
-		rc = od_relay_read(relay);
-		if (rc != OD_OK)
-			return rc;
+		if (od_relay_splice_possible(relay)) {
+			rc = od_relay_splice_read(relay);
+		} else {
+			rc = od_relay_read(relay);
+			if (rc != OD_OK)
+				return rc;
 
-		rc = od_relay_pipeline(relay);
+			rc = od_relay_pipeline(relay);
+		}
 
 		if (rc != OD_OK)
 			return rc;
 
-		if (machine_iov_pending(relay->iov)) {
+		od_relay_account(relay);
+
+		if (od_relay_write_pending(relay)) {
 			/* try to optimize write path and handle it right-away */
 			machine_cond_signal(relay->dst->on_write);
+
+			/* backpressure: stop reading until destination
+			 * drains, reading is restarted on write completion */
+			if (relay->buffer_limit > 0 &&
+			    relay->buffered >= relay->buffer_limit) {
+				rc = od_io_read_stop(relay->src);
+				if (rc == -1)
+					return relay->error_read;
+			}
 		} else {
-			od_readahead_reuse(&relay->src->readahead);
+			od_relay_reuse(relay);
+
+			/* edge-triggered socket may still hold data which
+			 * did not fit into readahead, restart reports it */
+			if (machine_edge_triggered(relay->src->io)) {
+				rc = od_io_read_start(relay->src);
+				if (rc == -1)
+					return relay->error_read;
+			}
 		}
 	}
 
@@ -391,12 +825,14 @@ static inline od_frontend_status_t od_relay_step(od_relay_t *relay)
 		if (rc != OD_OK)
 			return rc;
 
-		if (!machine_iov_pending(relay->iov)) {
+		od_relay_account(relay);
+
+		if (!od_relay_write_pending(relay)) {
 			rc = od_io_write_stop(relay->dst);
 			if (rc == -1)
 				return relay->error_write;
 
-			od_readahead_reuse(&relay->src->readahead);
+			od_relay_reuse(relay);
 
 			rc = od_io_read_start(relay->src);
 			if (rc == -1)
@@ -416,7 +852,7 @@ static inline od_frontend_status_t od_relay_flush(od_relay_t *relay)
 	if (relay->dst == NULL)
 		return OD_OK;
 
-	if (!machine_iov_pending(relay->iov))
+	if (!od_relay_write_pending(relay))
 		return OD_OK;
 
 	int rc;
@@ -424,15 +860,17 @@ static inline od_frontend_status_t od_relay_flush(od_relay_t *relay)
 	if (rc != OD_OK)
 		return rc;
 
-	if (!machine_iov_pending(relay->iov))
+	if (!od_relay_write_pending(relay)) {
+		od_relay_account(relay);
 		return OD_OK;
+	}
 
 	rc = od_io_write_start(relay->dst);
 	if (rc == -1)
 		return relay->error_write;
 
 	for (;;) {
-		if (!machine_iov_pending(relay->iov))
+		if (!od_relay_write_pending(relay))
 			break;
 
 		machine_cond_wait(relay->dst->on_write, UINT32_MAX);
@@ -444,6 +882,8 @@ static inline od_frontend_status_t od_relay_flush(od_relay_t *relay)
 		}
 	}
 
+	od_relay_account(relay);
+
 	rc = od_io_write_stop(relay->dst);
 	if (rc == -1)
 		return relay->error_write;
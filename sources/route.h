@@ -25,6 +25,8 @@ struct od_route {
 #endif
 
 	kiwi_params_lock_t params;
+	/* od_router_params_t, guarded by router lock */
+	struct od_router_params *params_saved;
 	int64_t tcp_connections;
 	int last_heartbeat;
 	machine_channel_t *wait_bus;
@@ -33,6 +35,17 @@ struct od_route {
 	od_error_logger_t *err_logger;
 	bool extra_logging_enabled;
 
+	/* query log sampling and rate limit */
+	od_atomic_u64_t log_query_tx;
+	od_atomic_u64_t log_query_tokens;
+	od_atomic_u64_t log_query_refill;
+
+	/* connection lifecycle phases */
+	od_lifecycle_t lifecycle;
+
+	/* clients which did not get server within pool_timeout */
+	od_atomic_u64_t wait_timeouts;
+
 	od_list_t link;
 };
 
@@ -61,9 +74,16 @@ static inline void od_route_init(od_route_t *route, bool extra_route_logging)
 		route->err_logger = NULL;
 	}
 
+	route->log_query_tx = 0;
+	route->log_query_tokens = 0;
+	route->log_query_refill = 0;
+	od_lifecycle_init(&route->lifecycle);
+	route->wait_timeouts = 0;
+
 	od_stat_init(&route->stats);
 	od_stat_init(&route->stats_prev);
 	kiwi_params_lock_init(&route->params);
+	route->params_saved = NULL;
 	od_list_init(&route->link);
 	route->wait_bus = NULL;
 	pthread_mutex_init(&route->lock, NULL);
@@ -127,6 +147,24 @@ static inline int od_route_match_compare_client_cb(od_client_t *client,
 	return od_id_cmp(&client->id, argv[0]);
 }
 
+static inline int od_route_maxwait_cb(od_client_t *client, void **argv)
+{
+	uint64_t *oldest = argv[0];
+	if (client->time_queue && client->time_queue < *oldest)
+		*oldest = client->time_queue;
+	return 0;
+}
+
+/* wait time of the oldest queued client, route must be locked */
+static inline uint64_t od_route_maxwait(od_route_t *route, uint64_t now)
+{
+	uint64_t oldest = now;
+	void *argv[] = { &oldest };
+	od_client_pool_foreach(&route->client_pool, OD_CLIENT_QUEUE,
+			       od_route_maxwait_cb, argv);
+	return now - oldest;
+}
+
 static inline od_client_t *od_route_match_client(od_route_t *route, od_id_t *id)
 {
 	void *argv[] = { id };
@@ -224,4 +262,46 @@ static inline int od_route_signal(od_route_t *route)
 	return 0;
 }
 
+/* decided once per transaction: log 1 of log_query_sample */
+static inline int od_route_log_query_sample(od_route_t *route)
+{
+	int sample = route->rule->log_query_sample;
+	if (sample <= 1)
+		return 1;
+	return od_atomic_u64_inc(&route->log_query_tx) % sample == 0;
+}
+
+/* token bucket of log_query_rate lines per second, shared by workers */
+static inline int od_route_log_query_take(od_route_t *route)
+{
+	int64_t rate = route->rule->log_query_rate;
+	if (rate <= 0)
+		return 1;
+
+	uint64_t now = machine_time_us();
+	uint64_t last = od_atomic_u64_of(&route->log_query_refill);
+	int64_t refill = rate;
+	if (now - last < 1000000)
+		refill = (now - last) * rate / 1000000;
+	if (refill > 0 &&
+	    __sync_bool_compare_and_swap(&route->log_query_refill, last, now)) {
+		/* tokens may go below zero for a moment, so signed */
+		int64_t tokens;
+		tokens = od_atomic_u64_add(&route->log_query_tokens, refill);
+		/* bucket size is one second of lines */
+		if (tokens > rate)
+			od_atomic_u64_sub(&route->log_query_tokens,
+					  tokens - rate);
+	}
+
+	for (;;) {
+		int64_t tokens = od_atomic_u64_of(&route->log_query_tokens);
+		if (tokens <= 0)
+			return 0;
+		if (__sync_bool_compare_and_swap(&route->log_query_tokens,
+						 tokens, tokens - 1))
+			return 1;
+	}
+}
+
 #endif /* ODYSSEY_ROUTE_H */
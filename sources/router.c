@@ -14,6 +14,9 @@ void od_router_init(od_router_t *router, od_global_t *global)
 	pthread_mutex_init(&router->lock, NULL);
 	od_rules_init(&router->rules);
 	od_list_init(&router->servers);
+	int i;
+	for (i = 0; i < OD_ROUTER_PARAMS_BUCKETS; i++)
+		od_list_init(&router->params[i]);
 	od_route_pool_init(&router->route_pool);
 	router->clients = 0;
 	router->clients_routing = 0;
@@ -22,14 +25,90 @@ void od_router_init(od_router_t *router, od_global_t *global)
 	router->global = global;
 
 	router->router_err_logger = od_err_logger_create_default();
+	od_slow_query_ring_init(&router->slow_queries);
+	od_query_stats_init(&router->query_stats);
+}
+
+static inline void od_router_params_free(od_router_params_t *saved)
+{
+	od_list_unlink(&saved->link);
+	od_route_id_free(&saved->id);
+	free(saved->storage_host);
+	kiwi_params_free(&saved->params);
+	free(saved);
+}
+
+static inline int od_router_params_storage_match(od_router_params_t *saved,
+						 od_rule_storage_t *storage)
+{
+	if (saved->storage_port != storage->port)
+		return 0;
+	if (saved->storage_host == NULL || storage->host == NULL)
+		return saved->storage_host == storage->host;
+	return strcmp(saved->storage_host, storage->host) == 0;
+}
+
+/* params without routes are kept for an explicit rule only, dynamic
+ * routes of default rules are not restored */
+static inline int od_router_params_wanted(od_router_t *router,
+					  od_router_params_t *saved)
+{
+	od_rule_t *rule;
+	rule = od_rules_forward(&router->rules, saved->id.database,
+				saved->id.user);
+	if (rule == NULL || rule->db_is_default || rule->user_is_default)
+		return 0;
+	return od_router_params_storage_match(saved, rule->storage);
+}
+
+/* drop params left without routes, router must be locked */
+static inline void od_router_params_prune(od_router_t *router)
+{
+	int i;
+	for (i = 0; i < OD_ROUTER_PARAMS_BUCKETS; i++) {
+		od_list_t *j, *n;
+		od_list_foreach_safe(&router->params[i], j, n)
+		{
+			od_router_params_t *saved;
+			saved = od_container_of(j, od_router_params_t, link);
+			if (saved->refs == 0 &&
+			    !od_router_params_wanted(router, saved))
+				od_router_params_free(saved);
+		}
+	}
+}
+
+/* route is removed, router must be locked */
+static inline void od_router_params_release(od_router_t *router,
+					    od_route_t *route)
+{
+	od_router_params_t *saved = route->params_saved;
+	if (saved == NULL)
+		return;
+	route->params_saved = NULL;
+	saved->refs--;
+	if (saved->refs == 0 && !od_router_params_wanted(router, saved))
+		od_router_params_free(saved);
 }
 
 void od_router_free(od_router_t *router)
 {
+	int i;
+	for (i = 0; i < OD_ROUTER_PARAMS_BUCKETS; i++) {
+		od_list_t *j, *n;
+		od_list_foreach_safe(&router->params[i], j, n)
+		{
+			od_router_params_t *saved;
+			saved = od_container_of(j, od_router_params_t, link);
+			od_router_params_free(saved);
+		}
+	}
 	od_route_pool_free(&router->route_pool);
 	od_rules_free(&router->rules);
 	pthread_mutex_destroy(&router->lock);
 	od_err_logger_free(router->router_err_logger);
+	od_slow_query_ring_free(&router->slow_queries);
+	od_query_stats_free(&router->query_stats);
 }
 
 inline int od_router_foreach(od_router_t *router, od_route_pool_cb_t callback,
@@ -160,6 +239,9 @@ int od_router_reconfigure(od_router_t *router, od_rules_t *rules)
 
 		od_route_pool_foreach(&router->route_pool, od_router_reload_cb,
 				      NULL);
+
+		/* params of deleted rules or moved storages */
+		od_router_params_prune(router);
 	}
 
 	od_router_unlock(router);
@@ -255,7 +337,8 @@ int od_router_expire(od_router_t *router, od_list_t *expire_list)
 
 static inline int od_router_gc_cb(od_route_t *route, void **argv)
 {
-	od_route_pool_t *pool = argv[0];
+	od_router_t *router = argv[0];
+	od_route_pool_t *pool = &router->route_pool;
 	od_route_lock(route);
 
 	if (od_server_pool_total(&route->server_pool) > 0 ||
@@ -272,6 +355,8 @@ static inline int od_router_gc_cb(od_route_t *route, void **argv)
 
 	od_route_unlock(route);
 
+	od_router_params_release(router, route);
+
 	/* unref route rule and free route object */
 	od_rules_unref(route->rule);
 	od_route_free(route);
@@ -283,7 +368,7 @@ done:
 
 void od_router_gc(od_router_t *router)
 {
-	void *argv[] = { &router->route_pool };
+	void *argv[] = { router };
 	od_router_foreach(router, od_router_gc_cb, argv);
 }
 
@@ -302,6 +387,108 @@ void od_router_stat(od_router_t *router, uint64_t prev_time_us,
 	od_router_unlock(router);
 }
 
+static inline od_list_t *od_router_params_bucket(od_router_t *router,
+						 od_route_id_t *id)
+{
+	od_hash_t hash = od_murmur_hash(id->database, id->database_len) ^
+			 od_murmur_hash(id->user, id->user_len);
+	return &router->params[hash % OD_ROUTER_PARAMS_BUCKETS];
+}
+
+static inline od_router_params_t *od_router_params_find(od_router_t *router,
+							 od_route_t *route)
+{
+	od_list_t *bucket = od_router_params_bucket(router, &route->id);
+	od_list_t *i;
+	od_list_foreach(bucket, i)
+	{
+		od_router_params_t *saved;
+		saved = od_container_of(i, od_router_params_t, link);
+		if (od_route_id_compare(&saved->id, &route->id) &&
+		    od_router_params_storage_match(saved, route->rule->storage))
+			return saved;
+	}
+	return NULL;
+}
+
+/* save params set or refreshed for the route */
+void od_router_save_params(od_router_t *router, od_route_t *route)
+{
+	od_rule_storage_t *storage = route->rule->storage;
+
+	od_router_params_t *saved;
+	saved = malloc(sizeof(od_router_params_t));
+	if (saved == NULL)
+		return;
+	od_list_init(&saved->link);
+	kiwi_params_init(&saved->params);
+	saved->storage_host = NULL;
+	saved->storage_port = storage->port;
+	if (storage->host) {
+		saved->storage_host = strdup(storage->host);
+		if (saved->storage_host == NULL)
+			goto error;
+	}
+	if (od_route_id_copy(&saved->id, &route->id) == -1)
+		goto error;
+	if (kiwi_params_lock_copy(&route->params, &saved->params) == -1) {
+		od_route_id_free(&saved->id);
+		goto error;
+	}
+
+	od_router_lock(router);
+	od_router_params_t *prev;
+	prev = od_router_params_find(router, route);
+	if (prev) {
+		/* refresh, previous params are freed with the copy */
+		kiwi_params_t params = prev->params;
+		prev->params = saved->params;
+		saved->params = params;
+		if (route->params_saved == NULL) {
+			route->params_saved = prev;
+			prev->refs++;
+		}
+		od_router_unlock(router);
+		od_route_id_free(&saved->id);
+		free(saved->storage_host);
+		kiwi_params_free(&saved->params);
+		free(saved);
+		return;
+	}
+	saved->refs = 1;
+	route->params_saved = saved;
+	od_list_append(od_router_params_bucket(router, &route->id),
+		       &saved->link);
+	od_router_unlock(router);
+	return;
+
+error:
+	free(saved->storage_host);
+	kiwi_params_free(&saved->params);
+	free(saved);
+}
+
+/* restore parameters of a route created for the updated rule */
+static inline void od_router_restore_params(od_router_t *router,
+					    od_route_t *route)
+{
+	od_router_params_t *saved;
+	saved = od_router_params_find(router, route);
+	if (saved == NULL)
+		return;
+	route->params_saved = saved;
+	saved->refs++;
+
+	kiwi_params_t params;
+	kiwi_params_init(&params);
+	if (kiwi_params_copy(&params, &saved->params) == -1) {
+		kiwi_params_free(&params);
+		return;
+	}
+	if (kiwi_params_lock_set_once(&route->params, &params) != 1)
+		kiwi_params_free(&params);
+}
+
 od_router_status_t od_router_route(od_router_t *router, od_client_t *client)
 {
 	kiwi_be_startup_t *startup = &client->startup;
@@ -365,6 +552,7 @@ od_router_status_t od_router_route(od_router_t *router, od_client_t *client)
 			od_router_unlock(router);
 			return OD_ROUTER_ERROR;
 		}
+		od_router_restore_params(router, route);
 	}
 	od_rules_ref(rule);
 
@@ -447,10 +635,12 @@ od_router_status_t od_router_attach(od_router_t *router, od_client_t *client,
 	od_route_t *route = client->route;
 	assert(route != NULL);
 
+	uint64_t queue_start = machine_time_us();
 	od_route_lock(route);
 
 	/* enqueue client (pending -> queue) */
 	od_client_pool_set(&route->client_pool, client, OD_CLIENT_QUEUE);
+	client->time_queue = queue_start;
 
 	/* get client server from route server pool */
 	bool restart_read = false;
@@ -523,8 +713,15 @@ od_router_status_t od_router_attach(od_router_t *router, od_client_t *client,
 		if (timeout == 0)
 			timeout = UINT32_MAX;
 		rc = od_route_wait(route, timeout);
-		if (rc == -1)
+		if (rc == -1) {
+			uint64_t queue_time = machine_time_us() - queue_start;
+			client->lifecycle[OD_LIFECYCLE_QUEUE] += queue_time;
+			client->time_queue = 0;
+			od_lifecycle_add(&route->lifecycle, OD_LIFECYCLE_QUEUE,
+					 queue_time);
+			od_atomic_u64_inc(&route->wait_timeouts);
 			return OD_ROUTER_ERROR_TIMEDOUT;
+		}
 
 		od_route_lock(route);
 	}
@@ -546,6 +743,11 @@ attach:
 	od_pg_server_pool_set(&route->server_pool, server, OD_SERVER_ACTIVE);
 	od_client_pool_set(&route->client_pool, client, OD_CLIENT_ACTIVE);
 
+	uint64_t queue_time = machine_time_us() - queue_start;
+	client->lifecycle[OD_LIFECYCLE_QUEUE] += queue_time;
+	client->time_queue = 0;
+	od_lifecycle_add(&route->lifecycle, OD_LIFECYCLE_QUEUE, queue_time);
+
 	client->server = server;
 	server->client = client;
 	server->idle_time = 0;
@@ -7,8 +7,27 @@
  * Scalable PostgreSQL connection pooler.
  */
 
+typedef struct od_router_params od_router_params_t;
 typedef struct od_router od_router_t;
 
+#define OD_ROUTER_PARAMS_BUCKETS 64
+
+/*
+ * Server parameters of a route, kept across config reloads.
+ *
+ * Entry is referenced by routes with the same id and storage. Entry
+ * left without routes is kept only while an explicit rule still
+ * forwards to it, so a route of the reloaded rule can restore it.
+ */
+struct od_router_params {
+	od_route_id_t id;
+	char *storage_host;
+	int storage_port;
+	kiwi_params_t params;
+	int refs;
+	od_list_t link;
+};
+
 struct od_router {
 	pthread_mutex_t lock;
 
@@ -21,12 +40,19 @@ struct od_router {
 	od_atomic_u32_t servers_routing;
 	/* error logging */
 	od_error_logger_t *router_err_logger;
+	/* slow queries */
+	od_slow_query_ring_t slow_queries;
+	/* normalized query statistics */
+	od_query_stats_t query_stats;
 
 	/* global */
 	od_global_t *global;
 
 	/* router has type of list */
 	od_list_t servers;
+
+	/* saved route server parameters, by route id */
+	od_list_t params[OD_ROUTER_PARAMS_BUCKETS];
 };
 
 #define od_router_lock(router) pthread_mutex_lock(&router->lock);
@@ -50,6 +76,8 @@ od_router_status_t od_router_route(od_router_t *router, od_client_t *client);
 
 void od_router_unroute(od_router_t *, od_client_t *);
 
+void od_router_save_params(od_router_t *, od_route_t *);
+
 od_router_status_t od_router_attach(od_router_t *, od_client_t *, bool);
 void od_router_detach(od_router_t *, od_client_t *);
 void od_router_close(od_router_t *, od_client_t *);
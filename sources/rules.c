@@ -139,6 +139,10 @@ od_rule_t *od_rules_add(od_rules_t *rules)
 
 	rule->auth_common_name_default = 0;
 	rule->auth_common_names_count = 0;
+	od_auth_cache_init(&rule->auth_query_cache);
+#ifdef USE_SCRAM
+	od_scram_cache_init(&rule->scram_cache);
+#endif
 	rule->server_lifetime_us = 3600 * 1000000L;
 	rule->reserve_session_server_connection = 1;
 #ifdef PAM_FOUND
@@ -178,6 +182,10 @@ void od_rules_rule_free(od_rule_t *rule)
 		free(rule->auth_query_db);
 	if (rule->auth_query_user)
 		free(rule->auth_query_user);
+	od_auth_cache_free(&rule->auth_query_cache);
+#ifdef USE_SCRAM
+	od_scram_cache_free(&rule->scram_cache);
+#endif
 	if (rule->storage)
 		od_rules_storage_free(rule->storage);
 	if (rule->storage_name)
@@ -425,6 +433,13 @@ int od_rules_rule_compare(od_rule_t *a, od_rule_t *b)
 		return 0;
 	}
 
+	/* auth query cache */
+	if (a->auth_query_cache_ttl != b->auth_query_cache_ttl)
+		return 0;
+	if (a->auth_query_cache_negative_ttl !=
+	    b->auth_query_cache_negative_ttl)
+		return 0;
+
 	/* auth common name default */
 	if (a->auth_common_name_default != b->auth_common_name_default)
 		return 0;
@@ -847,6 +862,20 @@ int od_rules_validate(od_rules_t *rules, od_config_t *config,
 			return NOT_OK_RESPONSE;
 		}
 
+		/* deprecated, slow queries are logged by log_query */
+		if (rule->slow_query_log) {
+			od_error(logger, "rules validate", NULL, NULL,
+				 "rule '%s.%s': slow_query_log is deprecated, "
+				 "use log_query with log_query_min_duration",
+				 rule->db_name, rule->user_name);
+			if (rule->log_query_min_duration == 0 &&
+			    rule->slow_query_threshold > 0) {
+				rule->log_query = 1;
+				rule->log_query_min_duration =
+					rule->slow_query_threshold;
+			}
+		}
+
 		if (rule->storage->storage_type != OD_RULE_STORAGE_LOCAL) {
 			if (rule->user_role != OD_RULE_ROLE_UNDEF) {
 				od_error(
@@ -951,6 +980,21 @@ int od_rules_validate(od_rules_t *rules, od_config_t *config,
 					rule->db_name, rule->user_name);
 				return -1;
 			}
+			if (rule->auth_query_cache_ttl < 0 ||
+			    rule->auth_query_cache_negative_ttl < 0) {
+				od_error(
+					logger, "rules", NULL, NULL,
+					"rule '%s.%s': auth_query_cache ttl must not be negative",
+					rule->db_name, rule->user_name);
+				return -1;
+			}
+			if (rule->auth_query_cache_negative_ttl > 0 &&
+			    rule->auth_query_cache_ttl == 0) {
+				od_error(
+					logger, "rules", NULL, NULL,
+					"rule '%s.%s': auth_query_cache_negative_ttl has no effect without auth_query_cache_ttl",
+					rule->db_name, rule->user_name);
+			}
 		}
 	}
 
@@ -1077,6 +1121,14 @@ void od_rules_print(od_rules_t *rules, od_logger_t *logger)
 			od_log(logger, "rules", NULL, NULL,
 			       "  auth_query_user                   %s",
 			       rule->auth_query_user);
+		if (rule->auth_query_cache_ttl) {
+			od_log(logger, "rules", NULL, NULL,
+			       "  auth_query_cache_ttl              %d",
+			       rule->auth_query_cache_ttl);
+			od_log(logger, "rules", NULL, NULL,
+			       "  auth_query_cache_negative_ttl     %d",
+			       rule->auth_query_cache_negative_ttl);
+		}
 
 		/* pool  */
 		od_log(logger, "rules", NULL, NULL,
@@ -1193,6 +1245,30 @@ void od_rules_print(od_rules_t *rules, od_logger_t *logger)
 		od_log(logger, "rules", NULL, NULL,
 		       "  log_query                         %s",
 		       od_rules_yes_no(rule->log_query));
+		if (rule->log_query_sample)
+			od_log(logger, "rules", NULL, NULL,
+			       "  log_query_sample                  %d",
+			       rule->log_query_sample);
+		if (rule->log_query_rate)
+			od_log(logger, "rules", NULL, NULL,
+			       "  log_query_rate                    %d",
+			       rule->log_query_rate);
+		if (rule->log_query_min_duration)
+			od_log(logger, "rules", NULL, NULL,
+			       "  log_query_min_duration            %d",
+			       rule->log_query_min_duration);
+		if (rule->slow_query_threshold) {
+			od_log(logger, "rules", NULL, NULL,
+			       "  slow_query_threshold              %d",
+			       rule->slow_query_threshold);
+			od_log(logger, "rules", NULL, NULL,
+			       "  slow_query_log                    %s",
+			       od_rules_yes_no(rule->slow_query_log));
+		}
+		if (rule->query_stats)
+			od_log(logger, "rules", NULL, NULL,
+			       "  query_stats                       %s",
+			       od_rules_yes_no(rule->query_stats));
 
 		od_log(logger, "rules", NULL, NULL,
 		       "  options:                         %s", "todo");
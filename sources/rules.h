@@ -75,6 +75,12 @@ struct od_rule {
 	char *auth_query;
 	char *auth_query_db;
 	char *auth_query_user;
+	int auth_query_cache_ttl;
+	int auth_query_cache_negative_ttl;
+	od_auth_cache_t auth_query_cache;
+#ifdef USE_SCRAM
+	od_scram_cache_t scram_cache;
+#endif
 	int auth_common_name_default;
 	od_list_t auth_common_names;
 	int auth_common_names_count;
@@ -124,6 +130,12 @@ struct od_rule {
 	int client_max;
 	int log_debug;
 	int log_query;
+	int log_query_sample;
+	int log_query_rate;
+	int log_query_min_duration;
+	int slow_query_threshold;
+	int slow_query_log;
+	int query_stats;
 	int enable_password_passthrough;
 	double *quantiles;
 	int quantiles_count;
@@ -165,6 +165,47 @@ error:
 	return -1;
 }
 
+int od_scram_init_from_cache(od_scram_state_t *scram_state,
+			     od_scram_cache_t *cache, char *user,
+			     char *plain_password)
+{
+	od_scram_secret_t secret;
+	od_scram_cache_key(user, plain_password, secret.key);
+
+	int rc = -1;
+	if (od_scram_cache_get(cache, secret.key, &secret,
+			       machine_time_ms()) == 0) {
+		scram_state->salt = strdup(secret.salt);
+		if (scram_state->salt) {
+			scram_state->iterations = secret.iterations;
+			memcpy(scram_state->stored_key, secret.stored_key,
+			       sizeof(secret.stored_key));
+			memcpy(scram_state->server_key, secret.server_key,
+			       sizeof(secret.server_key));
+			rc = 0;
+		}
+	}
+	memset(&secret, 0, sizeof(secret));
+	return rc;
+}
+
+void od_scram_cache_store(od_scram_cache_t *cache, char *user,
+			  char *plain_password, od_scram_state_t *scram_state)
+{
+	od_scram_secret_t secret;
+	if (strlen(scram_state->salt) >= sizeof(secret.salt))
+		return;
+	od_scram_cache_key(user, plain_password, secret.key);
+	strcpy(secret.salt, scram_state->salt);
+	secret.iterations = scram_state->iterations;
+	memcpy(secret.stored_key, scram_state->stored_key,
+	       sizeof(secret.stored_key));
+	memcpy(secret.server_key, scram_state->server_key,
+	       sizeof(secret.server_key));
+	od_scram_cache_put(cache, &secret, machine_time_ms());
+	memset(&secret, 0, sizeof(secret));
+}
+
 machine_msg_t *
 od_scram_create_client_first_message(od_scram_state_t *scram_state)
 {
@@ -121,6 +121,13 @@ int od_scram_parse_verifier(od_scram_state_t *scram_state, char *verifier);
 int od_scram_init_from_plain_password(od_scram_state_t *scram_state,
 				      char *plain_password);
 
+int od_scram_init_from_cache(od_scram_state_t *scram_state,
+			     od_scram_cache_t *cache, char *user,
+			     char *plain_password);
+
+void od_scram_cache_store(od_scram_cache_t *cache, char *user,
+			  char *plain_password, od_scram_state_t *scram_state);
+
 int od_scram_read_client_first_message(od_scram_state_t *scram_state,
 				       char *auth_data, size_t auth_data_size);
 
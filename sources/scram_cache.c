@@ -0,0 +1,150 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+#include <openssl/sha.h>
+
+void od_scram_cache_init(od_scram_cache_t *cache)
+{
+	pthread_mutex_init(&cache->lock, NULL);
+	od_list_init(&cache->list);
+	int i;
+	for (i = 0; i < OD_SCRAM_CACHE_BUCKETS; i++)
+		od_list_init(&cache->buckets[i]);
+	cache->count = 0;
+}
+
+void od_scram_cache_free(od_scram_cache_t *cache)
+{
+	od_list_t *i, *n;
+	od_list_foreach_safe(&cache->list, i, n)
+	{
+		od_scram_secret_t *secret;
+		secret = od_container_of(i, od_scram_secret_t, link);
+		memset(secret, 0, sizeof(*secret));
+		free(secret);
+	}
+	od_list_init(&cache->list);
+	int j;
+	for (j = 0; j < OD_SCRAM_CACHE_BUCKETS; j++)
+		od_list_init(&cache->buckets[j]);
+	cache->count = 0;
+	pthread_mutex_destroy(&cache->lock);
+}
+
+void od_scram_cache_key(char *user, char *password, uint8_t *key)
+{
+	int user_len = strlen(user) + 1;
+	int password_len = strlen(password);
+	char data[user_len + password_len];
+	memcpy(data, user, user_len);
+	memcpy(data + user_len, password, password_len);
+	SHA256((uint8_t *)data, user_len + password_len, key);
+	memset(data, 0, sizeof(data));
+}
+
+static inline od_list_t *od_scram_cache_bucket(od_scram_cache_t *cache,
+						uint8_t *key)
+{
+	/* key is a digest already, its leading bytes are uniform */
+	uint32_t hash;
+	memcpy(&hash, key, sizeof(hash));
+	return &cache->buckets[hash % OD_SCRAM_CACHE_BUCKETS];
+}
+
+static inline od_scram_secret_t *od_scram_cache_find(od_scram_cache_t *cache,
+						     uint8_t *key)
+{
+	od_list_t *bucket = od_scram_cache_bucket(cache, key);
+	od_list_t *i;
+	od_list_foreach(bucket, i)
+	{
+		od_scram_secret_t *secret;
+		secret = od_container_of(i, od_scram_secret_t, link_bucket);
+		if (memcmp(secret->key, key, OD_SCRAM_CACHE_KEY_LEN) == 0)
+			return secret;
+	}
+	return NULL;
+}
+
+static inline void od_scram_cache_unlink(od_scram_cache_t *cache,
+					 od_scram_secret_t *secret)
+{
+	od_list_unlink(&secret->link);
+	od_list_unlink(&secret->link_bucket);
+	cache->count--;
+}
+
+static inline int od_scram_cache_expired(od_scram_secret_t *secret,
+					 uint64_t now_ms)
+{
+	return now_ms - secret->created_ms >= OD_SCRAM_CACHE_TTL_MS;
+}
+
+int od_scram_cache_get(od_scram_cache_t *cache, uint8_t *key,
+		       od_scram_secret_t *result, uint64_t now_ms)
+{
+	pthread_mutex_lock(&cache->lock);
+	od_scram_secret_t *secret;
+	secret = od_scram_cache_find(cache, key);
+	if (secret == NULL) {
+		pthread_mutex_unlock(&cache->lock);
+		return -1;
+	}
+	if (od_scram_cache_expired(secret, now_ms)) {
+		od_scram_cache_unlink(cache, secret);
+		pthread_mutex_unlock(&cache->lock);
+		memset(secret, 0, sizeof(*secret));
+		free(secret);
+		return -1;
+	}
+	/* keep recently used entries first */
+	od_list_unlink(&secret->link);
+	od_list_push(&cache->list, &secret->link);
+	memcpy(result, secret, sizeof(*result));
+	od_list_init(&result->link);
+	od_list_init(&result->link_bucket);
+	pthread_mutex_unlock(&cache->lock);
+	return 0;
+}
+
+void od_scram_cache_put(od_scram_cache_t *cache, od_scram_secret_t *secret,
+			uint64_t now_ms)
+{
+	pthread_mutex_lock(&cache->lock);
+	od_scram_secret_t *entry;
+	entry = od_scram_cache_find(cache, secret->key);
+	if (entry) {
+		/* derived concurrently by another login */
+		if (!od_scram_cache_expired(entry, now_ms)) {
+			pthread_mutex_unlock(&cache->lock);
+			return;
+		}
+		od_scram_cache_unlink(cache, entry);
+	} else if (cache->count >= OD_SCRAM_CACHE_MAX) {
+		entry = od_container_of(cache->list.prev, od_scram_secret_t,
+					link);
+		od_scram_cache_unlink(cache, entry);
+	} else {
+		entry = malloc(sizeof(od_scram_secret_t));
+		if (entry == NULL) {
+			pthread_mutex_unlock(&cache->lock);
+			return;
+		}
+	}
+	memcpy(entry, secret, sizeof(*entry));
+	entry->created_ms = now_ms;
+	od_list_init(&entry->link);
+	od_list_init(&entry->link_bucket);
+	od_list_push(&cache->list, &entry->link);
+	od_list_append(od_scram_cache_bucket(cache, entry->key),
+		       &entry->link_bucket);
+	cache->count++;
+	pthread_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,57 @@
+#ifndef ODYSSEY_SCRAM_CACHE_H
+#define ODYSSEY_SCRAM_CACHE_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * SCRAM secrets derived from plain text passwords.
+ *
+ * Deriving salted password takes SCRAM_DEFAULT_ITERATIONS rounds of
+ * HMAC, so the result is kept per user and password and reused by
+ * following logins. Entries are keyed by digest of user name and
+ * password, changed password simply misses the cache. Entries are
+ * found through a hash index over the key, least recently used entry
+ * is evicted when the cache is full. Entries expire after
+ * OD_SCRAM_CACHE_TTL_MS, so the salt announced to clients is rotated.
+ */
+
+#define OD_SCRAM_CACHE_MAX 1024
+#define OD_SCRAM_CACHE_BUCKETS 256
+#define OD_SCRAM_CACHE_TTL_MS (3600 * 1000)
+#define OD_SCRAM_CACHE_KEY_LEN 32
+#define OD_SCRAM_CACHE_SALT_MAX 64
+
+typedef struct od_scram_secret od_scram_secret_t;
+typedef struct od_scram_cache od_scram_cache_t;
+
+struct od_scram_secret {
+	uint8_t key[OD_SCRAM_CACHE_KEY_LEN];
+	int iterations;
+	char salt[OD_SCRAM_CACHE_SALT_MAX];
+	uint8_t stored_key[32];
+	uint8_t server_key[32];
+	uint64_t created_ms;
+	od_list_t link;
+	od_list_t link_bucket;
+};
+
+struct od_scram_cache {
+	pthread_mutex_t lock;
+	od_list_t list;
+	od_list_t buckets[OD_SCRAM_CACHE_BUCKETS];
+	int count;
+};
+
+extern void od_scram_cache_init(od_scram_cache_t *);
+extern void od_scram_cache_free(od_scram_cache_t *);
+extern void od_scram_cache_key(char *, char *, uint8_t *);
+extern int od_scram_cache_get(od_scram_cache_t *, uint8_t *,
+			      od_scram_secret_t *, uint64_t);
+extern void od_scram_cache_put(od_scram_cache_t *, od_scram_secret_t *,
+			       uint64_t);
+
+#endif /* ODYSSEY_SCRAM_CACHE_H */
@@ -29,6 +29,14 @@ struct od_server {
 	int is_copy;
 	int deploy_sync;
 	od_stat_state_t stats_state;
+	/* reply size of the transaction, kept for slow query capture */
+	uint64_t query_bytes;
+	/* rows and reply size of the statement in progress, and
+	 * completion time of the last one, kept for query statistics */
+	uint64_t query_rows;
+	uint64_t query_exec_bytes;
+	uint64_t query_end_us;
+	uint64_t deploy_start_us;
 
 	uint64_t sync_request;
 	uint64_t sync_reply;
@@ -77,6 +85,11 @@ static inline void od_server_init(od_server_t *server, int reserve_prep_stmts)
 	server->offline = 0;
 	server->synced_settings = false;
 	od_stat_state_init(&server->stats_state);
+	server->query_bytes = 0;
+	server->query_rows = 0;
+	server->query_exec_bytes = 0;
+	server->query_end_us = 0;
+	server->deploy_start_us = 0;
 
 #ifdef USE_SCRAM
 	od_scram_state_init(&server->scram_state);
@@ -50,6 +50,7 @@ od_attribute_noreturn() void od_system_shutdown(od_system_t *system,
 	// lock here
 	od_cron_stop(system->global->cron);
 
+	od_handshake_pool_stop(system->global->handshake_pool);
 	od_worker_pool_stop(system->global->worker_pool);
 	od_router_free(system->global->router);
 	/* Prevent OpenSSL usage during deinitialization */
@@ -58,6 +59,7 @@ od_attribute_noreturn() void od_system_shutdown(od_system_t *system,
 	od_extention_free(&instance->logger, system->global->extentions);
 
 	od_system_cleanup(system);
+	od_logger_flush(&instance->logger);
 	exit(0);
 }
 
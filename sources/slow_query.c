@@ -0,0 +1,77 @@
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+#include <kiwi.h>
+#include <machinarium.h>
+#include <odyssey.h>
+
+void od_slow_query_ring_init(od_slow_query_ring_t *ring)
+{
+	pthread_mutex_init(&ring->lock, NULL);
+	ring->records = NULL;
+	ring->size = 0;
+	ring->count = 0;
+	ring->pos = 0;
+}
+
+int od_slow_query_ring_set_size(od_slow_query_ring_t *ring, int size)
+{
+	od_slow_query_t *records = NULL;
+	if (size > 0) {
+		records = malloc(sizeof(od_slow_query_t) * size);
+		if (records == NULL)
+			return -1;
+	}
+	pthread_mutex_lock(&ring->lock);
+	free(ring->records);
+	ring->records = records;
+	ring->size = size;
+	ring->count = 0;
+	ring->pos = 0;
+	pthread_mutex_unlock(&ring->lock);
+	return 0;
+}
+
+void od_slow_query_ring_free(od_slow_query_ring_t *ring)
+{
+	free(ring->records);
+	ring->records = NULL;
+	pthread_mutex_destroy(&ring->lock);
+}
+
+void od_slow_query_ring_add(od_slow_query_ring_t *ring,
+			    od_slow_query_t *record)
+{
+	pthread_mutex_lock(&ring->lock);
+	if (ring->size == 0) {
+		pthread_mutex_unlock(&ring->lock);
+		return;
+	}
+	od_slow_query_t *dest = &ring->records[ring->pos % ring->size];
+	memcpy(dest, record, sizeof(*record));
+	ring->pos++;
+	if (ring->count < ring->size)
+		ring->count++;
+	pthread_mutex_unlock(&ring->lock);
+}
+
+/* iterate records from oldest to newest */
+int od_slow_query_ring_foreach(od_slow_query_ring_t *ring,
+			       od_slow_query_cb_t callback, void **argv)
+{
+	int rc = 0;
+	pthread_mutex_lock(&ring->lock);
+	uint64_t start = ring->pos - ring->count;
+	int i;
+	for (i = 0; i < ring->count; i++) {
+		rc = callback(&ring->records[(start + i) % ring->size], argv);
+		if (rc == -1)
+			break;
+	}
+	pthread_mutex_unlock(&ring->lock);
+	return rc;
+}
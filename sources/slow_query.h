@@ -0,0 +1,68 @@
+#ifndef ODYSSEY_SLOW_QUERY_H
+#define ODYSSEY_SLOW_QUERY_H
+
+/*
+ * Odyssey.
+ *
+ * Scalable PostgreSQL connection pooler.
+ */
+
+/*
+ * Bounded ring of queries and transactions which took longer than
+ * rule slow_query_threshold. Oldest record is overwritten when
+ * ring is full. Query text is truncated to OD_SLOW_QUERY_TEXT_MAX.
+ */
+
+#define OD_SLOW_QUERY_TEXT_MAX 256
+#define OD_SLOW_QUERY_NAME_MAX 64
+
+typedef struct od_slow_query od_slow_query_t;
+typedef struct od_slow_query_ring od_slow_query_ring_t;
+
+typedef enum {
+	OD_SLOW_QUERY,
+	OD_SLOW_TRANSACTION,
+} od_slow_query_type_t;
+
+struct od_slow_query {
+	od_slow_query_type_t type;
+	time_t time;
+	od_id_t client_id;
+	od_id_t server_id;
+	char user[OD_SLOW_QUERY_NAME_MAX];
+	char database[OD_SLOW_QUERY_NAME_MAX];
+	int64_t duration_us;
+	uint64_t bytes;
+	int text_len;
+	char text[OD_SLOW_QUERY_TEXT_MAX];
+};
+
+struct od_slow_query_ring {
+	pthread_mutex_t lock;
+	od_slow_query_t *records;
+	int size;
+	int count;
+	uint64_t pos;
+};
+
+typedef int (*od_slow_query_cb_t)(od_slow_query_t *, void **);
+
+extern void od_slow_query_ring_init(od_slow_query_ring_t *);
+extern int od_slow_query_ring_set_size(od_slow_query_ring_t *, int);
+extern void od_slow_query_ring_free(od_slow_query_ring_t *);
+extern void od_slow_query_ring_add(od_slow_query_ring_t *, od_slow_query_t *);
+extern int od_slow_query_ring_foreach(od_slow_query_ring_t *,
+				      od_slow_query_cb_t, void **);
+
+static inline char *od_slow_query_type_to_str(od_slow_query_type_t type)
+{
+	switch (type) {
+	case OD_SLOW_QUERY:
+		return "query";
+	case OD_SLOW_TRANSACTION:
+		return "transaction";
+	}
+	return "unknown";
+}
+
+#endif /* ODYSSEY_SLOW_QUERY_H */
@@ -33,6 +33,9 @@ struct od_stat {
 	od_atomic_u64_t count_parse;
 	od_atomic_u64_t count_parse_reuse;
 
+	/* bytes currently queued by relays */
+	od_atomic_u64_t buffered;
+
 	td_histogram_t *transaction_hgram[QUANTILES_WINDOW];
 	td_histogram_t *query_hgram[QUANTILES_WINDOW];
 };
@@ -75,7 +78,8 @@ static inline void od_stat_parse_reuse(od_stat_t *stat)
 }
 
 static inline void od_stat_query_end(od_stat_t *stat, od_stat_state_t *state,
-				     int in_transaction, int64_t *query_time)
+				     int in_transaction, int64_t *query_time,
+				     int64_t *tx_time)
 {
 	int64_t diff;
 	if (state->query_time_start) {
@@ -98,6 +102,7 @@ static inline void od_stat_query_end(od_stat_t *stat, od_stat_state_t *state,
 	if (state->tx_time_start) {
 		diff = machine_time_us() - state->tx_time_start;
 		if (diff > 0) {
+			*tx_time = diff;
 			od_atomic_u64_add(&stat->tx_time, diff);
 			od_atomic_u64_inc(&stat->count_tx);
 			if (stat->enable_quantiles) {
@@ -120,6 +125,14 @@ static inline void od_stat_recv_client(od_stat_t *stat, uint64_t bytes)
 	od_atomic_u64_add(&stat->recv_client, bytes);
 }
 
+static inline void od_stat_buffered(od_stat_t *stat, int delta)
+{
+	if (delta > 0)
+		od_atomic_u64_add(&stat->buffered, delta);
+	else
+		od_atomic_u64_sub(&stat->buffered, -delta);
+}
+
 static inline void od_stat_copy(od_stat_t *dst, od_stat_t *src)
 {
 	dst->count_query = od_atomic_u64_of(&src->count_query);
@@ -130,6 +143,7 @@ static inline void od_stat_copy(od_stat_t *dst, od_stat_t *src)
 	dst->recv_server = od_atomic_u64_of(&src->recv_server);
 	dst->count_parse = od_atomic_u64_of(&src->count_parse);
 	dst->count_parse_reuse = od_atomic_u64_of(&src->count_parse_reuse);
+	dst->buffered = od_atomic_u64_of(&src->buffered);
 }
 
 static inline void od_stat_sum(od_stat_t *sum, od_stat_t *stat)
@@ -142,6 +156,7 @@ static inline void od_stat_sum(od_stat_t *sum, od_stat_t *stat)
 	sum->recv_server += od_atomic_u64_of(&stat->recv_server);
 	sum->count_parse += od_atomic_u64_of(&stat->count_parse);
 	sum->count_parse_reuse += od_atomic_u64_of(&stat->count_parse_reuse);
+	sum->buffered += od_atomic_u64_of(&stat->buffered);
 }
 
 static inline void od_stat_update_of(od_atomic_u64_t *prev,
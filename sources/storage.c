@@ -71,6 +71,7 @@ od_rule_storage_t *od_rules_storage_allocate(void)
 		return NULL;
 	}
 
+	pthread_mutex_init(&storage->tls_lock, NULL);
 	od_list_init(&storage->link);
 	return storage;
 }
@@ -92,6 +93,10 @@ void od_rules_storage_free(od_rule_storage_t *storage)
 		od_storage_watchdog_soft_exit(storage->watchdog);
 	}
 
+	if (storage->tls)
+		machine_tls_free(storage->tls);
+	pthread_mutex_destroy(&storage->tls_lock);
+
 	od_list_unlink(&storage->link);
 	free(storage);
 }
@@ -146,6 +151,14 @@ od_rule_storage_t *od_rules_storage_copy(od_rule_storage_t *storage)
 		if (copy->tls_opts->tls_protocols == NULL)
 			goto error;
 	}
+	/* share tls object, so the copy resumes sessions and does not
+	 * create ssl contexts of its own */
+	pthread_mutex_lock(&storage->tls_lock);
+	if (storage->tls) {
+		machine_tls_ref(storage->tls);
+		copy->tls = storage->tls;
+	}
+	pthread_mutex_unlock(&storage->tls_lock);
 	return copy;
 error:
 	od_rules_storage_free(copy);
@@ -282,7 +295,7 @@ void od_storage_watchdog_watch(void *arg)
 		for (int retry = 0; retry < watchdog->check_retry; ++retry) {
 			char *qry = watchdog->query;
 
-			msg = od_query_do(server, "watchdog", qry, NULL);
+			msg = od_query_do(server, "watchdog", qry, NULL, NULL);
 			if (msg != NULL) {
 				rc = od_storage_watchdog_parse_lag_from_datarow(
 					msg, &last_heartbeat);
@@ -52,6 +52,10 @@ struct od_rule_storage {
 
 	od_storage_watchdog_t *watchdog;
 
+	/* shared by all backend connections, keeps the tls session */
+	pthread_mutex_t tls_lock;
+	machine_tls_t *tls;
+
 	od_list_t link;
 };
 
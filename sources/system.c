@@ -53,6 +53,8 @@ static inline void od_system_server(void *arg)
 
 		/* set network options */
 		machine_set_nodelay(client_io, instance->config.nodelay);
+		machine_set_edge_triggered(client_io,
+					   instance->config.io_edge_triggered);
 		if (instance->config.keepalive > 0)
 			machine_set_keepalive(
 				client_io, 1, instance->config.keepalive,
@@ -120,8 +122,15 @@ static inline void od_system_server(void *arg)
 		memcpy(machine_msg_data(msg), &client, sizeof(od_client_t *));
 
 		od_worker_pool_t *worker_pool = server->global->worker_pool;
+		od_handshake_pool_t *handshake_pool =
+			server->global->handshake_pool;
 		od_atomic_u32_inc(&router->clients_routing);
-		od_worker_pool_feed(worker_pool, msg);
+		if (od_handshake_pool_active(handshake_pool) &&
+		    server->config->tls_opts->tls_mode !=
+			    OD_CONFIG_TLS_DISABLE)
+			od_handshake_pool_feed(handshake_pool, msg);
+		else
+			od_worker_pool_feed(worker_pool, msg);
 		while (od_atomic_u32_of(&router->clients_routing) >=
 		       (uint32_t)instance->config.client_max_routing) {
 			machine_sleep(1);
@@ -497,6 +506,13 @@ static inline void od_system(void *arg)
 	if (rc == -1)
 		return;
 
+	/* start tls handshake threads */
+	rc = od_handshake_pool_start(system->global->handshake_pool,
+				     system->global,
+				     instance->config.tls_handshake_workers);
+	if (rc == -1)
+		return;
+
 	/* start signal handler coroutine */
 	int64_t mid;
 	mid = machine_create("sighandler", od_system_signal_handler, system);
@@ -511,10 +527,22 @@ static inline void od_system(void *arg)
 	if (rc == 0) {
 		od_error(&instance->logger, "system", NULL, NULL,
 			 "failed to bind any listen address");
+		od_logger_flush(&instance->logger);
 		exit(1);
 	}
 	od_rules_storages_watchdogs_run(&instance->logger, &router->rules);
 
+	if (instance->config.prefetch_route_params) {
+		/* fetch route server parameters before first clients */
+		int64_t coroutine_id;
+		coroutine_id = machine_coroutine_create(
+			od_frontend_prefetch_params, system->global);
+		if (coroutine_id == -1) {
+			od_error(&instance->logger, "system", NULL, NULL,
+				 "failed to start params prefetch coroutine");
+		}
+	}
+
 	if (instance->config.enable_online_restart_feature) {
 		/* start watchdog coroutine */
 		rc = od_watchdog_invoke(system);
@@ -133,6 +133,17 @@ int od_tls_frontend_accept(od_client_t *client, od_logger_t *logger,
 	return 0;
 }
 
+machine_tls_t *od_tls_backend_shared(od_rule_storage_t *storage)
+{
+	/* one object per storage, so backend connections resume sessions */
+	pthread_mutex_lock(&storage->tls_lock);
+	if (storage->tls == NULL)
+		storage->tls = od_tls_backend(storage);
+	machine_tls_t *tls = storage->tls;
+	pthread_mutex_unlock(&storage->tls_lock);
+	return tls;
+}
+
 machine_tls_t *od_tls_backend(od_rule_storage_t *storage)
 {
 	int rc;
@@ -13,6 +13,7 @@ int od_tls_frontend_accept(od_client_t *, od_logger_t *, od_config_listen_t *,
 			   machine_tls_t *);
 
 machine_tls_t *od_tls_backend(od_rule_storage_t *);
+machine_tls_t *od_tls_backend_shared(od_rule_storage_t *);
 
 int od_tls_backend_connect(od_server_t *, od_logger_t *, od_rule_storage_t *);
 
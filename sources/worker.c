@@ -12,6 +12,42 @@
 #include <prom_metric.h>
 #endif
 
+static inline void od_worker_loop_stat_update(od_worker_t *worker)
+{
+	machine_loop_stat_t sample;
+	machine_loop_stat(&sample);
+	uint64_t now = machine_time_us();
+
+	machine_loop_stat_t *prev = &worker->loop_sample;
+	uint64_t interval = now - worker->loop_sample_time;
+	if (interval == 0)
+		interval = 1;
+	uint64_t switches = sample.count_switch - prev->count_switch;
+
+	od_worker_loop_stat_t stat;
+	stat.count_ready = sample.count_ready;
+	stat.count_active = sample.count_active;
+	stat.count_timer = sample.count_timer;
+	stat.switch_rate = switches * 1000000 / interval;
+	stat.wait_pct =
+		(sample.time_wait_us - prev->time_wait_us) * 100 / interval;
+	stat.run_pct = (sample.time_run_us - prev->time_run_us) * 100 / interval;
+	stat.run_max_us = sample.run_max_us;
+	stat.ready_delay_avg_us = 0;
+	if (switches > 0)
+		stat.ready_delay_avg_us =
+			(sample.ready_delay_us - prev->ready_delay_us) /
+			switches;
+	stat.ready_delay_max_us = sample.ready_delay_max_us;
+
+	worker->loop_sample = sample;
+	worker->loop_sample_time = now;
+
+	pthread_mutex_lock(&worker->loop_stat_lock);
+	worker->loop_stat = stat;
+	pthread_mutex_unlock(&worker->loop_stat_lock);
+}
+
 static inline void od_worker(void *arg)
 {
 	od_worker_t *worker = arg;
@@ -31,6 +67,9 @@ static inline void od_worker(void *arg)
 
 	(*gl)->wid = worker->id;
 
+	machine_loop_stat(&worker->loop_sample);
+	worker->loop_sample_time = machine_time_us();
+
 	for (;;) {
 		machine_msg_t *msg;
 		msg = machine_channel_read(worker->task_channel, UINT32_MAX);
@@ -62,6 +101,10 @@ static inline void od_worker(void *arg)
 			break;
 		}
 		case OD_MSG_STAT: {
+			od_worker_loop_stat_update(worker);
+			if (!instance->config.log_stats)
+				break;
+			od_worker_loop_stat_t loop_stat = worker->loop_stat;
 			uint64_t count_coroutine = 0;
 			uint64_t count_coroutine_cache = 0;
 			uint64_t msg_allocated = 0;
@@ -71,6 +114,9 @@ static inline void od_worker(void *arg)
 			machine_stat(&count_coroutine, &count_coroutine_cache,
 				     &msg_allocated, &msg_cache_count,
 				     &msg_cache_gc_count, &msg_cache_size);
+			int64_t readahead_used = 0;
+			int64_t readahead_cached = 0;
+			od_readahead_stat(&readahead_used, &readahead_cached);
 #ifdef PROM_FOUND
 			od_prom_metrics_write_worker_stat(
 				((od_cron_t *)(worker->global->cron))->metrics,
@@ -78,17 +124,32 @@ static inline void od_worker(void *arg)
 				msg_cache_gc_count, msg_cache_size,
 				count_coroutine, count_coroutine_cache,
 				worker->clients_processed);
+			od_prom_metrics_write_worker_loop_stat(
+				((od_cron_t *)(worker->global->cron))->metrics,
+				worker->id, loop_stat.count_ready,
+				loop_stat.count_timer, loop_stat.switch_rate,
+				loop_stat.wait_pct, loop_stat.run_max_us,
+				loop_stat.ready_delay_max_us);
 #endif
 			od_log(&instance->logger, "stats", NULL, NULL,
 			       "worker[%d]: msg (%" PRIu64
 			       " allocated, %" PRIu64 " cached, %" PRIu64
 			       " freed, %" PRIu64 " cache_size), "
 			       "coroutines (%" PRIu64 " active, %" PRIu64
-			       " cached), clients_processed: %" PRIu64,
+			       " cached), readahead (%" PRIi64 " used, %" PRIi64
+			       " cached), clients_processed: %" PRIu64
+			       ", loop (%" PRIu64 " ready, %" PRIu64
+			       " timers, %" PRIu64 " switches/sec, %" PRIu64
+			       "%% wait, %" PRIu64 " usec max run, %" PRIu64
+			       " usec max ready delay)",
 			       worker->id, msg_allocated, msg_cache_count,
 			       msg_cache_gc_count, msg_cache_size,
 			       count_coroutine, count_coroutine_cache,
-			       worker->clients_processed);
+			       readahead_used, readahead_cached,
+			       worker->clients_processed, loop_stat.count_ready,
+			       loop_stat.count_timer, loop_stat.switch_rate,
+			       loop_stat.wait_pct, loop_stat.run_max_us,
+			       loop_stat.ready_delay_max_us);
 			break;
 		}
 		default:
@@ -100,6 +161,7 @@ static inline void od_worker(void *arg)
 	}
 
 	od_log(&instance->logger, "worker", NULL, NULL, "stopped");
+	od_logger_release(&instance->logger);
 }
 
 void od_worker_init(od_worker_t *worker, od_global_t *global, int id)
@@ -108,6 +170,10 @@ void od_worker_init(od_worker_t *worker, od_global_t *global, int id)
 	worker->id = id;
 	worker->global = global;
 	worker->clients_processed = 0;
+	worker->loop_sample_time = 0;
+	memset(&worker->loop_sample, 0, sizeof(worker->loop_sample));
+	memset(&worker->loop_stat, 0, sizeof(worker->loop_stat));
+	pthread_mutex_init(&worker->loop_stat_lock, NULL);
 }
 
 int od_worker_start(od_worker_t *worker)
@@ -7,17 +7,44 @@
  * Scalable PostgreSQL connection pooler.
  */
 
+typedef struct od_worker_loop_stat od_worker_loop_stat_t;
 typedef struct od_worker od_worker_t;
 
+/* event loop stats for the last stats interval */
+struct od_worker_loop_stat {
+	uint64_t count_ready;
+	uint64_t count_active;
+	uint64_t count_timer;
+	uint64_t switch_rate;
+	uint64_t wait_pct;
+	uint64_t run_pct;
+	uint64_t run_max_us;
+	uint64_t ready_delay_avg_us;
+	uint64_t ready_delay_max_us;
+};
+
 struct od_worker {
 	int64_t machine;
 	int id;
 	machine_channel_t *task_channel;
 	uint64_t clients_processed;
+	/* previous sample, accessed by worker thread only */
+	machine_loop_stat_t loop_sample;
+	uint64_t loop_sample_time;
+	pthread_mutex_t loop_stat_lock;
+	od_worker_loop_stat_t loop_stat;
 	od_global_t *global;
 };
 
 void od_worker_init(od_worker_t *, od_global_t *, int);
 int od_worker_start(od_worker_t *);
 
+static inline void od_worker_loop_stat_read(od_worker_t *worker,
+					    od_worker_loop_stat_t *stat)
+{
+	pthread_mutex_lock(&worker->loop_stat_lock);
+	*stat = worker->loop_stat;
+	pthread_mutex_unlock(&worker->loop_stat_lock);
+}
+
 #endif /* ODYSSEY_WORKER_H */
@@ -37,6 +37,9 @@ typedef struct {
 	char *port;
 	int time_to_run;
 	int clients;
+	int edge_triggered;
+	int bind_size;
+	char *bind_param;
 } stress_t;
 
 static stress_t stress;
@@ -55,6 +58,7 @@ static inline void stress_client_main(void *arg)
 	}
 
 	machine_set_nodelay(client->io.io, 1);
+	machine_set_edge_triggered(client->io.io, stress.edge_triggered);
 	machine_set_keepalive(client->io.io, 1, 7200, 75, 9, 0);
 
 	/* resolve host */
@@ -131,7 +135,14 @@ static inline void stress_client_main(void *arg)
 		int start_time = od_histogram_time_us();
 
 		/* request */
-		msg = kiwi_fe_write_query(NULL, query, sizeof(query));
+		if (stress.bind_param) {
+			/* large parameter insert-like load */
+			msg = kiwi_fe_write_prep_stmt(
+				NULL, "select length($1::bytea)",
+				stress.bind_param);
+		} else {
+			msg = kiwi_fe_write_query(NULL, query, sizeof(query));
+		}
 		if (msg == NULL)
 			return;
 		rc = od_write(&client->io, msg);
@@ -210,17 +221,23 @@ static inline void stress_main(void *arg)
 	stress_run = 0;
 
 	/* wait for completion and calculate stats */
+	uint64_t processed = 0;
 	for (i = 0; i < stress->clients; i++) {
 		stress_client_t *client = &clients[i];
 		machine_join(client->coroutine_id);
 		if (client->io.io)
 			machine_io_free(client->io.io);
+		processed += client->processed;
 	}
 	free(clients);
 
 	/* result */
 	od_histogram_print(&stress_histogram, stress->clients,
 			   stress->time_to_run);
+
+	/* total is used to get per transaction numbers, e.g. divide
+	 * syscalls count reported by strace -c -f -p <odyssey pid> */
+	printf("transactions: %" PRIu64 "\n", processed);
 }
 
 int main(int argc, char *argv[])
@@ -239,7 +256,7 @@ int main(int argc, char *argv[])
 	stress.clients = 10;
 
 	int opt;
-	while ((opt = getopt(argc, argv, "d:u:h:p:t:c:")) != -1) {
+	while ((opt = getopt(argc, argv, "d:u:h:p:t:c:eb:")) != -1) {
 		switch (opt) {
 		/* database */
 		case 'd':
@@ -265,9 +282,17 @@ int main(int argc, char *argv[])
 		case 'c':
 			stress.clients = atoi(optarg);
 			break;
+			/* edge-triggered io */
+		case 'e':
+			stress.edge_triggered = 1;
+			break;
+			/* bind parameter size */
+		case 'b':
+			stress.bind_size = atoi(optarg);
+			break;
 		default:
 			printf("PostgreSQL benchmarking.\n\n");
-			printf("usage: %s [duhptc]\n", argv[0]);
+			printf("usage: %s [duhptceb]\n", argv[0]);
 			printf("  \n");
 			printf("  -d <database>   database name\n");
 			printf("  -u <user>       user name\n");
@@ -275,6 +300,8 @@ int main(int argc, char *argv[])
 			printf("  -p <port>       server port\n");
 			printf("  -t <time>       time to run (seconds)\n");
 			printf("  -c <clients>    number of clients\n");
+			printf("  -e              edge-triggered io\n");
+			printf("  -b <bytes>      bind parameter size\n");
 			return 1;
 		}
 	}
@@ -286,8 +313,18 @@ int main(int argc, char *argv[])
 	printf("user:        %s\n", stress.user);
 	printf("host:        %s\n", stress.host);
 	printf("port:        %s\n", stress.port);
+	printf("edge io:     %s\n", stress.edge_triggered ? "yes" : "no");
+	printf("bind size:   %d\n", stress.bind_size);
 	printf("\n");
 
+	if (stress.bind_size > 0) {
+		stress.bind_param = malloc(stress.bind_size + 1);
+		if (stress.bind_param == NULL)
+			return 1;
+		memset(stress.bind_param, 'x', stress.bind_size);
+		stress.bind_param[stress.bind_size] = 0;
+	}
+
 	machinarium_init();
 
 	int64_t machine;
@@ -296,5 +333,6 @@ int main(int argc, char *argv[])
 	int rc = machine_wait(machine);
 
 	machinarium_free();
+	free(stress.bind_param);
 	return rc;
 }
@@ -0,0 +1,69 @@
+#include <machinarium.h>
+#include <odyssey_test.h>
+#include <unistd.h>
+
+static void sleeper(void *arg)
+{
+	(void)arg;
+	machine_sleep(50);
+}
+
+static void busy(void *arg)
+{
+	(void)arg;
+	/* run without yield */
+	usleep(5000);
+}
+
+static void test_coroutine(void *arg)
+{
+	(void)arg;
+	machine_loop_stat_t stat;
+	machine_loop_stat(&stat);
+
+	int64_t id;
+	id = machine_coroutine_create(sleeper, NULL);
+	test(id != -1);
+	machine_sleep(0);
+
+	/* sleeper is waiting on its timer */
+	machine_loop_stat_t current;
+	machine_loop_stat(&current);
+	test(current.count_timer >= 1);
+	test(current.count_switch > stat.count_switch);
+
+	id = machine_coroutine_create(busy, NULL);
+	test(id != -1);
+	machine_join(id);
+
+	machine_loop_stat(&current);
+	test(current.run_max_us >= 5000);
+	test(current.time_run_us >= 5000);
+
+	/* maximums are reset on read */
+	machine_loop_stat(&current);
+	test(current.run_max_us < 5000);
+
+	machine_sleep(100);
+	machine_loop_stat(&current);
+	test(current.count_wait > stat.count_wait);
+	test(current.time_wait_us > stat.time_wait_us);
+	test(current.count_timer == 0);
+
+	machine_stop_current();
+}
+
+void machinarium_test_loop_stat(void)
+{
+	machinarium_init();
+
+	int id;
+	id = machine_create("test", test_coroutine, NULL);
+	test(id != -1);
+
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+}
@@ -0,0 +1,135 @@
+
+#include <machinarium.h>
+#include <odyssey_test.h>
+
+#include <string.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
+static void server(void *arg)
+{
+	(void)arg;
+	machine_io_t *server = machine_io_create();
+	test(server != NULL);
+
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(7778);
+	int rc;
+	rc = machine_bind(server, (struct sockaddr *)&sa,
+			  MM_BINDWITH_SO_REUSEADDR);
+	test(rc == 0);
+
+	machine_io_t *client;
+	rc = machine_accept(server, &client, 16, 0, UINT32_MAX);
+	test(rc == 0);
+
+	rc = machine_set_edge_triggered(client, 1);
+	test(rc == 0);
+	rc = machine_io_attach(client);
+	test(rc == 0);
+	test(machine_edge_triggered(client) == 1);
+
+	int chunk_size = 10 * 1024;
+	int total = 10 * 1024 * 1024;
+	int pos = 0;
+	while (pos < total) {
+		machine_msg_t *msg;
+		msg = machine_msg_create(0);
+		test(msg != NULL);
+		rc = machine_msg_write(msg, NULL, chunk_size);
+		test(rc == 0);
+		memset(machine_msg_data(msg), 'x', chunk_size);
+		rc = machine_write(client, msg, UINT32_MAX);
+		test(rc == 0);
+		pos += chunk_size;
+	}
+
+	rc = machine_close(client);
+	test(rc == 0);
+	machine_io_free(client);
+
+	rc = machine_close(server);
+	test(rc == 0);
+	machine_io_free(server);
+}
+
+static void client(void *arg)
+{
+	(void)arg;
+	machine_io_t *client = machine_io_create();
+	test(client != NULL);
+
+	int rc;
+	rc = machine_set_edge_triggered(client, 1);
+	test(rc == 0);
+
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(7778);
+	rc = machine_connect(client, (struct sockaddr *)&sa, UINT32_MAX);
+	test(rc == 0);
+	test(machine_edge_triggered(client) == 1);
+
+	machine_cond_t *on_read = machine_cond_create();
+	test(on_read != NULL);
+
+	/* relay-like loop: restart read on every iteration and
+	 * drain socket until EAGAIN */
+	char buf[4096];
+	int pos = 0;
+	int eof = 0;
+	while (!eof) {
+		rc = machine_read_start(client, on_read);
+		test(rc == 0);
+		rc = machine_cond_wait(on_read, UINT32_MAX);
+		test(rc == 0);
+		rc = machine_read_stop(client);
+		test(rc == 0);
+		for (;;) {
+			rc = machine_read_raw(client, buf, sizeof(buf));
+			if (rc > 0) {
+				pos += rc;
+				continue;
+			}
+			if (rc == -1 && machine_errno() == EAGAIN)
+				break;
+			eof = 1;
+			break;
+		}
+	}
+	test(pos == 10 * 1024 * 1024);
+
+	machine_cond_free(on_read);
+	rc = machine_close(client);
+	test(rc == 0);
+	machine_io_free(client);
+}
+
+static void test_cs(void *arg)
+{
+	(void)arg;
+	int rc;
+	rc = machine_coroutine_create(server, NULL);
+	test(rc != -1);
+
+	rc = machine_coroutine_create(client, NULL);
+	test(rc != -1);
+}
+
+void machinarium_test_read_edge_triggered(void)
+{
+	machinarium_init();
+
+	int id;
+	id = machine_create("test", test_cs, NULL);
+	test(id != -1);
+
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+}
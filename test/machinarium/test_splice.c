@@ -0,0 +1,194 @@
+
+#include <machinarium.h>
+#include <odyssey_test.h>
+
+#include <string.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
+static int total = 10 * 1024 * 1024;
+
+static machine_io_t *listen_on(int port)
+{
+	machine_io_t *server = machine_io_create();
+	test(server != NULL);
+
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(port);
+	int rc;
+	rc = machine_bind(server, (struct sockaddr *)&sa,
+			  MM_BINDWITH_SO_REUSEADDR);
+	test(rc == 0);
+	return server;
+}
+
+static machine_io_t *connect_to(int port)
+{
+	machine_io_t *client = machine_io_create();
+	test(client != NULL);
+
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(port);
+	int rc;
+	rc = machine_connect(client, (struct sockaddr *)&sa, UINT32_MAX);
+	test(rc == 0);
+	return client;
+}
+
+static void producer(void *arg)
+{
+	(void)arg;
+	machine_io_t *server = listen_on(7778);
+	machine_io_t *client;
+	int rc;
+	rc = machine_accept(server, &client, 16, 1, UINT32_MAX);
+	test(rc == 0);
+
+	int chunk_size = 10 * 1024;
+	int pos = 0;
+	while (pos < total) {
+		machine_msg_t *msg;
+		msg = machine_msg_create(0);
+		test(msg != NULL);
+		rc = machine_msg_write(msg, NULL, chunk_size);
+		test(rc == 0);
+		memset(machine_msg_data(msg), 'x', chunk_size);
+		rc = machine_write(client, msg, UINT32_MAX);
+		test(rc == 0);
+		pos += chunk_size;
+	}
+
+	rc = machine_close(client);
+	test(rc == 0);
+	machine_io_free(client);
+
+	rc = machine_close(server);
+	test(rc == 0);
+	machine_io_free(server);
+}
+
+static void consumer(void *arg)
+{
+	(void)arg;
+	machine_io_t *client = connect_to(7779);
+
+	int pos = 0;
+	while (1) {
+		machine_msg_t *msg;
+		msg = machine_read(client, 1024, UINT32_MAX);
+		if (msg == NULL)
+			break;
+		test(*(char *)machine_msg_data(msg) == 'x');
+		machine_msg_free(msg);
+		pos += 1024;
+	}
+	test(pos == total);
+
+	int rc;
+	rc = machine_close(client);
+	test(rc == 0);
+	machine_io_free(client);
+}
+
+static void proxy(void *arg)
+{
+	(void)arg;
+	machine_io_t *server = listen_on(7779);
+
+	int rc;
+	rc = machine_coroutine_create(consumer, NULL);
+	test(rc != -1);
+
+	machine_io_t *dst;
+	rc = machine_accept(server, &dst, 16, 1, UINT32_MAX);
+	test(rc == 0);
+
+	machine_io_t *src = connect_to(7778);
+	test(machine_splice_supported(src));
+	test(machine_splice_supported(dst));
+
+	machine_splice_t *splice = machine_splice_create();
+	test(splice != NULL);
+
+	machine_cond_t *on_read = machine_cond_create();
+	test(on_read != NULL);
+	machine_cond_t *on_write = machine_cond_create();
+	test(on_write != NULL);
+
+	int pos = 0;
+	while (pos < total) {
+		rc = machine_read_start(src, on_read);
+		test(rc == 0);
+		rc = machine_cond_wait(on_read, UINT32_MAX);
+		test(rc == 0);
+		rc = machine_read_stop(src);
+		test(rc == 0);
+
+		rc = machine_splice_read(splice, src, total - pos);
+		if (rc == -1) {
+			test(machine_errno() == EAGAIN);
+			continue;
+		}
+		test(rc > 0);
+		pos += rc;
+
+		while (machine_splice_pending(splice) > 0) {
+			rc = machine_splice_write(splice, dst);
+			if (rc > 0)
+				continue;
+			test(machine_errno() == EAGAIN);
+			rc = machine_write_start(dst, on_write);
+			test(rc == 0);
+			rc = machine_cond_wait(on_write, UINT32_MAX);
+			test(rc == 0);
+			rc = machine_write_stop(dst);
+			test(rc == 0);
+		}
+	}
+
+	machine_cond_free(on_read);
+	machine_cond_free(on_write);
+	machine_splice_free(splice);
+
+	rc = machine_close(src);
+	test(rc == 0);
+	machine_io_free(src);
+
+	rc = machine_close(dst);
+	test(rc == 0);
+	machine_io_free(dst);
+
+	rc = machine_close(server);
+	test(rc == 0);
+	machine_io_free(server);
+}
+
+static void test_cs(void *arg)
+{
+	(void)arg;
+	int rc;
+	rc = machine_coroutine_create(producer, NULL);
+	test(rc != -1);
+
+	rc = machine_coroutine_create(proxy, NULL);
+	test(rc != -1);
+}
+
+void machinarium_test_splice(void)
+{
+	machinarium_init();
+
+	int id;
+	id = machine_create("test", test_cs, NULL);
+	test(id != -1);
+
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+}
@@ -0,0 +1,106 @@
+#include <machinarium.h>
+#include <odyssey_test.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static int abandoned = 0;
+
+static void task_sum(void *arg)
+{
+	int *value = arg;
+	*value += 1;
+}
+
+static void task_slow(void *arg)
+{
+	(void)arg;
+	usleep(200 * 1000);
+}
+
+static void task_slow_abandon(void *arg)
+{
+	free(arg);
+	__sync_fetch_and_add(&abandoned, 1);
+}
+
+static void ticker(void *arg)
+{
+	int *ticks = arg;
+	while (!machine_cancelled()) {
+		machine_sleep(10);
+		(*ticks)++;
+	}
+}
+
+static void waiter(void *arg)
+{
+	machine_taskmgr_t *executor = arg;
+	int rc;
+	rc = machine_task_run(executor, task_slow, NULL, NULL, UINT32_MAX);
+	test(rc == 0);
+}
+
+static void test_coroutine(void *arg)
+{
+	(void)arg;
+	machine_taskmgr_t *executor;
+	executor = machine_taskmgr_create("test_exec", 2);
+	test(executor != NULL);
+
+	int value = 0;
+	int rc;
+	rc = machine_task_run(executor, task_sum, NULL, &value, UINT32_MAX);
+	test(rc == 0);
+	test(value == 1);
+
+	/* loop keeps running while the task blocks its thread */
+	int ticks = 0;
+	int64_t id;
+	id = machine_coroutine_create(ticker, &ticks);
+	test(id != -1);
+
+	rc = machine_task_run(executor, task_slow, NULL, NULL, UINT32_MAX);
+	test(rc == 0);
+	test(ticks >= 5);
+
+	/* timed out task is abandoned, arg is released by the executor */
+	void *slow_arg = malloc(16);
+	rc = machine_task_run(executor, task_slow, task_slow_abandon, slow_arg,
+			      20);
+	test(rc == -1);
+	test(machine_timedout());
+
+	/* task without abandon callback is waited to the end even
+	 * if the waiter is cancelled, without spinning the loop */
+	ticks = 0;
+	int64_t waiter_id;
+	waiter_id = machine_coroutine_create(waiter, executor);
+	test(waiter_id != -1);
+	machine_sleep(0);
+	machine_cancel(waiter_id);
+	machine_join(waiter_id);
+	test(ticks >= 5);
+
+	machine_cancel(id);
+	machine_join(id);
+
+	machine_taskmgr_free(executor);
+	test(abandoned == 1);
+
+	machine_stop_current();
+}
+
+void machinarium_test_task_executor(void)
+{
+	machinarium_init();
+
+	int id;
+	id = machine_create("test", test_coroutine, NULL);
+	test(id != -1);
+
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+}
@@ -0,0 +1,183 @@
+#include <machinarium.h>
+#include <odyssey_test.h>
+
+#include <string.h>
+#include <arpa/inet.h>
+
+/*
+ * Two server machines share one tls object, a third machine connects
+ * to both with one client tls object: the second handshake must resume
+ * the session (ticket) issued by the other machine.
+ */
+
+static machine_tls_t *server_tls;
+
+static void server(void *arg)
+{
+	int port = (int)(intptr_t)arg;
+	machine_io_t *server = machine_io_create();
+	test(server != NULL);
+
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(port);
+	int rc;
+	rc = machine_bind(server, (struct sockaddr *)&sa,
+			  MM_BINDWITH_SO_REUSEADDR);
+	test(rc == 0);
+
+	machine_io_t *client = NULL;
+	rc = machine_accept(server, &client, 16, 1, UINT32_MAX);
+	test(rc == 0);
+	test(client != NULL);
+
+	rc = machine_set_tls(client, server_tls, UINT32_MAX);
+	if (rc == -1) {
+		printf("%s\n", machine_error(client));
+		test(rc == 0);
+	}
+
+	machine_msg_t *msg;
+	msg = machine_msg_create(0);
+	test(msg != NULL);
+	char text[] = "hello world";
+	rc = machine_msg_write(msg, text, sizeof(text));
+	test(rc == 0);
+
+	rc = machine_write(client, msg, UINT32_MAX);
+	test(rc == 0);
+
+	rc = machine_close(client);
+	test(rc == 0);
+	machine_io_free(client);
+
+	rc = machine_close(server);
+	test(rc == 0);
+	machine_io_free(server);
+}
+
+static void client_session(machine_tls_t *tls, int port)
+{
+	machine_io_t *client = machine_io_create();
+	test(client != NULL);
+
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(port);
+	int rc;
+	/* wait for the server machine to bind */
+	for (;;) {
+		rc = machine_connect(client, (struct sockaddr *)&sa,
+				     UINT32_MAX);
+		if (rc == 0)
+			break;
+		machine_close(client);
+		machine_sleep(10);
+	}
+
+	rc = machine_set_tls(client, tls, UINT32_MAX);
+	if (rc == -1) {
+		printf("%s\n", machine_error(client));
+		test(rc == 0);
+	}
+
+	machine_msg_t *msg;
+	msg = machine_read(client, 12, UINT32_MAX);
+	test(msg != NULL);
+	test(memcmp(machine_msg_data(msg), "hello world", 12) == 0);
+	machine_msg_free(msg);
+
+	msg = machine_read(client, 1, UINT32_MAX);
+	/* eof */
+	test(msg == NULL);
+
+	rc = machine_close(client);
+	test(rc == 0);
+	machine_io_free(client);
+}
+
+static void client(void *arg)
+{
+	(void)arg;
+	machine_tls_t *tls;
+	tls = machine_tls_create();
+	int rc;
+	rc = machine_tls_set_verify(tls, "none");
+	test(rc == 0);
+	rc = machine_tls_set_ca_file(tls, "./machinarium/ca.crt");
+	test(rc == 0);
+	rc = machine_tls_set_cert_file(tls, "./machinarium/client.crt");
+	test(rc == 0);
+	rc = machine_tls_set_key_file(tls, "./machinarium/client.key");
+	test(rc == 0);
+
+	client_session(tls, 7781);
+	client_session(tls, 7782);
+
+	uint64_t resumed, full;
+	machine_tls_stat(tls, &resumed, &full);
+	test(full == 1);
+	test(resumed == 1);
+
+	machine_tls_free(tls);
+}
+
+static void server_tls_create(void *arg)
+{
+	(void)arg;
+	server_tls = machine_tls_create();
+	test(server_tls != NULL);
+	int rc;
+	rc = machine_tls_set_verify(server_tls, "none");
+	test(rc == 0);
+	rc = machine_tls_set_ca_file(server_tls, "./machinarium/ca.crt");
+	test(rc == 0);
+	rc = machine_tls_set_cert_file(server_tls, "./machinarium/server.crt");
+	test(rc == 0);
+	rc = machine_tls_set_key_file(server_tls, "./machinarium/server.key");
+	test(rc == 0);
+}
+
+static void server_tls_free(void *arg)
+{
+	(void)arg;
+	machine_tls_free(server_tls);
+}
+
+void machinarium_test_tls_resume(void)
+{
+	machinarium_set_tls_ticket_lifetime(60);
+	machinarium_init();
+
+	int id;
+	id = machine_create("setup", server_tls_create, NULL);
+	test(id != -1);
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	int server1, server2, client_id;
+	server1 = machine_create("server1", server, (void *)(intptr_t)7781);
+	test(server1 != -1);
+	server2 = machine_create("server2", server, (void *)(intptr_t)7782);
+	test(server2 != -1);
+	client_id = machine_create("client", client, NULL);
+	test(client_id != -1);
+
+	rc = machine_wait(client_id);
+	test(rc != -1);
+	rc = machine_wait(server1);
+	test(rc != -1);
+	rc = machine_wait(server2);
+	test(rc != -1);
+
+	id = machine_create("teardown", server_tls_free, NULL);
+	test(id != -1);
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+	machinarium_set_tls_ticket_lifetime(0);
+}
@@ -0,0 +1,140 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+static void test_auth_cache_password(kiwi_password_t *password, char *value)
+{
+	kiwi_password_init(password);
+	password->password_len = strlen(value) + 1;
+	password->password = strdup(value);
+}
+
+static void test_auth_cache_waiter(void *arg)
+{
+	od_auth_cache_t *cache = arg;
+	kiwi_password_t result;
+	kiwi_password_init(&result);
+	od_auth_cache_entry_t *entry = NULL;
+	test(od_auth_cache_get(cache, "carol", 6, 6, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_WAIT);
+	test(od_auth_cache_wait(cache, entry, UINT32_MAX) == 0);
+	test(od_auth_cache_get(cache, "carol", 6, 6, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_HIT);
+	test(strcmp(result.password, "pass") == 0);
+	kiwi_password_free(&result);
+}
+
+static void test_auth_cache_wait(od_auth_cache_t *cache)
+{
+	kiwi_password_t password;
+	kiwi_password_t result;
+	kiwi_password_init(&result);
+	od_auth_cache_entry_t *entry = NULL;
+
+	/* waiter is woken up by the lookup owner */
+	test(od_auth_cache_get(cache, "carol", 6, 6, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+	int64_t id;
+	id = machine_coroutine_create(test_auth_cache_waiter, cache);
+	test(id != -1);
+	machine_sleep(10);
+	test_auth_cache_password(&password, "pass");
+	od_auth_cache_set(cache, "carol", 6, &password, 1000);
+	kiwi_password_free(&password);
+	machine_join(id);
+
+	/* wait is bounded, entry outlives removal while waited on */
+	test(od_auth_cache_get(cache, "dave", 5, 5, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+	test(od_auth_cache_get(cache, "dave", 5, 5, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_WAIT);
+	test(od_auth_cache_wait(cache, entry, 10) == -1);
+	test(od_auth_cache_get(cache, "dave", 5, 5, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_WAIT);
+	od_auth_cache_abort(cache, "dave", 5);
+	test(od_auth_cache_wait(cache, entry, 10) == 0);
+	test(od_auth_cache_get(cache, "dave", 5, 5, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+	od_auth_cache_abort(cache, "dave", 5);
+}
+
+static void test_auth_cache(void *arg)
+{
+	(void)arg;
+	od_auth_cache_t cache;
+	od_auth_cache_init(&cache);
+
+	kiwi_password_t password;
+	kiwi_password_t result;
+	kiwi_password_init(&result);
+	od_auth_cache_entry_t *entry = NULL;
+
+	/* first lookup owns the key, others wait for it */
+	test(od_auth_cache_get(&cache, "alice", 6, 6, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+	test(od_auth_cache_get(&cache, "alice", 6, 6, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_WAIT);
+
+	test_auth_cache_password(&password, "secret");
+	od_auth_cache_set(&cache, "alice", 6, &password, 100);
+	kiwi_password_free(&password);
+	test(od_auth_cache_wait(&cache, entry, 0) == 0);
+
+	test(od_auth_cache_get(&cache, "alice", 6, 6, &result, 50, &entry) ==
+	     OD_AUTH_CACHE_HIT);
+	test(result.password_len == 7);
+	test(strcmp(result.password, "secret") == 0);
+	kiwi_password_free(&result);
+	kiwi_password_init(&result);
+
+	/* expired entry is looked up again */
+	test(od_auth_cache_get(&cache, "alice", 6, 6, &result, 100, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+	test(result.password == NULL);
+
+	/* failed lookup lets the next client retry */
+	od_auth_cache_abort(&cache, "alice", 6);
+	test(od_auth_cache_get(&cache, "alice", 6, 6, &result, 100, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+
+	/* negative result */
+	od_auth_cache_set(&cache, "alice", 6, NULL, 200);
+	test(od_auth_cache_get(&cache, "alice", 6, 6, &result, 150, &entry) ==
+	     OD_AUTH_CACHE_NEGATIVE);
+
+	/* key with host, invalidated by user name */
+	test(od_auth_cache_get(&cache, "bob\0host", 8, 4, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+	test_auth_cache_password(&password, "md5");
+	od_auth_cache_set(&cache, "bob\0host", 8, &password, 1000);
+	kiwi_password_free(&password);
+	test(od_auth_cache_invalidate(&cache, "bob", 4) == 1);
+	test(od_auth_cache_get(&cache, "bob\0host", 8, 4, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+
+	/* result of lookup invalidated in flight is not cached */
+	test(od_auth_cache_invalidate(&cache, NULL, 0) == 1);
+	test_auth_cache_password(&password, "md5");
+	od_auth_cache_set(&cache, "bob\0host", 8, &password, 1000);
+	kiwi_password_free(&password);
+	test(od_auth_cache_get(&cache, "bob\0host", 8, 4, &result, 0, &entry) ==
+	     OD_AUTH_CACHE_MISS);
+
+	test_auth_cache_wait(&cache);
+
+	od_auth_cache_free(&cache);
+}
+
+void odyssey_test_auth_cache(void)
+{
+	machinarium_init();
+
+	int id;
+	id = machine_create("test", test_auth_cache, NULL);
+	test(id != -1);
+
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+}
@@ -0,0 +1,30 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+void odyssey_test_hgram(void)
+{
+	/* every value is not above its bucket bound and above previous one */
+	uint64_t value;
+	for (value = 0; value < 100000; value++) {
+		int bucket = od_hgram_bucket(value);
+		test(value < od_hgram_bucket_max(bucket));
+		if (bucket > 2) {
+			test(value >= od_hgram_bucket_max(bucket - 1));
+		}
+	}
+
+	od_hgram_t hgram;
+	od_hgram_init(&hgram);
+	test(od_hgram_quantile(&hgram, 0.99) == 0);
+	int i;
+	for (i = 0; i < 99; i++)
+		od_hgram_add(&hgram, 100);
+	od_hgram_add(&hgram, 5000);
+	test(hgram.count == 100);
+	test(hgram.sum == 99 * 100 + 5000);
+	test(hgram.max == 5000);
+	/* 100 is in [96, 128) */
+	test(od_hgram_quantile(&hgram, 0.5) == 128);
+	test(od_hgram_quantile(&hgram, 0.99) == 6144);
+	test(od_hgram_quantile(&hgram, 1.0) == 6144);
+}
@@ -0,0 +1,67 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+void odyssey_test_ldap_cache(void)
+{
+	od_ldap_cache_t cache;
+	od_ldap_cache_init(&cache);
+
+	int count;
+	uint64_t hits, misses;
+
+	/* nothing cached yet */
+	test(od_ldap_cache_check(&cache, "alice", 6, "secret", 6, 0) == 0);
+
+	od_ldap_cache_add(&cache, "alice", 6, "secret", 6, 100, 2);
+	test(od_ldap_cache_check(&cache, "alice", 6, "secret", 6, 50) == 1);
+	test(od_ldap_cache_check(&cache, "alice", 6, "wrong", 5, 50) == 0);
+	test(od_ldap_cache_check(&cache, "alice", 6, "secre", 5, 50) == 0);
+
+	/* password is never stored */
+	od_ldap_cache_entry_t *entry;
+	entry = od_container_of(cache.order.next, od_ldap_cache_entry_t,
+				link_order);
+	test(memmem(entry, sizeof(*entry) + entry->user_len, "secret", 6) ==
+	     NULL);
+
+	/* expired */
+	test(od_ldap_cache_check(&cache, "alice", 6, "secret", 6, 100) == 0);
+	od_ldap_cache_stat(&cache, &count, &hits, &misses);
+	test(count == 0);
+	test(hits == 1);
+	test(misses == 4);
+
+	/* oldest entry is replaced when full */
+	od_ldap_cache_add(&cache, "alice", 6, "a", 1, 100, 2);
+	od_ldap_cache_add(&cache, "bob", 4, "b", 1, 100, 2);
+	od_ldap_cache_add(&cache, "carol", 6, "c", 1, 100, 2);
+	od_ldap_cache_stat(&cache, &count, &hits, &misses);
+	test(count == 2);
+	test(od_ldap_cache_check(&cache, "alice", 6, "a", 1, 0) == 0);
+	test(od_ldap_cache_check(&cache, "bob", 4, "b", 1, 0) == 1);
+
+	/* new password of the user replaces the old one */
+	od_ldap_cache_add(&cache, "bob", 4, "b2", 2, 100, 2);
+	test(od_ldap_cache_check(&cache, "bob", 4, "b", 1, 0) == 0);
+	test(od_ldap_cache_check(&cache, "bob", 4, "b2", 2, 0) == 1);
+
+	/* wrong password keeps the verified one */
+	test(od_ldap_cache_reject(&cache, "bob", 4, "b3", 2) == 0);
+	test(od_ldap_cache_check(&cache, "bob", 4, "b2", 2, 0) == 1);
+	/* cached password rejected by LDAP is dropped */
+	test(od_ldap_cache_reject(&cache, "bob", 4, "b2", 2) == 1);
+	test(od_ldap_cache_check(&cache, "bob", 4, "b2", 2, 0) == 0);
+	od_ldap_cache_add(&cache, "bob", 4, "b2", 2, 100, 2);
+
+	test(od_ldap_cache_invalidate(&cache, "bob", 4) == 1);
+	test(od_ldap_cache_check(&cache, "bob", 4, "b2", 2, 0) == 0);
+	test(od_ldap_cache_invalidate(&cache, NULL, 0) == 1);
+	od_ldap_cache_stat(&cache, &count, &hits, &misses);
+	test(count == 0);
+
+	/* zero size disables */
+	od_ldap_cache_add(&cache, "alice", 6, "a", 1, 100, 0);
+	test(od_ldap_cache_check(&cache, "alice", 6, "a", 1, 0) == 0);
+
+	od_ldap_cache_free(&cache);
+}
@@ -0,0 +1,299 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+#include <arpa/inet.h>
+
+#define TEST_LOGGER_LINES 1000
+
+static int test_logger_lines(char *path)
+{
+	char buf[128 * 1024];
+	int fd = open(path, O_RDONLY);
+	test(fd != -1);
+	int lines = 0;
+	ssize_t rc;
+	while ((rc = read(fd, buf, sizeof(buf))) > 0) {
+		ssize_t i;
+		for (i = 0; i < rc; i++)
+			if (buf[i] == '\n')
+				lines++;
+	}
+	close(fd);
+	return lines;
+}
+
+/* lines of a single thread keep their order */
+static void test_logger_ordered(char *path)
+{
+	FILE *file = fopen(path, "r");
+	test(file != NULL);
+	char line[128];
+	int prev = -1;
+	while (fgets(line, sizeof(line), file)) {
+		int n;
+		test(sscanf(line, "info line %d", &n) == 1);
+		test(n > prev);
+		prev = n;
+	}
+	fclose(file);
+}
+
+static volatile int test_logger_done;
+
+static void test_logger_drain(void *arg)
+{
+	od_logger_t *logger = arg;
+	while (!test_logger_done) {
+		od_logger_flush(logger);
+		machine_sleep(1);
+	}
+	/* free pending wakeup messages within machine context */
+	machine_channel_free(logger->task_channel);
+}
+
+static void test_logger_write(void *arg)
+{
+	od_logger_t *logger = arg;
+	int i;
+	for (i = 0; i < TEST_LOGGER_LINES; i++)
+		od_log(logger, "test", NULL, NULL, "line %d", i);
+	od_logger_release(logger);
+}
+
+static void test_od_logger_overflow(od_logger_overflow_t overflow,
+				    int expected)
+{
+	char path[] = "/tmp/odyssey_test_logger_XXXXXX";
+	int fd = mkstemp(path);
+	test(fd != -1);
+	close(fd);
+
+	od_pid_t pid;
+	od_pid_init(&pid);
+	od_logger_t logger;
+	od_logger_init(&logger, &pid);
+	od_logger_set_stdout(&logger, 0);
+	od_logger_set_format(&logger, "%l %m\n");
+	od_logger_set_queue(&logger, 4096, overflow);
+	test(od_logger_open(&logger, path) == 0);
+
+	/* drain queues from the test instead of logger machine */
+	logger.task_channel = machine_channel_create();
+	test(logger.task_channel != NULL);
+	logger.loaded = 1;
+	test_logger_done = 0;
+
+	int drain_id;
+	drain_id = machine_create("test_drain", test_logger_drain, &logger);
+	test(drain_id != -1);
+	int id;
+	id = machine_create("test", test_logger_write, &logger);
+	test(id != -1);
+	test(machine_wait(id) != -1);
+	test_logger_done = 1;
+	test(machine_wait(drain_id) != -1);
+	test(logger.queues == NULL);
+
+	od_logger_flush(&logger);
+	uint64_t written = 0;
+	uint64_t dropped = 0;
+	uint64_t spilled = 0;
+	uint64_t blocked = 0;
+	od_logger_stat(&logger, &written, &dropped, &spilled, &blocked);
+	test(written + dropped + spilled == TEST_LOGGER_LINES);
+	if (overflow != OD_LOGGER_DROP) {
+		test(dropped == 0);
+	}
+	if (overflow != OD_LOGGER_SPILL) {
+		test(spilled == 0);
+	}
+
+	int lines = test_logger_lines(path);
+	if (expected) {
+		test(lines == expected);
+	} else {
+		test(lines == (int)(written + spilled));
+	}
+	test_logger_ordered(path);
+
+	od_logger_close(&logger);
+	unlink(path);
+}
+
+static void test_od_logger_format(void)
+{
+	char path[] = "/tmp/odyssey_test_logger_XXXXXX";
+	int fd = mkstemp(path);
+	test(fd != -1);
+
+	od_pid_t pid;
+	od_pid_init(&pid);
+	od_logger_t logger;
+	od_logger_init(&logger, &pid);
+	od_logger_set_stdout(&logger, 0);
+	test(od_logger_set_format(&logger,
+				  "%l (%c) %u %h:%r %m %% %q \\\\ \\x\\n") == 0);
+	test(od_logger_open(&logger, path) == 0);
+	od_log(&logger, "test", NULL, NULL, "line %d", 42);
+	od_logger_close(&logger);
+
+	char buf[256];
+	int rc = read(fd, buf, sizeof(buf) - 1);
+	test(rc > 0);
+	buf[rc] = 0;
+	test(strcmp(buf, "info (test) none none:none line 42 % %q \\ \\x\n") ==
+	     0);
+	close(fd);
+	unlink(path);
+}
+
+static int test_logger_read(od_logger_t *logger, od_logger_output_t output,
+			    void *client, char *msg, char *buf, int size)
+{
+	char path[] = "/tmp/odyssey_test_logger_XXXXXX";
+	int fd = mkstemp(path);
+	test(fd != -1);
+	test(od_logger_open(logger, path) == 0);
+	od_logger_set_output(logger, output);
+	od_log_duration(logger, "test", client, NULL, 42, "%s", msg);
+	od_logger_close(logger);
+	int rc = read(fd, buf, size - 1);
+	test(rc > 0);
+	buf[rc] = 0;
+	close(fd);
+	unlink(path);
+	return rc;
+}
+
+static void test_od_logger_structured(void)
+{
+	od_pid_t pid;
+	od_pid_init(&pid);
+	od_logger_t logger;
+	od_logger_init(&logger, &pid);
+	od_logger_set_stdout(&logger, 0);
+
+	od_client_t client;
+	od_client_init(&client);
+	client.id.id_prefix = "c";
+	memset(client.id.id, 'f', sizeof(client.id.id));
+	strcpy(client.peer_host, "127.0.0.1");
+	strcpy(client.peer_port, "5432");
+
+	char buf[2 * OD_LOGLINE_MAXLEN];
+	test_logger_read(&logger, OD_LOGGER_JSON, &client, "a \"b\"\n\x01",
+			 buf, sizeof(buf));
+	test(strncmp(buf, "{\"time\":\"", 9) == 0);
+	test(strstr(buf, "\"level\":\"info\",\"context\":\"test\","
+			 "\"client\":\"cffffffffffff\"") != NULL);
+	char *fields = strstr(buf, "\"host\"");
+	test(fields != NULL);
+	test(strcmp(fields, "\"host\":\"127.0.0.1\",\"port\":\"5432\","
+			    "\"duration_us\":42,"
+			    "\"msg\":\"a \\\"b\\\"\\n\\u0001\"}\n") == 0);
+
+	test_logger_read(&logger, OD_LOGGER_LOGFMT, NULL, "x=1", buf,
+			 sizeof(buf));
+	test(strncmp(buf, "time=\"", 6) == 0);
+	fields = strstr(buf, " level=");
+	test(fields != NULL);
+	test(strcmp(fields, " level=\"info\" context=\"test\" "
+			    "duration_us=42 msg=\"x=1\"\n") == 0);
+
+	/* line is bounded and still closed */
+	char msg[OD_LOGLINE_MAXLEN];
+	memset(msg, '"', sizeof(msg) - 1);
+	msg[sizeof(msg) - 1] = 0;
+	int len = test_logger_read(&logger, OD_LOGGER_JSON, &client, msg, buf,
+				   sizeof(buf));
+	test(len <= OD_LOGLINE_MAXLEN);
+	test(strcmp(buf + len - 4, "\\\"\"}\n") == 0 ||
+	     strcmp(buf + len - 3, "\"}\n") == 0);
+}
+
+#define TEST_LOGGER_BENCH_LINES 200000
+
+static void test_logger_bench_server(void *arg)
+{
+	machine_io_t *server = arg;
+	machine_io_t *client;
+	test(machine_accept(server, &client, 16, 1, UINT32_MAX) == 0);
+	machine_close(client);
+	machine_io_free(client);
+}
+
+static void test_logger_bench(void *arg)
+{
+	(void)arg;
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(7790);
+
+	machine_io_t *server = machine_io_create();
+	test(server != NULL);
+	test(machine_bind(server, (struct sockaddr *)&sa,
+			  MM_BINDWITH_SO_REUSEADDR) == 0);
+	int64_t id;
+	id = machine_coroutine_create(test_logger_bench_server, server);
+	test(id != -1);
+	/* let server start listening */
+	machine_sleep(0);
+
+	od_client_t client;
+	od_client_init(&client);
+	client.io.io = machine_io_create();
+	test(client.io.io != NULL);
+	test(machine_connect(client.io.io, (struct sockaddr *)&sa,
+			     UINT32_MAX) == 0);
+	machine_join(id);
+	od_getpeer(client.io.io, client.peer_host, sizeof(client.peer_host),
+		   client.peer_port, sizeof(client.peer_port));
+
+	od_pid_t pid;
+	od_pid_init(&pid);
+	od_logger_t logger;
+	od_logger_init(&logger, &pid);
+	od_logger_set_stdout(&logger, 0);
+	od_logger_set_format(&logger, "%p %t.%e %l (%c) %i %h:%r %m\n");
+	test(od_logger_open(&logger, "/dev/null") == 0);
+
+	struct timespec start;
+	struct timespec stop;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	int i;
+	for (i = 0; i < TEST_LOGGER_BENCH_LINES; i++)
+		od_log(&logger, "query", &client, NULL, "%s",
+		       "select 1 from pg_class where oid = $1");
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+	od_logger_close(&logger);
+
+	uint64_t ns = (stop.tv_sec - start.tv_sec) * 1000000000ULL +
+		      stop.tv_nsec - start.tv_nsec;
+	printf("[%d ns/line] ", (int)(ns / TEST_LOGGER_BENCH_LINES));
+	fflush(stdout);
+
+	machine_close(client.io.io);
+	machine_io_free(client.io.io);
+	machine_close(server);
+	machine_io_free(server);
+}
+
+void odyssey_test_logger(void)
+{
+	machinarium_init();
+
+	test_od_logger_format();
+	test_od_logger_structured();
+
+	int id;
+	id = machine_create("test", test_logger_bench, NULL);
+	test(id != -1);
+	test(machine_wait(id) != -1);
+
+	test_od_logger_overflow(OD_LOGGER_SPILL, TEST_LOGGER_LINES);
+	test_od_logger_overflow(OD_LOGGER_BLOCK, TEST_LOGGER_LINES);
+	test_od_logger_overflow(OD_LOGGER_DROP, 0);
+
+	machinarium_free();
+}
@@ -0,0 +1,138 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+static void test_params_add(kiwi_params_t *params, char *name, char *value)
+{
+	kiwi_param_t *param;
+	param = kiwi_param_allocate(name, strlen(name) + 1, value,
+				    strlen(value) + 1);
+	test(param != NULL);
+	kiwi_params_add(params, param);
+}
+
+/* encode params one by one, the way it was done for every client */
+static machine_msg_t *test_params_expected(kiwi_params_t *params,
+					   kiwi_vars_t *vars)
+{
+	machine_msg_t *stream = machine_msg_create(0);
+	test(stream != NULL);
+	kiwi_param_t *param = params->list;
+	for (; param; param = param->next) {
+		kiwi_var_type_t type;
+		type = kiwi_var_find(kiwi_param_name(param), param->name_len);
+		kiwi_var_t *var = kiwi_vars_get(vars, type);
+		if (var)
+			stream = kiwi_be_write_parameter_status(
+				stream, var->name, var->name_len, var->value,
+				var->value_len);
+		else
+			stream = kiwi_be_write_parameter_status(
+				stream, kiwi_param_name(param),
+				param->name_len, kiwi_param_value(param),
+				param->value_len);
+		test(stream != NULL);
+	}
+	return stream;
+}
+
+static void test_params_compare(kiwi_params_lock_t *pl, kiwi_vars_t *vars)
+{
+	machine_msg_t *expected;
+	expected = test_params_expected(&pl->params, vars);
+	machine_msg_t *msg;
+	msg = kiwi_params_lock_status_msg(pl, vars);
+	test(msg != NULL);
+	test(machine_msg_size(msg) == machine_msg_size(expected));
+	test(memcmp(machine_msg_data(msg), machine_msg_data(expected),
+		    machine_msg_size(msg)) == 0);
+	machine_msg_free(msg);
+	machine_msg_free(expected);
+}
+
+static void test_params_status(void *arg)
+{
+	(void)arg;
+
+	kiwi_params_lock_t pl;
+	kiwi_params_lock_init(&pl);
+
+	/* empty params are never cached */
+	kiwi_params_t params;
+	kiwi_params_init(&params);
+	test(kiwi_params_lock_set_once(&pl, &params) == 0);
+	test(pl.status == NULL);
+
+	test_params_add(&params, "server_version", "15.4");
+	test_params_add(&params, "client_encoding", "UTF8");
+	test_params_add(&params, "DateStyle", "ISO, MDY");
+	test_params_add(&params, "integer_datetimes", "on");
+	test_params_add(&params, "TimeZone", "UTC");
+	test_params_add(&params, "application_name", "");
+	test(kiwi_params_lock_set_once(&pl, &params) == 1);
+	test(pl.status_count == 4);
+
+	/* set only once */
+	kiwi_params_t again;
+	kiwi_params_init(&again);
+	test_params_add(&again, "server_version", "16.0");
+	test(kiwi_params_lock_set_once(&pl, &again) == 0);
+	kiwi_params_free(&again);
+
+	kiwi_vars_t vars;
+	kiwi_vars_init(&vars);
+	test_params_compare(&pl, &vars);
+
+	/* patch first, middle and last known variables */
+	kiwi_vars_set(&vars, KIWI_VAR_APPLICATION_NAME, "psql", 5);
+	test_params_compare(&pl, &vars);
+	kiwi_vars_set(&vars, KIWI_VAR_DATESTYLE, "Postgres, DMY", 14);
+	test_params_compare(&pl, &vars);
+	kiwi_vars_set(&vars, KIWI_VAR_CLIENT_ENCODING, "LATIN1", 7);
+	test_params_compare(&pl, &vars);
+
+	/* variables missing in params are not sent */
+	kiwi_vars_set(&vars, KIWI_VAR_SEARCH_PATH, "public", 7);
+	test_params_compare(&pl, &vars);
+
+	/* same params reported by a new server are kept */
+	kiwi_params_t same;
+	kiwi_params_init(&same);
+	test_params_add(&same, "application_name", "");
+	test_params_add(&same, "TimeZone", "UTC");
+	test_params_add(&same, "integer_datetimes", "on");
+	test_params_add(&same, "DateStyle", "ISO, MDY");
+	test_params_add(&same, "client_encoding", "UTF8");
+	test_params_add(&same, "server_version", "15.4");
+	test(kiwi_params_lock_update(&pl, &same) == 0);
+	kiwi_params_free(&same);
+
+	/* changed params replace status block */
+	kiwi_params_t changed;
+	kiwi_params_init(&changed);
+	test_params_add(&changed, "server_version", "16.0");
+	test_params_add(&changed, "client_encoding", "UTF8");
+	test_params_add(&changed, "TimeZone", "UTC");
+	test(kiwi_params_lock_update(&pl, &changed) == 1);
+	test(pl.status_count == 2);
+	test(kiwi_params_lock_count(&pl) == 3);
+	test_params_compare(&pl, &vars);
+	kiwi_vars_init(&vars);
+	test_params_compare(&pl, &vars);
+
+	kiwi_params_lock_free(&pl);
+}
+
+void odyssey_test_params_status(void)
+{
+	machinarium_init();
+
+	int id;
+	id = machine_create("test", test_params_status, NULL);
+	test(id != -1);
+
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+}
@@ -0,0 +1,176 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+static uint64_t test_normalize(char *query, char *expected)
+{
+	char dest[OD_QUERY_STATS_TEXT_MAX];
+	int dest_len;
+	uint64_t fingerprint;
+	fingerprint = od_query_stats_normalize(query, strlen(query) + 1, dest,
+					       sizeof(dest), &dest_len);
+	test(dest_len == (int)strlen(expected));
+	test(memcmp(dest, expected, dest_len) == 0);
+	return fingerprint;
+}
+
+static void test_od_query_stats_normalize(void)
+{
+	uint64_t a, b;
+	a = test_normalize("SELECT * FROM t WHERE id = 42 AND x = 'a''b'",
+			   "select * from t where id = ? and x = ?");
+	b = test_normalize("select *  from t\n where id=7 and x = E'\\'' ;",
+			   "select * from t where id=? and x = ? ;");
+	test(a != b);
+	b = test_normalize("  select * from t -- comment\n"
+			   "where /* c */ id = 1.5e-3 and x = $$q$$",
+			   "select * from t where id = ? and x = ?");
+	test(a == b);
+	test_normalize("select t1.c2, \"Col 1\" from t1 where a = $1",
+		       "select t1.c2, \"Col 1\" from t1 where a = $1");
+	test_normalize("insert into t values (-1, x'ff', $tag$a$b$tag$)",
+		       "insert into t values (-?, ?, ?)");
+
+	/* text is bounded, fingerprint covers whole query */
+	char query[2048];
+	memset(query, 'a', sizeof(query) - 2);
+	query[sizeof(query) - 2] = 'b';
+	query[sizeof(query) - 1] = 0;
+	char dest[16];
+	int dest_len;
+	a = od_query_stats_normalize(query, sizeof(query), dest, sizeof(dest),
+				     &dest_len);
+	test(dest_len == (int)sizeof(dest));
+	query[sizeof(query) - 2] = 'c';
+	b = od_query_stats_normalize(query, sizeof(query), dest, sizeof(dest),
+				     &dest_len);
+	test(a != b);
+}
+
+static void test_od_query_stats_rows(void)
+{
+	char data[64];
+	char *tags[] = { "INSERT 0 5", "SELECT 123", "BEGIN", "FETCH 0" };
+	uint64_t rows[] = { 5, 123, 0, 0 };
+	int i;
+	for (i = 0; i < 4; i++) {
+		int size = sizeof(kiwi_header_t) + strlen(tags[i]) + 1;
+		memcpy(data + sizeof(kiwi_header_t), tags[i],
+		       strlen(tags[i]) + 1);
+		test(od_query_stats_rows(data, size) == rows[i]);
+	}
+}
+
+static int test_query_stats_cb(od_query_stats_entry_t *entry, void **argv)
+{
+	od_query_stats_entry_t *entries = argv[0];
+	int *count = argv[1];
+	entries[(*count)++] = *entry;
+	return 0;
+}
+
+static void test_od_query_stats_table(void)
+{
+	od_query_stats_t stats;
+	od_query_stats_init(&stats);
+	test(od_query_stats_set_size(&stats, 2) == 0);
+
+	int i;
+	for (i = 0; i < 100; i++)
+		od_query_stats_add(&stats, 1, "user", "db", "q1", 2, 10, 1, 100);
+	od_query_stats_add(&stats, 1, "user2", "db", "q1", 2, 1000, 0, 0);
+	od_query_stats_merge(&stats);
+	/* least called entry is evicted */
+	od_query_stats_add(&stats, 2, "user", "db", "q2", 2, 5, 0, 0);
+	od_query_stats_merge(&stats);
+
+	od_query_stats_entry_t entries[2];
+	int count = 0;
+	void *argv[] = { entries, &count };
+	test(od_query_stats_foreach(&stats, test_query_stats_cb, argv) == 0);
+	test(count == 2);
+	/* sorted by total time */
+	test(entries[0].fingerprint == 1);
+	test(strcmp(entries[0].user, "user") == 0);
+	test(entries[0].calls == 100);
+	test(entries[0].time_us == 1000);
+	test(entries[0].rows == 100);
+	test(entries[0].bytes == 10000);
+	test(od_query_stats_quantile(&entries[0], 0.99) == 12);
+	test(entries[1].fingerprint == 2);
+	test(entries[1].text_len == 2);
+	test(memcmp(entries[1].text, "q2", 2) == 0);
+	test(stats.global.evicted == 1);
+
+	od_query_stats_free(&stats);
+}
+
+static void test_od_query_stats_pipeline(void)
+{
+	od_query_stats_pipeline_t pipeline;
+	od_query_stats_pipeline_init(&pipeline);
+	test(od_query_stats_pipeline_head(&pipeline) == NULL);
+
+	/* Execute(s1) Execute(s2) Sync Query */
+	od_query_stats_exec_t *exec;
+	exec = od_query_stats_pipeline_push(&pipeline,
+					    OD_QUERY_STATS_EXEC_EXTENDED, 1);
+	test(exec != NULL);
+	od_query_stats_stmt_set(&exec->stmt, "select 1", 9);
+	exec = od_query_stats_pipeline_push(&pipeline,
+					    OD_QUERY_STATS_EXEC_EXTENDED, 2);
+	test(exec != NULL);
+	od_query_stats_stmt_set(&exec->stmt, "select 'a'", 11);
+	test(od_query_stats_pipeline_push(&pipeline, OD_QUERY_STATS_EXEC_SYNC,
+					  3) != NULL);
+	test(od_query_stats_pipeline_push(&pipeline,
+					  OD_QUERY_STATS_EXEC_SIMPLE, 4) != NULL);
+	test(pipeline.count == 4);
+
+	exec = od_query_stats_pipeline_head(&pipeline);
+	test(exec->start_us == 1);
+	test(exec->stmt.text_len == 8);
+	test(memcmp(exec->stmt.text, "select ?", 8) == 0);
+	uint64_t fingerprint = exec->stmt.fingerprint;
+	od_query_stats_pipeline_pop(&pipeline);
+
+	/* same normalized text */
+	exec = od_query_stats_pipeline_head(&pipeline);
+	test(exec->start_us == 2);
+	test(exec->stmt.fingerprint == fingerprint);
+	od_query_stats_pipeline_pop(&pipeline);
+
+	exec = od_query_stats_pipeline_head(&pipeline);
+	test(exec->type == OD_QUERY_STATS_EXEC_SYNC);
+	test(exec->stmt.text_len == 0);
+	od_query_stats_pipeline_pop(&pipeline);
+	od_query_stats_pipeline_pop(&pipeline);
+	test(od_query_stats_pipeline_head(&pipeline) == NULL);
+
+	/* ring wraps around, overflow is not tracked */
+	int i;
+	for (i = 0; i < OD_QUERY_STATS_PIPELINE; i++)
+		test(od_query_stats_pipeline_push(
+			     &pipeline, OD_QUERY_STATS_EXEC_EXTENDED, i) != NULL);
+	test(od_query_stats_pipeline_push(&pipeline, OD_QUERY_STATS_EXEC_SYNC,
+					  0) == NULL);
+	for (i = 0; i < OD_QUERY_STATS_PIPELINE; i++) {
+		exec = od_query_stats_pipeline_head(&pipeline);
+		test(exec->start_us == (uint64_t)i);
+		od_query_stats_pipeline_pop(&pipeline);
+	}
+	test(pipeline.count == 0);
+
+	od_query_stats_pipeline_push(&pipeline, OD_QUERY_STATS_EXEC_SYNC, 0);
+	od_query_stats_pipeline_reset(&pipeline);
+	test(od_query_stats_pipeline_head(&pipeline) == NULL);
+
+	od_query_stats_pipeline_free(&pipeline);
+}
+
+void odyssey_test_query_stats(void)
+{
+	test_od_query_stats_normalize();
+	test_od_query_stats_rows();
+	test_od_query_stats_table();
+	test_od_query_stats_pipeline();
+}
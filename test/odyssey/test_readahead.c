@@ -0,0 +1,187 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+static inline void fill(od_readahead_t *readahead)
+{
+	test(od_readahead_ensure(readahead) == 0);
+	int left = od_readahead_left(readahead);
+	struct iovec iov[2];
+	test(od_readahead_iov(readahead, iov) == 1);
+	test((int)iov[0].iov_len == left);
+	memset(iov[0].iov_base, 'x', left);
+	od_readahead_pos_advance(readahead, left);
+	od_readahead_pos_read_advance(readahead, left);
+}
+
+void test_od_readahead_adaptive()
+{
+	od_readahead_t readahead;
+	od_readahead_init(&readahead);
+	od_readahead_prepare(&readahead, 8192);
+
+	/* no memory until first read */
+	test(readahead.buf == NULL);
+	test(readahead.size == OD_READAHEAD_SIZE_MIN);
+
+	/* streaming reads make buffer grow up to the limit */
+	int i;
+	for (i = 0; i < 8; i++) {
+		fill(&readahead);
+		od_readahead_release(&readahead);
+		test(readahead.buf == NULL);
+	}
+	test(readahead.size == 8192);
+
+	/* small reads shrink it back */
+	for (i = 0; i < 8 * OD_READAHEAD_SHRINK_AFTER; i++) {
+		test(od_readahead_ensure(&readahead) == 0);
+		od_readahead_pos_advance(&readahead, 16);
+		od_readahead_pos_read_advance(&readahead, 16);
+		od_readahead_release(&readahead);
+	}
+	test(readahead.size == OD_READAHEAD_SIZE_MIN);
+
+	/* unprocessed data is never released */
+	test(od_readahead_ensure(&readahead) == 0);
+	od_readahead_pos_advance(&readahead, 3);
+	od_readahead_release(&readahead);
+	test(readahead.buf != NULL);
+	od_readahead_reuse(&readahead);
+	test(od_readahead_unread(&readahead) == 3);
+
+	od_readahead_free(&readahead);
+}
+
+static inline void write_ring(od_readahead_t *readahead, char *data, int size)
+{
+	struct iovec iov[2];
+	int iovc = od_readahead_iov(readahead, iov);
+	int pos = 0;
+	int i;
+	for (i = 0; i < iovc && pos < size; i++) {
+		int chunk = iov[i].iov_len;
+		if (chunk > size - pos)
+			chunk = size - pos;
+		memcpy(iov[i].iov_base, data + pos, chunk);
+		pos += chunk;
+	}
+	test(pos == size);
+	od_readahead_pos_advance(readahead, size);
+}
+
+void test_od_readahead_ring()
+{
+	od_readahead_t readahead;
+	od_readahead_init(&readahead);
+	od_readahead_prepare(&readahead, OD_READAHEAD_SIZE_MIN);
+	test(od_readahead_ensure(&readahead) == 0);
+	char *buf = readahead.buf;
+	int size = readahead.size;
+
+	/* processed data is kept until reuse, unread is never moved */
+	char data[OD_READAHEAD_SIZE_MIN];
+	memset(data, 'a', sizeof(data));
+	write_ring(&readahead, data, size - 2);
+	od_readahead_pos_read_advance(&readahead, size - 4);
+	test(od_readahead_left(&readahead) == 2);
+	od_readahead_reuse(&readahead);
+	test(od_readahead_unread(&readahead) == 2);
+	test(od_readahead_pos_read(&readahead) == buf + size - 4);
+	test(od_readahead_left(&readahead) == size - 2);
+
+	/* both free spans are used by a single read */
+	struct iovec iov[2];
+	test(od_readahead_iov(&readahead, iov) == 2);
+	test(iov[0].iov_base == buf + size - 2 && iov[0].iov_len == 2);
+	test(iov[1].iov_base == buf && (int)iov[1].iov_len == size - 4);
+
+	/* header wrapped around the ring end is seen contiguous */
+	kiwi_header_t header;
+	header.type = 'Q';
+	header.len = htonl(sizeof(uint32_t) + 1);
+	char msg[sizeof(header) + 1];
+	memcpy(msg, &header, sizeof(header));
+	msg[sizeof(header)] = 'x';
+	write_ring(&readahead, msg, sizeof(msg));
+	od_readahead_pos_read_advance(&readahead, 2);
+	test(od_readahead_read_span(&readahead) == OD_READAHEAD_TAIL);
+	test(memcmp(od_readahead_pos_read(&readahead), msg, sizeof(header)) ==
+	     0);
+	od_readahead_pos_read_advance(&readahead, sizeof(header));
+	test(od_readahead_read_span(&readahead) == 1);
+	test(*od_readahead_pos_read(&readahead) == 'x');
+	od_readahead_pos_read_advance(&readahead, 1);
+	test(od_readahead_unread(&readahead) == 0);
+	test(readahead.buf == buf);
+
+	od_readahead_free(&readahead);
+}
+
+void test_od_readahead_idle_memory()
+{
+	int count = 10000;
+	od_readahead_t *list = malloc(sizeof(od_readahead_t) * count);
+	test(list != NULL);
+
+	int64_t used, cached, used_start, cached_start;
+	od_readahead_stat(&used_start, &cached_start);
+
+	/* every client sends a query and becomes idle */
+	int i;
+	for (i = 0; i < count; i++) {
+		od_readahead_init(&list[i]);
+		od_readahead_prepare(&list[i], 8192);
+		test(od_readahead_ensure(&list[i]) == 0);
+		od_readahead_pos_advance(&list[i], 64);
+		od_readahead_pos_read_advance(&list[i], 64);
+		od_readahead_release(&list[i]);
+	}
+
+	od_readahead_stat(&used, &cached);
+	used -= used_start;
+	cached -= cached_start;
+	fprintf(stdout, "[%" PRIi64 " bytes per idle client, %" PRIi64
+			" cached] ",
+		used / count, cached);
+	test(used == 0);
+
+	for (i = 0; i < count; i++)
+		od_readahead_free(&list[i]);
+	free(list);
+}
+
+static void *test_od_readahead_put(void *arg)
+{
+	od_readahead_free(arg);
+	return NULL;
+}
+
+void test_od_readahead_cross_thread()
+{
+	int64_t used, cached, used_start, cached_start;
+	od_readahead_stat(&used_start, &cached_start);
+
+	/* connection is read by one thread and freed by another */
+	od_readahead_t readahead;
+	od_readahead_init(&readahead);
+	od_readahead_prepare(&readahead, 8192);
+	test(od_readahead_ensure(&readahead) == 0);
+	od_readahead_stat(&used, &cached);
+	test(used > used_start);
+
+	pthread_t thread;
+	test(pthread_create(&thread, NULL, test_od_readahead_put,
+			    &readahead) == 0);
+	test(pthread_join(thread, NULL) == 0);
+
+	od_readahead_stat(&used, &cached);
+	test(used == used_start);
+}
+
+void odyssey_test_readahead(void)
+{
+	test_od_readahead_adaptive();
+	test_od_readahead_ring();
+	test_od_readahead_idle_memory();
+	test_od_readahead_cross_thread();
+}
@@ -0,0 +1,411 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+#include <arpa/inet.h>
+
+static int buffered;
+static int packets;
+static int packet_size;
+
+static od_frontend_status_t on_packet(od_relay_t *relay, char *data, int size)
+{
+	(void)relay;
+	(void)data;
+	packets++;
+	packet_size = size;
+	return OD_OK;
+}
+
+static int bulk_allowed;
+
+static int on_bulk(od_relay_t *relay)
+{
+	(void)relay;
+	return bulk_allowed;
+}
+
+static const uint8_t bulk_types[256] = { [KIWI_BE_DATA_ROW] = 1 };
+
+static void on_buffered(od_relay_t *relay, int delta)
+{
+	(void)relay;
+	buffered += delta;
+}
+
+static inline int write_header(char *data, char type, uint32_t len)
+{
+	kiwi_header_t header;
+	header.type = type;
+	header.len = htonl(len);
+	memcpy(data, &header, sizeof(header));
+	return sizeof(header);
+}
+
+static void test_od_relay_limits(void *arg)
+{
+	(void)arg;
+	od_io_t io;
+	od_io_init(&io);
+	io.io = machine_io_create();
+	test(io.io != NULL);
+	od_relay_t relay;
+	od_relay_init(&relay, &io);
+	relay.iov = machine_iov_create();
+	test(relay.iov != NULL);
+	relay.on_packet = on_packet;
+	relay.on_buffered = on_buffered;
+	relay.message_limit = 1024;
+
+	char data[64];
+	int progress;
+	int size;
+
+	/* pass-through messages are queued by pointer and accounted */
+	size = write_header(data, KIWI_BE_DATA_ROW, sizeof(uint32_t) + 16);
+	memset(data + size, 'x', 16);
+	size += 16;
+	test(od_relay_process(&relay, &progress, data, size) == OD_OK);
+	test(progress == size);
+	od_relay_account(&relay);
+	test(relay.buffered == size);
+	test(buffered == size);
+
+	/* large pass-through message is streamed, no limit applies */
+	size = write_header(data, KIWI_BE_COPY_DATA, 1 << 20);
+	test(od_relay_process(&relay, &progress, data, size) == OD_OK);
+	relay.packet = 0;
+	od_relay_account(&relay);
+	test(buffered == 21 + 5);
+
+	/* message which has to be buffered whole is refused */
+	size = write_header(data, KIWI_FE_PARSE, 1 << 20);
+	test(od_relay_process(&relay, &progress, data, size) ==
+	     OD_EMESSAGE_LIMIT);
+	test(relay.packet_full == NULL);
+	relay.packet = 0;
+
+	/* and accounted while it is collected within the limit */
+	size = write_header(data, KIWI_FE_PARSE, sizeof(uint32_t) + 512);
+	test(od_relay_process(&relay, &progress, data, size) == OD_OK);
+	test(relay.packet_full != NULL);
+	od_relay_account(&relay);
+	test(buffered == 21 + 5 + 517);
+
+	/* stop gives accounted bytes back */
+	od_relay_stop(&relay);
+	test(relay.buffered == 0);
+	test(buffered == 0);
+
+	od_relay_free(&relay);
+	machine_io_free(io.io);
+	od_io_free(&io);
+}
+
+static void test_od_relay_stream(void *arg)
+{
+	(void)arg;
+	od_io_t io;
+	od_io_init(&io);
+	od_relay_t relay;
+	od_relay_init(&relay, &io);
+	relay.iov = machine_iov_create();
+	test(relay.iov != NULL);
+	relay.on_packet = on_packet;
+	relay.message_limit = 1024;
+
+	char data[64];
+	int progress;
+	int size;
+
+	/* large Bind is passed to on_packet as soon as names are read,
+	 * the rest is streamed regardless of message_limit */
+	packets = 0;
+	size = write_header(data, KIWI_FE_BIND, 1 << 20);
+	memcpy(data + size, "\0stm", 4);
+	size += 4;
+	test(od_relay_process(&relay, &progress, data, size) == OD_OK);
+	test(progress == size);
+	test(packets == 0);
+	test(relay.packet_head != NULL);
+
+	memcpy(data, "t\0", 2);
+	memset(data + 2, 'x', 30);
+	test(od_relay_process(&relay, &progress, data, 32) == OD_OK);
+	test(progress == 32);
+	test(packets == 1);
+	test(packet_size == 5 + 4 + 32);
+	test(relay.packet_head == NULL);
+	test(relay.packet_full == NULL);
+
+	test(od_relay_process(&relay, &progress, data, 32) == OD_OK);
+	test(packets == 1);
+	test(machine_iov_size(relay.iov) == 5 + 4 + 32 + 32);
+
+	/* names are read from the head of a streamed Bind */
+	char *name;
+	uint32_t name_len;
+	size = write_header(data, KIWI_FE_BIND, 1 << 20);
+	memcpy(data + size, "p\0stmt\0", 7);
+	size += 7;
+	test(kiwi_be_read_bind_stmt_name(data, size, &name, &name_len) == 0);
+	test(name_len == 5);
+	test(memcmp(name, "stmt", 5) == 0);
+	test(kiwi_be_bind_opname_offset(data, size) == 5 + 2);
+	test(kiwi_be_read_bind_stmt_name(data, size - 1, &name, &name_len) ==
+	     -1);
+
+	od_relay_free(&relay);
+	od_io_free(&io);
+}
+
+static void test_od_relay_write_bytes(void *arg)
+{
+	(void)arg;
+	od_io_t io;
+	od_io_init(&io);
+	od_io_t dst;
+	od_io_init(&dst);
+	dst.on_write = machine_cond_create();
+	test(dst.on_write != NULL);
+	od_relay_t relay;
+	od_relay_init(&relay, &io);
+	relay.iov = machine_iov_create();
+	test(relay.iov != NULL);
+	relay.on_packet = on_packet;
+	relay.message_limit = 1024;
+
+	/* nothing to write to yet */
+	test(od_relay_write_bytes(&relay, kiwi_be_parse_complete_bytes,
+				  sizeof(kiwi_be_parse_complete_bytes)) == 0);
+	od_relay_attach(&relay, &dst);
+
+	char data[64];
+	int progress;
+	int size;
+
+	/* queued by pointer after relayed message */
+	size = write_header(data, KIWI_BE_DATA_ROW, sizeof(uint32_t) + 16);
+	memset(data + size, 'x', 16);
+	size += 16;
+	test(od_relay_process(&relay, &progress, data, size) == OD_OK);
+	test(od_relay_write_bytes(&relay, kiwi_be_parse_complete_bytes,
+				  sizeof(kiwi_be_parse_complete_bytes)) == 1);
+	test(machine_iov_size(relay.iov) == (size_t)size + 5);
+	test(machine_cond_try(dst.on_write) == 1);
+
+	/* deferred in the middle of a streamed message */
+	size_t queued = machine_iov_size(relay.iov);
+	size = write_header(data, KIWI_BE_COPY_DATA, sizeof(uint32_t) + 32);
+	memset(data + size, 'y', 16);
+	size += 16;
+	test(od_relay_process(&relay, &progress, data, size) == OD_OK);
+	test(relay.packet == 16);
+	test(od_relay_write_bytes(&relay, kiwi_be_close_complete_bytes,
+				  sizeof(kiwi_be_close_complete_bytes)) == 1);
+	test(od_relay_flush_deferred(&relay) == 0);
+	test(machine_iov_size(relay.iov) == queued + size);
+	test(relay.deferred != NULL);
+
+	test(od_relay_process(&relay, &progress, data + 5, 16) == OD_OK);
+	test(relay.packet == 0);
+	test(od_relay_flush_deferred(&relay) == 0);
+	test(relay.deferred == NULL);
+	test(machine_iov_size(relay.iov) == queued + size + 16 + 5);
+
+	/* encoded the same way as by writers */
+	machine_msg_t *msg;
+	msg = kiwi_be_write_ready(NULL, 'T');
+	test(msg != NULL);
+	test(machine_msg_size(msg) == 6);
+	test(memcmp(machine_msg_data(msg), "Z\0\0\0\5T", 6) == 0);
+	msg = kiwi_be_write_close_complete(msg);
+	test(msg != NULL);
+	test(memcmp((char *)machine_msg_data(msg) + 6, "3\0\0\0\4", 5) == 0);
+	machine_msg_free(msg);
+
+	relay.dst = NULL;
+	od_relay_free(&relay);
+	od_io_free(&dst);
+	od_io_free(&io);
+}
+
+static void test_od_relay_bulk(void *arg)
+{
+	(void)arg;
+	od_io_t io;
+	od_io_init(&io);
+	od_relay_t relay;
+	od_relay_init(&relay, &io);
+	relay.iov = machine_iov_create();
+	test(relay.iov != NULL);
+	relay.on_packet = on_packet;
+	relay.bulk_types = bulk_types;
+	relay.on_bulk = on_bulk;
+
+	char data[256];
+	int size = 0;
+	int i;
+	for (i = 0; i < 8; i++) {
+		size += write_header(data + size, KIWI_BE_DATA_ROW,
+				     sizeof(uint32_t) + i);
+		memset(data + size, 'x', i);
+		size += i;
+	}
+	int rows = size;
+	size += write_header(data + size, KIWI_BE_COMMAND_COMPLETE,
+			     sizeof(uint32_t) + 2);
+	memcpy(data + size, "x", 2);
+	size += 2;
+	size += write_header(data + size, KIWI_BE_DATA_ROW,
+			     sizeof(uint32_t) + 16);
+
+	/* not allowed */
+	bulk_allowed = 0;
+	test(od_relay_bulk(&relay, data, size) == 0);
+
+	/* run stops at a type which needs on_packet */
+	bulk_allowed = 1;
+	test(od_relay_bulk(&relay, data, size) == rows);
+	test(machine_iov_size(relay.iov) == (size_t)rows);
+	test(od_relay_bulk(&relay, data + rows, size - rows) == 0);
+
+	/* and at incomplete message */
+	int tail = rows + 7;
+	test(od_relay_bulk(&relay, data + tail, size - tail) == 0);
+	test(od_relay_bulk(&relay, data + tail, 4) == 0);
+
+	/* malformed length is left to the regular path */
+	write_header(data, KIWI_BE_DATA_ROW, 2);
+	test(od_relay_bulk(&relay, data, rows) == 0);
+
+	/* nothing is bypassed in the middle of a message */
+	relay.packet = 1;
+	test(od_relay_bulk(&relay, data + 5, rows - 5) == 0);
+	relay.packet = 0;
+
+	od_relay_free(&relay);
+	od_io_free(&io);
+}
+
+#define TEST_RELAY_EDGE_SIZE (64 * 1024)
+
+static machine_cond_t *edge_written;
+static machine_cond_t *edge_done;
+
+static void on_read(od_relay_t *relay, int size)
+{
+	(void)relay;
+	(void)size;
+}
+
+static void test_od_relay_edge_server(void *arg)
+{
+	machine_io_t *server = arg;
+	machine_io_t *client;
+	test(machine_accept(server, &client, 16, 1, UINT32_MAX) == 0);
+
+	machine_msg_t *msg;
+	msg = machine_msg_create(TEST_RELAY_EDGE_SIZE);
+	test(msg != NULL);
+	memset(machine_msg_data(msg), 'x', TEST_RELAY_EDGE_SIZE);
+	test(machine_write(client, msg, UINT32_MAX) == 0);
+	machine_cond_signal(edge_written);
+
+	/* keep connection open until everything is read */
+	test(machine_cond_wait(edge_done, UINT32_MAX) == 0);
+	machine_close(client);
+	machine_io_free(client);
+}
+
+/* socket holds more data than readahead ring can take, no new edge
+ * is reported for it, so restarting read has to report it again */
+static void test_od_relay_read_edge(void *arg)
+{
+	(void)arg;
+	struct sockaddr_in sa;
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	sa.sin_port = htons(7791);
+
+	machine_io_t *server = machine_io_create();
+	test(server != NULL);
+	test(machine_bind(server, (struct sockaddr *)&sa,
+			  MM_BINDWITH_SO_REUSEADDR) == 0);
+	edge_written = machine_cond_create();
+	test(edge_written != NULL);
+	edge_done = machine_cond_create();
+	test(edge_done != NULL);
+	int64_t id;
+	id = machine_coroutine_create(test_od_relay_edge_server, server);
+	test(id != -1);
+	/* let server start listening */
+	machine_sleep(0);
+
+	od_io_t io;
+	od_io_init(&io);
+	machine_io_t *client = machine_io_create();
+	test(client != NULL);
+	test(machine_set_edge_triggered(client, 1) == 0);
+	test(machine_connect(client, (struct sockaddr *)&sa, UINT32_MAX) ==
+	     0);
+	test(machine_edge_triggered(client) == 1);
+	test(od_io_prepare(&io, client, OD_READAHEAD_SIZE_MIN) == 0);
+	test(machine_cond_wait(edge_written, UINT32_MAX) == 0);
+
+	od_relay_t relay;
+	od_relay_init(&relay, &io);
+	relay.on_read = on_read;
+
+	int total = 0;
+	int full = 0;
+	test(od_io_read_start(&io) == 0);
+	while (total < TEST_RELAY_EDGE_SIZE) {
+		/* read interest is never dropped */
+		test(od_io_read_start(&io) == 0);
+		test(machine_cond_wait(io.on_read, 1000) == 0);
+		test(od_relay_read(&relay) == OD_OK);
+		if (od_readahead_left(&io.readahead) == 0)
+			full++;
+		int size = od_readahead_unread(&io.readahead);
+		od_readahead_pos_read_advance(&io.readahead, size);
+		od_readahead_reuse(&io.readahead);
+		total += size;
+	}
+	test(total == TEST_RELAY_EDGE_SIZE);
+	test(full > 0);
+
+	od_io_read_stop(&io);
+	machine_cond_signal(edge_done);
+	machine_join(id);
+	od_relay_free(&relay);
+	od_io_close(&io);
+	od_io_free(&io);
+	machine_cond_free(edge_written);
+	machine_cond_free(edge_done);
+	machine_close(server);
+	machine_io_free(server);
+}
+
+static void test_od_relay(void *arg)
+{
+	test_od_relay_limits(arg);
+	test_od_relay_stream(arg);
+	test_od_relay_write_bytes(arg);
+	test_od_relay_bulk(arg);
+	test_od_relay_read_edge(arg);
+}
+
+void odyssey_test_relay(void)
+{
+	machinarium_init();
+
+	int id;
+	id = machine_create("test", test_od_relay, NULL);
+	test(id != -1);
+
+	int rc;
+	rc = machine_wait(id);
+	test(rc != -1);
+
+	machinarium_free();
+}
@@ -0,0 +1,124 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+static void test_scram_cache_secret(od_scram_secret_t *secret, char *user,
+				    char *password)
+{
+	memset(secret, 0, sizeof(*secret));
+	od_scram_cache_key(user, password, secret->key);
+	secret->iterations = 4096;
+	snprintf(secret->salt, sizeof(secret->salt), "salt-%s", user);
+	memset(secret->stored_key, 's', sizeof(secret->stored_key));
+	memset(secret->server_key, 'k', sizeof(secret->server_key));
+}
+
+static void test_scram_cache_hit_miss(void)
+{
+	od_scram_cache_t cache;
+	od_scram_cache_init(&cache);
+
+	od_scram_secret_t secret;
+	od_scram_secret_t result;
+	test_scram_cache_secret(&secret, "alice", "secret");
+	test(od_scram_cache_get(&cache, secret.key, &result, 0) == -1);
+	od_scram_cache_put(&cache, &secret, 0);
+	test(cache.count == 1);
+
+	/* hit */
+	memset(&result, 0, sizeof(result));
+	test(od_scram_cache_get(&cache, secret.key, &result, 1) == 0);
+	test(result.iterations == 4096);
+	test(strcmp(result.salt, "salt-alice") == 0);
+	test(memcmp(result.stored_key, secret.stored_key, 32) == 0);
+	test(memcmp(result.server_key, secret.server_key, 32) == 0);
+
+	/* changed password and other user miss */
+	uint8_t key[OD_SCRAM_CACHE_KEY_LEN];
+	od_scram_cache_key("alice", "secret2", key);
+	test(od_scram_cache_get(&cache, key, &result, 1) == -1);
+	od_scram_cache_key("bob", "secret", key);
+	test(od_scram_cache_get(&cache, key, &result, 1) == -1);
+
+	/* concurrent derivation keeps the first entry */
+	od_scram_secret_t other;
+	test_scram_cache_secret(&other, "alice", "secret");
+	strcpy(other.salt, "other");
+	od_scram_cache_put(&cache, &other, 2);
+	test(cache.count == 1);
+	test(od_scram_cache_get(&cache, secret.key, &result, 2) == 0);
+	test(strcmp(result.salt, "salt-alice") == 0);
+
+	od_scram_cache_free(&cache);
+}
+
+static void test_scram_cache_eviction(void)
+{
+	od_scram_cache_t cache;
+	od_scram_cache_init(&cache);
+
+	od_scram_secret_t secret;
+	od_scram_secret_t result;
+	char user[32];
+	int i;
+	for (i = 0; i < OD_SCRAM_CACHE_MAX; i++) {
+		snprintf(user, sizeof(user), "user%d", i);
+		test_scram_cache_secret(&secret, user, "pass");
+		od_scram_cache_put(&cache, &secret, 0);
+	}
+	test(cache.count == OD_SCRAM_CACHE_MAX);
+
+	/* touch the oldest entry, so the next one is evicted */
+	od_scram_cache_key("user0", "pass", secret.key);
+	test(od_scram_cache_get(&cache, secret.key, &result, 0) == 0);
+
+	test_scram_cache_secret(&secret, "extra", "pass");
+	od_scram_cache_put(&cache, &secret, 0);
+	test(cache.count == OD_SCRAM_CACHE_MAX);
+	test(od_scram_cache_get(&cache, secret.key, &result, 0) == 0);
+
+	od_scram_cache_key("user0", "pass", secret.key);
+	test(od_scram_cache_get(&cache, secret.key, &result, 0) == 0);
+	od_scram_cache_key("user1", "pass", secret.key);
+	test(od_scram_cache_get(&cache, secret.key, &result, 0) == -1);
+	for (i = 2; i < OD_SCRAM_CACHE_MAX; i++) {
+		snprintf(user, sizeof(user), "user%d", i);
+		od_scram_cache_key(user, "pass", secret.key);
+		test(od_scram_cache_get(&cache, secret.key, &result, 0) == 0);
+	}
+
+	od_scram_cache_free(&cache);
+}
+
+static void test_scram_cache_expiry(void)
+{
+	od_scram_cache_t cache;
+	od_scram_cache_init(&cache);
+
+	od_scram_secret_t secret;
+	od_scram_secret_t result;
+	test_scram_cache_secret(&secret, "carol", "pass");
+	od_scram_cache_put(&cache, &secret, 1000);
+
+	uint64_t expire_ms = 1000 + OD_SCRAM_CACHE_TTL_MS;
+	test(od_scram_cache_get(&cache, secret.key, &result, expire_ms - 1) ==
+	     0);
+	test(od_scram_cache_get(&cache, secret.key, &result, expire_ms) == -1);
+	test(cache.count == 0);
+
+	/* expired entry is replaced by a fresh derivation */
+	od_scram_cache_put(&cache, &secret, 1000);
+	strcpy(secret.salt, "rotated");
+	od_scram_cache_put(&cache, &secret, expire_ms);
+	test(cache.count == 1);
+	test(od_scram_cache_get(&cache, secret.key, &result, expire_ms) == 0);
+	test(strcmp(result.salt, "rotated") == 0);
+
+	od_scram_cache_free(&cache);
+}
+
+void odyssey_test_scram_cache(void)
+{
+	test_scram_cache_hit_miss();
+	test_scram_cache_eviction();
+	test_scram_cache_expiry();
+}
@@ -0,0 +1,47 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+static int test_slow_query_cb(od_slow_query_t *record, void **argv)
+{
+	int *count = argv[0];
+	int64_t *expected = argv[1];
+	test(record->duration_us == *expected);
+	(*expected)++;
+	(*count)++;
+	return 0;
+}
+
+static void test_slow_query_ring(od_slow_query_ring_t *ring, int added,
+				 int64_t first, int count_expected)
+{
+	od_slow_query_t record;
+	memset(&record, 0, sizeof(record));
+	int i;
+	for (i = 0; i < added; i++) {
+		record.duration_us = i;
+		od_slow_query_ring_add(ring, &record);
+	}
+	int count = 0;
+	int64_t expected = first;
+	void *argv[] = { &count, &expected };
+	test(od_slow_query_ring_foreach(ring, test_slow_query_cb, argv) == 0);
+	test(count == count_expected);
+}
+
+void odyssey_test_slow_query(void)
+{
+	od_slow_query_ring_t ring;
+	od_slow_query_ring_init(&ring);
+
+	/* disabled ring keeps nothing */
+	test_slow_query_ring(&ring, 3, 0, 0);
+
+	test(od_slow_query_ring_set_size(&ring, 4) == 0);
+	test_slow_query_ring(&ring, 3, 0, 3);
+
+	/* oldest records are replaced, order is kept */
+	test(od_slow_query_ring_set_size(&ring, 4) == 0);
+	test_slow_query_ring(&ring, 10, 6, 4);
+
+	od_slow_query_ring_free(&ring);
+}
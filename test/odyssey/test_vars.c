@@ -0,0 +1,120 @@
+#include "odyssey.h"
+#include <odyssey_test.h>
+
+static void test_vars_slots(void)
+{
+	/* every name owns its slot, so a new variable colliding with
+	 * another one fails here instead of breaking lookups */
+	int used[64] = { 0 };
+	kiwi_var_type_t type = 0;
+	for (; type < KIWI_VAR_MAX; type++) {
+		char *name = kiwi_var_names[type].name;
+		int name_len = kiwi_var_names[type].name_len;
+		uint32_t slot = kiwi_var_slot(name, name_len);
+		test(slot < 64);
+		test(used[slot] == 0);
+		used[slot] = 1;
+		test(kiwi_var_hash_table[slot] == type);
+	}
+}
+
+static void test_vars_find(void)
+{
+	kiwi_var_type_t type = 0;
+	for (; type < KIWI_VAR_MAX; type++) {
+		char name[KIWI_VAR_NAME_MAX];
+		int name_len = kiwi_var_names[type].name_len;
+		test(name_len >= KIWI_VAR_NAME_MIN);
+		test(name_len <= KIWI_VAR_NAME_MAX);
+		memcpy(name, kiwi_var_names[type].name, name_len);
+		test(kiwi_var_find(name, name_len) == type);
+
+		/* names are case-insensitive */
+		int i;
+		for (i = 0; i < name_len - 1; i++)
+			name[i] = toupper(name[i]);
+		test(kiwi_var_find(name, name_len) == type);
+		for (i = 0; i < name_len - 1; i++)
+			name[i] = tolower(name[i]);
+		test(kiwi_var_find(name, name_len) == type);
+	}
+
+	test(kiwi_var_find("", 1) == KIWI_VAR_UNDEF);
+	test(kiwi_var_find("TimeZon", 8) == KIWI_VAR_UNDEF);
+	test(kiwi_var_find("TimeZones", 10) == KIWI_VAR_UNDEF);
+	test(kiwi_var_find("TimeZene", 9) == KIWI_VAR_UNDEF);
+	test(kiwi_var_find("work_mem", 9) == KIWI_VAR_UNDEF);
+	test(kiwi_var_find("server_version", 15) == KIWI_VAR_UNDEF);
+	test(kiwi_var_find("session_authorization", 22) == KIWI_VAR_UNDEF);
+	test(kiwi_var_find("default_transaction_deferrable_", 32) ==
+	     KIWI_VAR_UNDEF);
+}
+
+static void test_vars_cas(void)
+{
+	kiwi_vars_t client;
+	kiwi_vars_t server;
+	kiwi_vars_init(&client);
+	kiwi_vars_init(&server);
+
+	char query[512];
+	test(kiwi_vars_cas(&client, &server, query, sizeof(query)) == 0);
+
+	kiwi_vars_set(&client, KIWI_VAR_TIMEZONE, "UTC", 4);
+	kiwi_vars_set(&server, KIWI_VAR_TIMEZONE, "UTC", 4);
+	test(kiwi_vars_cas(&client, &server, query, sizeof(query)) == 0);
+
+	/* same length, different value */
+	kiwi_vars_set(&server, KIWI_VAR_TIMEZONE, "MSK", 4);
+	int rc;
+	rc = kiwi_vars_cas(&client, &server, query, sizeof(query));
+	test(rc > 0);
+	test(strncmp(query, "SET TimeZone=E'UTC';", rc) == 0);
+
+	kiwi_vars_set(&server, KIWI_VAR_TIMEZONE, "UTC", 4);
+	test(kiwi_vars_cas(&client, &server, query, sizeof(query)) == 0);
+
+	kiwi_vars_unset(&client, KIWI_VAR_TIMEZONE);
+	test(kiwi_var_compare(kiwi_vars_of(&client, KIWI_VAR_TIMEZONE),
+			      kiwi_vars_of(&client, KIWI_VAR_DATESTYLE)));
+}
+
+#define TEST_VARS_BENCH_LOOKUPS 1000000
+
+static void test_vars_bench(void)
+{
+	static char *names[] = { "client_encoding", "DateStyle",
+				 "TimeZone",	    "application_name",
+				 "search_path",	    "server_version",
+				 "is_superuser",    "integer_datetimes" };
+	int count = sizeof(names) / sizeof(names[0]);
+	int lens[sizeof(names) / sizeof(names[0])];
+	int i;
+	for (i = 0; i < count; i++)
+		lens[i] = strlen(names[i]) + 1;
+
+	struct timespec start;
+	struct timespec stop;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	int found = 0;
+	for (i = 0; i < TEST_VARS_BENCH_LOOKUPS; i++) {
+		int n = i % count;
+		if (kiwi_var_find(names[n], lens[n]) != KIWI_VAR_UNDEF)
+			found++;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+	test(found > 0);
+
+	uint64_t ns = (stop.tv_sec - start.tv_sec) * 1000000000ULL +
+		      stop.tv_nsec - start.tv_nsec;
+	printf("[%d ns/lookup] ", (int)(ns / TEST_VARS_BENCH_LOOKUPS));
+	fflush(stdout);
+}
+
+void odyssey_test_vars(void)
+{
+	test_vars_slots();
+	test_vars_find();
+	test_vars_cas();
+	test_vars_bench();
+}
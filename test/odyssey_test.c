@@ -28,6 +28,8 @@ extern void machinarium_test_join(void);
 extern void machinarium_test_condition0(void);
 extern void machinarium_test_eventfd0(void);
 extern void machinarium_test_stat(void);
+extern void machinarium_test_loop_stat(void);
+extern void machinarium_test_task_executor(void);
 extern void machinarium_test_signal0(void);
 extern void machinarium_test_signal1(void);
 extern void machinarium_test_signal2(void);
@@ -64,10 +66,13 @@ extern void machinarium_test_client_server_unix_socket(void);
 extern void machinarium_test_read_10mb0(void);
 extern void machinarium_test_read_10mb1(void);
 extern void machinarium_test_read_10mb2(void);
+extern void machinarium_test_read_edge_triggered(void);
+extern void machinarium_test_splice(void);
 extern void machinarium_test_read_timeout(void);
 extern void machinarium_test_read_cancel(void);
 extern void machinarium_test_read_var(void);
 extern void machinarium_test_tls0(void);
+extern void machinarium_test_tls_resume(void);
 extern void machinarium_test_tls_unix_socket(void);
 extern void machinarium_test_tls_read_10mb0(void);
 extern void machinarium_test_tls_read_10mb1(void);
@@ -79,6 +84,19 @@ extern void odyssey_test_tdigest(void);
 extern void odyssey_test_attribute(void);
 extern void odyssey_test_util(void);
 extern void odyssey_test_lock(void);
+extern void odyssey_test_readahead(void);
+extern void odyssey_test_relay(void);
+extern void odyssey_test_logger(void);
+extern void odyssey_test_slow_query(void);
+extern void odyssey_test_query_stats(void);
+extern void odyssey_test_hgram(void);
+extern void odyssey_test_auth_cache(void);
+extern void odyssey_test_ldap_cache(void);
+#ifdef USE_SCRAM
+extern void odyssey_test_scram_cache(void);
+#endif
+extern void odyssey_test_params_status(void);
+extern void odyssey_test_vars(void);
 
 int main(int argc, char *argv[])
 {
@@ -97,6 +115,8 @@ int main(int argc, char *argv[])
 	odyssey_test(machinarium_test_condition0);
 	odyssey_test(machinarium_test_eventfd0);
 	odyssey_test(machinarium_test_stat);
+	odyssey_test(machinarium_test_loop_stat);
+	odyssey_test(machinarium_test_task_executor);
 	odyssey_test(machinarium_test_signal0);
 	odyssey_test(machinarium_test_signal1);
 	odyssey_test(machinarium_test_signal2);
@@ -133,10 +153,13 @@ int main(int argc, char *argv[])
 	odyssey_test(machinarium_test_read_10mb0);
 	odyssey_test(machinarium_test_read_10mb1);
 	odyssey_test(machinarium_test_read_10mb2);
+	odyssey_test(machinarium_test_read_edge_triggered);
+	odyssey_test(machinarium_test_splice);
 	odyssey_test(machinarium_test_read_timeout);
 	odyssey_test(machinarium_test_read_cancel);
 	odyssey_test(machinarium_test_read_var);
 	odyssey_test(machinarium_test_tls0);
+	odyssey_test(machinarium_test_tls_resume);
 	odyssey_test(machinarium_test_tls_unix_socket);
 	odyssey_test(machinarium_test_tls_read_10mb0);
 	odyssey_test(machinarium_test_tls_read_10mb1);
@@ -147,6 +170,19 @@ int main(int argc, char *argv[])
 	odyssey_test(odyssey_test_attribute);
 	odyssey_test(odyssey_test_util);
 	odyssey_test(odyssey_test_lock);
+	odyssey_test(odyssey_test_readahead);
+	odyssey_test(odyssey_test_relay);
+	odyssey_test(odyssey_test_logger);
+	odyssey_test(odyssey_test_slow_query);
+	odyssey_test(odyssey_test_query_stats);
+	odyssey_test(odyssey_test_hgram);
+	odyssey_test(odyssey_test_auth_cache);
+	odyssey_test(odyssey_test_ldap_cache);
+#ifdef USE_SCRAM
+	odyssey_test(odyssey_test_scram_cache);
+#endif
+	odyssey_test(odyssey_test_params_status);
+	odyssey_test(odyssey_test_vars);
 
 	return 0;
 }
\ No newline at end of file
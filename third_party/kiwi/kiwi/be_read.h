@@ -264,19 +264,25 @@ KIWI_API static inline int kiwi_be_read_parse(char *data, uint32_t size,
 	return 0;
 }
 
+/* data may hold only the head of a streamed message */
 KIWI_API static inline int kiwi_be_bind_opname_offset(char *data, uint32_t size)
 {
 	kiwi_header_t *header = (kiwi_header_t *)data;
-	uint32_t len;
-	int rc = kiwi_read(&len, &data, &size);
-	if (kiwi_unlikely(rc != 0))
+	if (kiwi_unlikely(size < sizeof(kiwi_header_t)))
 		return -1;
 	if (kiwi_unlikely(header->type != KIWI_FE_BIND))
 		return -1;
+	uint32_t len = kiwi_read_size(data, size);
+	if (kiwi_unlikely(len < sizeof(uint32_t)))
+		return -1;
 
-	/* destination portal */
-	uint32_t pos_size = len;
+	uint32_t pos_size = size - sizeof(kiwi_header_t);
+	if (pos_size > len - sizeof(uint32_t))
+		pos_size = len - sizeof(uint32_t);
 	char *pos = kiwi_header_data(header);
+
+	/* destination portal */
+	int rc;
 	rc = kiwi_readsz(&pos, &pos_size);
 	if (kiwi_unlikely(rc == -1))
 		return -1;
@@ -394,25 +400,34 @@ KIWI_API static inline int kiwi_be_read_close(char *data, uint32_t size,
 	return 0;
 }
 
-KIWI_API static inline int kiwi_be_read_bind_stmt_name(char *data,
-						       uint32_t size,
-						       char **name,
-						       uint32_t *name_len)
+/* data may hold only the head of a streamed message */
+KIWI_API static inline int kiwi_be_read_bind_names(char *data, uint32_t size,
+						   char **portal,
+						   uint32_t *portal_len,
+						   char **name,
+						   uint32_t *name_len)
 {
 	kiwi_header_t *header = (kiwi_header_t *)data;
-	uint32_t len;
-	int rc = kiwi_read(&len, &data, &size);
-	if (kiwi_unlikely(rc != 0))
+	if (kiwi_unlikely(size < sizeof(kiwi_header_t)))
 		return -1;
 	if (kiwi_unlikely(header->type != KIWI_FE_BIND))
 		return -1;
+	uint32_t len = kiwi_read_size(data, size);
+	if (kiwi_unlikely(len < sizeof(uint32_t)))
+		return -1;
 
-	/* destination portal */
-	uint32_t pos_size = len;
+	uint32_t pos_size = size - sizeof(kiwi_header_t);
+	if (pos_size > len - sizeof(uint32_t))
+		pos_size = len - sizeof(uint32_t);
 	char *pos = kiwi_header_data(header);
+	int rc;
+
+	/* destination portal */
+	*portal = pos;
 	rc = kiwi_readsz(&pos, &pos_size);
 	if (kiwi_unlikely(rc == -1))
 		return -1;
+	*portal_len = pos - *portal;
 
 	/* source prepared statement */
 	*name = pos;
@@ -424,6 +439,18 @@ KIWI_API static inline int kiwi_be_read_bind_stmt_name(char *data,
 	return 0;
 }
 
+/* data may hold only the head of a streamed message */
+KIWI_API static inline int kiwi_be_read_bind_stmt_name(char *data,
+						       uint32_t size,
+						       char **name,
+						       uint32_t *name_len)
+{
+	char *portal;
+	uint32_t portal_len;
+	return kiwi_be_read_bind_names(data, size, &portal, &portal_len, name,
+				       name_len);
+}
+
 KIWI_API static inline int
 kiwi_be_read_authentication_sasl_initial(char *data, uint32_t size,
 					 char **mechanism, char **auth_data,
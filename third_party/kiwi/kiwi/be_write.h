@@ -8,6 +8,58 @@
  * postgreSQL protocol interaction library.
  */
 
+/* preencoded messages of fixed content, they are never modified and
+ * can be queued for write by pointer */
+#define KIWI_BE_BYTES(type) { (char)(type), 0, 0, 0, sizeof(uint32_t) }
+#define KIWI_BE_READY_BYTES(status)                                     \
+	{                                                               \
+		(char)KIWI_BE_READY_FOR_QUERY, 0, 0, 0,                 \
+			sizeof(uint32_t) + sizeof(uint8_t), (char)(status) \
+	}
+#define KIWI_BE_READY_SIZE ((int)(sizeof(kiwi_header_t) + sizeof(uint8_t)))
+
+static const char kiwi_be_empty_query_bytes[] =
+	KIWI_BE_BYTES(KIWI_BE_EMPTY_QUERY_RESPONSE);
+static const char kiwi_be_parse_complete_bytes[] =
+	KIWI_BE_BYTES(KIWI_BE_PARSE_COMPLETE);
+static const char kiwi_be_bind_complete_bytes[] =
+	KIWI_BE_BYTES(KIWI_BE_BIND_COMPLETE);
+static const char kiwi_be_close_complete_bytes[] =
+	KIWI_BE_BYTES(KIWI_BE_CLOSE_COMPLETE);
+static const char kiwi_be_portal_suspended_bytes[] =
+	KIWI_BE_BYTES(KIWI_BE_PORTAL_SUSPENDED);
+static const char kiwi_be_no_data_bytes[] = KIWI_BE_BYTES(KIWI_BE_NO_DATA);
+static const char kiwi_be_ready_idle_bytes[] = KIWI_BE_READY_BYTES('I');
+static const char kiwi_be_ready_in_transaction_bytes[] =
+	KIWI_BE_READY_BYTES('T');
+static const char kiwi_be_ready_failed_bytes[] = KIWI_BE_READY_BYTES('E');
+
+static inline const char *kiwi_be_ready_bytes(uint8_t status)
+{
+	switch (status) {
+	case 'T':
+		return kiwi_be_ready_in_transaction_bytes;
+	case 'E':
+		return kiwi_be_ready_failed_bytes;
+	default:
+		assert(status == 'I');
+		return kiwi_be_ready_idle_bytes;
+	}
+}
+
+KIWI_API static inline machine_msg_t *
+kiwi_be_write_bytes(machine_msg_t *msg, const char *data, int size)
+{
+	int offset = 0;
+	if (msg)
+		offset = machine_msg_size(msg);
+	msg = machine_msg_create_or_advance(msg, size);
+	if (kiwi_unlikely(msg == NULL))
+		return NULL;
+	memcpy((char *)machine_msg_data(msg) + offset, data, size);
+	return msg;
+}
+
 KIWI_API static inline machine_msg_t *
 kiwi_be_write_error_as(machine_msg_t *msg, char *severity, char *code,
 		       char *detail, int detail_len, char *hint, int hint_len,
@@ -296,19 +348,8 @@ kiwi_be_write_parameter_status(machine_msg_t *msg, char *key, int key_len,
 KIWI_API static inline machine_msg_t *kiwi_be_write_ready(machine_msg_t *msg,
 							  uint8_t status)
 {
-	size_t size = sizeof(kiwi_header_t) + sizeof(uint8_t);
-	int offset = 0;
-	if (msg)
-		offset = machine_msg_size(msg);
-	msg = machine_msg_create_or_advance(msg, size);
-	if (kiwi_unlikely(msg == NULL))
-		return NULL;
-	char *pos;
-	pos = (char *)machine_msg_data(msg) + offset;
-	kiwi_write8(&pos, KIWI_BE_READY_FOR_QUERY);
-	kiwi_write32(&pos, sizeof(uint32_t) + sizeof(uint8_t));
-	kiwi_write8(&pos, status);
-	return msg;
+	return kiwi_be_write_bytes(msg, kiwi_be_ready_bytes(status),
+				   KIWI_BE_READY_SIZE);
 }
 
 KIWI_API static inline int kiwi_be_write_complete(machine_msg_t *msg,
@@ -334,102 +375,42 @@ KIWI_API static inline int kiwi_be_write_complete(machine_msg_t *msg,
 KIWI_API static inline machine_msg_t *
 kiwi_be_write_empty_query(machine_msg_t *msg)
 {
-	size_t size = sizeof(kiwi_header_t);
-	int offset = 0;
-	if (msg)
-		offset = machine_msg_size(msg);
-	msg = machine_msg_create_or_advance(msg, size);
-	if (kiwi_unlikely(msg == NULL))
-		return NULL;
-	char *pos;
-	pos = (char *)machine_msg_data(msg) + offset;
-	kiwi_write8(&pos, KIWI_BE_EMPTY_QUERY_RESPONSE);
-	kiwi_write32(&pos, sizeof(uint32_t));
-	return msg;
+	return kiwi_be_write_bytes(msg, kiwi_be_empty_query_bytes,
+				   sizeof(kiwi_be_empty_query_bytes));
 }
 
 KIWI_API static inline machine_msg_t *
 kiwi_be_write_parse_complete(machine_msg_t *msg)
 {
-	size_t size = sizeof(kiwi_header_t);
-	int offset = 0;
-	if (msg)
-		offset = machine_msg_size(msg);
-	msg = machine_msg_create_or_advance(msg, size);
-	if (kiwi_unlikely(msg == NULL))
-		return NULL;
-	char *pos;
-	pos = (char *)machine_msg_data(msg) + offset;
-	kiwi_write8(&pos, KIWI_BE_PARSE_COMPLETE);
-	kiwi_write32(&pos, sizeof(uint32_t));
-	return msg;
+	return kiwi_be_write_bytes(msg, kiwi_be_parse_complete_bytes,
+				   sizeof(kiwi_be_parse_complete_bytes));
 }
 
 KIWI_API static inline machine_msg_t *
 kiwi_be_write_bind_complete(machine_msg_t *msg)
 {
-	size_t size = sizeof(kiwi_header_t);
-	int offset = 0;
-	if (msg)
-		offset = machine_msg_size(msg);
-	msg = machine_msg_create_or_advance(msg, size);
-	if (kiwi_unlikely(msg == NULL))
-		return NULL;
-	char *pos;
-	pos = (char *)machine_msg_data(msg) + offset;
-	kiwi_write8(&pos, KIWI_BE_BIND_COMPLETE);
-	kiwi_write32(&pos, sizeof(uint32_t));
-	return msg;
+	return kiwi_be_write_bytes(msg, kiwi_be_bind_complete_bytes,
+				   sizeof(kiwi_be_bind_complete_bytes));
 }
 
 KIWI_API static inline machine_msg_t *
 kiwi_be_write_close_complete(machine_msg_t *msg)
 {
-	size_t size = sizeof(kiwi_header_t);
-	int offset = 0;
-	if (msg)
-		offset = machine_msg_size(msg);
-	msg = machine_msg_create_or_advance(msg, size);
-	if (kiwi_unlikely(msg == NULL))
-		return NULL;
-	char *pos;
-	pos = (char *)machine_msg_data(msg) + offset;
-	kiwi_write8(&pos, KIWI_BE_CLOSE_COMPLETE);
-	kiwi_write32(&pos, sizeof(uint32_t));
-	return msg;
+	return kiwi_be_write_bytes(msg, kiwi_be_close_complete_bytes,
+				   sizeof(kiwi_be_close_complete_bytes));
 }
 
 KIWI_API static inline machine_msg_t *
 kiwi_be_write_portal_suspended(machine_msg_t *msg)
 {
-	size_t size = sizeof(kiwi_header_t);
-	int offset = 0;
-	if (msg)
-		offset = machine_msg_size(msg);
-	msg = machine_msg_create_or_advance(msg, size);
-	if (kiwi_unlikely(msg == NULL))
-		return NULL;
-	char *pos;
-	pos = (char *)machine_msg_data(msg) + offset;
-	kiwi_write8(&pos, KIWI_BE_PORTAL_SUSPENDED);
-	kiwi_write32(&pos, sizeof(uint32_t));
-	return msg;
+	return kiwi_be_write_bytes(msg, kiwi_be_portal_suspended_bytes,
+				   sizeof(kiwi_be_portal_suspended_bytes));
 }
 
 KIWI_API static inline machine_msg_t *kiwi_be_write_no_data(machine_msg_t *msg)
 {
-	size_t size = sizeof(kiwi_header_t);
-	int offset = 0;
-	if (msg)
-		offset = machine_msg_size(msg);
-	msg = machine_msg_create_or_advance(msg, size);
-	if (kiwi_unlikely(msg == NULL))
-		return NULL;
-	char *pos;
-	pos = (char *)machine_msg_data(msg) + offset;
-	kiwi_write8(&pos, KIWI_BE_NO_DATA);
-	kiwi_write32(&pos, sizeof(uint32_t));
-	return msg;
+	return kiwi_be_write_bytes(msg, kiwi_be_no_data_bytes,
+				   sizeof(kiwi_be_no_data_bytes));
 }
 
 KIWI_API static inline machine_msg_t *
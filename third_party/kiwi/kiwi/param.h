@@ -139,4 +139,21 @@ static inline kiwi_param_t *kiwi_params_find(kiwi_params_t *params, char *name,
 	return NULL;
 }
 
+static inline int kiwi_params_equal(kiwi_params_t *a, kiwi_params_t *b)
+{
+	if (a->count != b->count)
+		return 0;
+	kiwi_param_t *param = a->list;
+	for (; param; param = param->next) {
+		kiwi_param_t *match;
+		match = kiwi_params_find(b, kiwi_param_name(param),
+					 param->name_len);
+		if (match == NULL || match->value_len != param->value_len ||
+		    memcmp(kiwi_param_value(match), kiwi_param_value(param),
+			   param->value_len) != 0)
+			return 0;
+	}
+	return 1;
+}
+
 #endif /* KIWI_PARAM_H */
@@ -7,23 +7,86 @@
  * postgreSQL protocol interaction library.
  */
 
+typedef struct kiwi_param_status kiwi_param_status_t;
 typedef struct kiwi_params_lock kiwi_params_lock_t;
 
+/* ParameterStatus message of a known variable inside the status block */
+struct kiwi_param_status {
+	kiwi_var_type_t type;
+	int offset;
+	int size;
+};
+
 struct kiwi_params_lock {
 	pthread_mutex_t lock;
 	kiwi_params_t params;
+	/* params pre-serialized as ParameterStatus messages,
+	 * replaced together with params */
+	char *status;
+	int status_size;
+	kiwi_param_status_t *status_index;
+	int status_count;
 };
 
 static inline void kiwi_params_lock_init(kiwi_params_lock_t *pl)
 {
 	pthread_mutex_init(&pl->lock, NULL);
 	kiwi_params_init(&pl->params);
+	pl->status = NULL;
+	pl->status_size = 0;
+	pl->status_index = NULL;
+	pl->status_count = 0;
 }
 
 static inline void kiwi_params_lock_free(kiwi_params_lock_t *pl)
 {
 	pthread_mutex_destroy(&pl->lock);
 	kiwi_params_free(&pl->params);
+	free(pl->status);
+	free(pl->status_index);
+}
+
+static inline int kiwi_params_lock_serialize(kiwi_params_lock_t *pl,
+					     kiwi_params_t *params)
+{
+	int size = 0;
+	kiwi_param_t *param = params->list;
+	for (; param; param = param->next)
+		size += sizeof(kiwi_header_t) + param->name_len +
+			param->value_len;
+
+	pl->status = malloc(size);
+	pl->status_index =
+		malloc(sizeof(kiwi_param_status_t) * params->count);
+	if (pl->status == NULL || pl->status_index == NULL) {
+		free(pl->status);
+		free(pl->status_index);
+		pl->status = NULL;
+		pl->status_index = NULL;
+		return -1;
+	}
+
+	char *pos = pl->status;
+	pl->status_count = 0;
+	for (param = params->list; param; param = param->next) {
+		kiwi_var_type_t type;
+		type = kiwi_var_find(kiwi_param_name(param), param->name_len);
+		if (type != KIWI_VAR_UNDEF) {
+			kiwi_param_status_t *entry;
+			entry = &pl->status_index[pl->status_count++];
+			entry->type = type;
+			entry->offset = pos - pl->status;
+			entry->size = sizeof(kiwi_header_t) +
+				      param->name_len + param->value_len;
+		}
+		kiwi_write8(&pos, KIWI_BE_PARAMETER_STATUS);
+		kiwi_write32(&pos, sizeof(uint32_t) + param->name_len +
+					   param->value_len);
+		kiwi_write(&pos, kiwi_param_name(param), param->name_len);
+		kiwi_write(&pos, kiwi_param_value(param), param->value_len);
+	}
+	pl->status_size = size;
+	return 0;
 }
 
 static inline int kiwi_params_lock_count(kiwi_params_lock_t *pl)
@@ -47,14 +110,110 @@ static inline int kiwi_params_lock_copy(kiwi_params_lock_t *pl,
 static inline int kiwi_params_lock_set_once(kiwi_params_lock_t *pl,
 					    kiwi_params_t *params)
 {
+	if (params->count == 0)
+		return 0;
+
+	kiwi_params_lock_t serialized;
+	int rc;
+	rc = kiwi_params_lock_serialize(&serialized, params);
+	if (rc == -1)
+		return -1;
+
 	pthread_mutex_lock(&pl->lock);
 	if (pl->params.count > 0) {
 		pthread_mutex_unlock(&pl->lock);
+		free(serialized.status);
+		free(serialized.status_index);
 		return 0;
 	}
+	pl->status = serialized.status;
+	pl->status_size = serialized.status_size;
+	pl->status_index = serialized.status_index;
+	pl->status_count = serialized.status_count;
 	pl->params = *params;
 	pthread_mutex_unlock(&pl->lock);
 	return 1;
 }
 
+/* replace params reported differently by a new server connection,
+ * returns 0 if params are the same and not consumed */
+static inline int kiwi_params_lock_update(kiwi_params_lock_t *pl,
+					  kiwi_params_t *params)
+{
+	if (params->count == 0)
+		return 0;
+
+	kiwi_params_lock_t serialized;
+	int rc;
+	rc = kiwi_params_lock_serialize(&serialized, params);
+	if (rc == -1)
+		return -1;
+
+	pthread_mutex_lock(&pl->lock);
+	if (kiwi_params_equal(&pl->params, params)) {
+		pthread_mutex_unlock(&pl->lock);
+		free(serialized.status);
+		free(serialized.status_index);
+		return 0;
+	}
+	kiwi_params_t prev = pl->params;
+	char *prev_status = pl->status;
+	kiwi_param_status_t *prev_status_index = pl->status_index;
+	pl->status = serialized.status;
+	pl->status_size = serialized.status_size;
+	pl->status_index = serialized.status_index;
+	pl->status_count = serialized.status_count;
+	pl->params = *params;
+	pthread_mutex_unlock(&pl->lock);
+
+	kiwi_params_free(&prev);
+	free(prev_status);
+	free(prev_status_index);
+	return 1;
+}
+
+/* copy ParameterStatus block, patching only the variables set in vars */
+static inline machine_msg_t *
+kiwi_params_lock_status_msg(kiwi_params_lock_t *pl, kiwi_vars_t *vars)
+{
+	pthread_mutex_lock(&pl->lock);
+	int size = pl->status_size;
+	int i;
+	for (i = 0; i < pl->status_count; i++) {
+		kiwi_param_status_t *entry = &pl->status_index[i];
+		kiwi_var_t *var = kiwi_vars_get(vars, entry->type);
+		if (var)
+			size += sizeof(kiwi_header_t) + var->name_len +
+				var->value_len - entry->size;
+	}
+
+	machine_msg_t *msg;
+	msg = machine_msg_create(size);
+	if (msg == NULL) {
+		pthread_mutex_unlock(&pl->lock);
+		return NULL;
+	}
+	char *pos = machine_msg_data(msg);
+
+	int copied = 0;
+	for (i = 0; i < pl->status_count; i++) {
+		kiwi_param_status_t *entry = &pl->status_index[i];
+		kiwi_var_t *var = kiwi_vars_get(vars, entry->type);
+		if (var == NULL)
+			continue;
+		kiwi_write(&pos, pl->status + copied, entry->offset - copied);
+		kiwi_write8(&pos, KIWI_BE_PARAMETER_STATUS);
+		kiwi_write32(&pos, sizeof(uint32_t) + var->name_len +
+					   var->value_len);
+		kiwi_write(&pos, var->name, var->name_len);
+		kiwi_write(&pos, var->value, var->value_len);
+		copied = entry->offset + entry->size;
+	}
+	if (pl->status_size > copied)
+		kiwi_write(&pos, pl->status + copied,
+			   pl->status_size - copied);
+	pthread_mutex_unlock(&pl->lock);
+	return msg;
+}
+
 #endif /* KIWI_PARAM_LOCK_H */
@@ -46,18 +46,127 @@ struct kiwi_var {
 	int name_len;
 	char value[KIWI_MAX_VAR_SIZE];
 	int value_len;
+	/* compared before value */
+	uint32_t value_hash;
 };
 
 struct kiwi_vars {
 	kiwi_var_t vars[KIWI_VAR_MAX];
 };
 
+typedef struct {
+	char *name;
+	int name_len;
+} kiwi_var_name_t;
+
+#define KIWI_VAR_NAME(type, name) [type] = { name, sizeof(name) }
+
+static const kiwi_var_name_t kiwi_var_names[KIWI_VAR_MAX] = {
+	KIWI_VAR_NAME(KIWI_VAR_CLIENT_ENCODING, "client_encoding"),
+	KIWI_VAR_NAME(KIWI_VAR_DATESTYLE, "DateStyle"),
+	KIWI_VAR_NAME(KIWI_VAR_TIMEZONE, "TimeZone"),
+	KIWI_VAR_NAME(KIWI_VAR_STANDARD_CONFORMING_STRINGS,
+		      "standard_conforming_strings"),
+	KIWI_VAR_NAME(KIWI_VAR_APPLICATION_NAME, "application_name"),
+	KIWI_VAR_NAME(KIWI_VAR_COMPRESSION, "compression"),
+	KIWI_VAR_NAME(KIWI_VAR_SEARCH_PATH, "search_path"),
+	KIWI_VAR_NAME(KIWI_VAR_STATEMENT_TIMEOUT, "statement_timeout"),
+	KIWI_VAR_NAME(KIWI_VAR_LOCK_TIMEOUT, "lock_timeout"),
+	KIWI_VAR_NAME(KIWI_VAR_IDLE_IN_TRANSACTION_TIMEOUT,
+		      "idle_in_transaction_timeout"),
+	KIWI_VAR_NAME(KIWI_VAR_DEFAULT_TABLE_ACCESS_METHOD,
+		      "default_table_access_method"),
+	KIWI_VAR_NAME(KIWI_VAR_DEFAULT_TOAST_COMPRESSION,
+		      "default_toast_compression"),
+	KIWI_VAR_NAME(KIWI_VAR_CHECK_FUNCTION_BODIES, "check_function_bodies"),
+	KIWI_VAR_NAME(KIWI_VAR_DEFAULT_TRANSACTION_ISOLATION,
+		      "default_transaction_isolation"),
+	KIWI_VAR_NAME(KIWI_VAR_DEFAULT_TRANSACTION_READ_ONLY,
+		      "default_transaction_read_only"),
+	KIWI_VAR_NAME(KIWI_VAR_DEFAULT_TRANSACTION_DEFERRABLE,
+		      "default_transaction_deferrable"),
+	KIWI_VAR_NAME(KIWI_VAR_TRANSACTION_ISOLATION, "transaction_isolation"),
+	KIWI_VAR_NAME(KIWI_VAR_TRANSACTION_READ_ONLY, "transaction_read_only"),
+	KIWI_VAR_NAME(KIWI_VAR_IDLE_SESSION_TIMEOUT, "idle_session_timeout"),
+	KIWI_VAR_NAME(KIWI_VAR_GP_SESSION_ROLE, "gp_session_role"),
+	KIWI_VAR_NAME(KIWI_VAR_ODYSSEY_CATCHUP_TIMEOUT,
+		      "odyssey_catchup_timeout"),
+};
+
+/*
+ * Perfect hash of the names above, case-insensitive. Slot of a name is
+ * (name_len + 2 * first + 35 * last) & 63, where first and last are
+ * name characters with 0x20 bit set and name_len includes the
+ * terminating zero. Coefficients have to be picked again if a new
+ * variable collides, test_vars checks that every name has its own
+ * slot. Empty slots are rejected by name comparison.
+ */
+#define KIWI_VAR_NAME_MIN 9
+#define KIWI_VAR_NAME_MAX 31
+
+static const kiwi_var_type_t kiwi_var_hash_table[64] = {
+	[0] = KIWI_VAR_TIMEZONE,
+	[1] = KIWI_VAR_LOCK_TIMEOUT,
+	[3] = KIWI_VAR_IDLE_SESSION_TIMEOUT,
+	[8] = KIWI_VAR_TRANSACTION_ISOLATION,
+	[9] = KIWI_VAR_TRANSACTION_READ_ONLY,
+	[10] = KIWI_VAR_IDLE_IN_TRANSACTION_TIMEOUT,
+	[16] = KIWI_VAR_DEFAULT_TABLE_ACCESS_METHOD,
+	[18] = KIWI_VAR_ODYSSEY_CATCHUP_TIMEOUT,
+	[20] = KIWI_VAR_STATEMENT_TIMEOUT,
+	[21] = KIWI_VAR_CHECK_FUNCTION_BODIES,
+	[28] = KIWI_VAR_COMPRESSION,
+	[33] = KIWI_VAR_DATESTYLE,
+	[34] = KIWI_VAR_APPLICATION_NAME,
+	[42] = KIWI_VAR_SEARCH_PATH,
+	[43] = KIWI_VAR_CLIENT_ENCODING,
+	[44] = KIWI_VAR_DEFAULT_TOAST_COMPRESSION,
+	[45] = KIWI_VAR_GP_SESSION_ROLE,
+	[48] = KIWI_VAR_DEFAULT_TRANSACTION_ISOLATION,
+	[49] = KIWI_VAR_DEFAULT_TRANSACTION_READ_ONLY,
+	[54] = KIWI_VAR_DEFAULT_TRANSACTION_DEFERRABLE,
+	[59] = KIWI_VAR_STANDARD_CONFORMING_STRINGS,
+};
+
+static inline uint32_t kiwi_var_slot(char *name, int name_len)
+{
+	uint32_t slot = name_len + 2 * ((uint8_t)name[0] | 0x20) +
+			35 * ((uint8_t)name[name_len - 2] | 0x20);
+	return slot & 63;
+}
+
+static inline kiwi_var_type_t kiwi_var_find(char *name, int name_len)
+{
+	if (name_len < KIWI_VAR_NAME_MIN || name_len > KIWI_VAR_NAME_MAX)
+		return KIWI_VAR_UNDEF;
+	kiwi_var_type_t type;
+	type = kiwi_var_hash_table[kiwi_var_slot(name, name_len)];
+	if (kiwi_var_names[type].name_len != name_len)
+		return KIWI_VAR_UNDEF;
+	if (strncasecmp(kiwi_var_names[type].name, name, name_len) != 0)
+		return KIWI_VAR_UNDEF;
+	return type;
+}
+
 static inline void kiwi_var_init(kiwi_var_t *var, char *name, int name_len)
 {
 	var->type = KIWI_VAR_UNDEF;
 	var->name = name;
 	var->name_len = name_len;
 	var->value_len = 0;
+	var->value_hash = 0;
+}
+
+static inline uint32_t kiwi_var_hash(char *value, int value_len)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+	int i;
+	for (i = 0; i < value_len; i++) {
+		hash ^= (uint8_t)value[i];
+		hash *= 16777619u;
+	}
+	return hash;
 }
 
 static inline int kiwi_var_set(kiwi_var_t *var, kiwi_var_type_t type,
@@ -68,6 +177,7 @@ static inline int kiwi_var_set(kiwi_var_t *var, kiwi_var_type_t type,
 		return -1;
 	memcpy(var->value, value, value_len);
 	var->value_len = value_len;
+	var->value_hash = kiwi_var_hash(value, value_len);
 	return 0;
 }
 
@@ -75,6 +185,7 @@ static inline void kiwi_var_unset(kiwi_var_t *var)
 {
 	var->type = KIWI_VAR_UNDEF;
 	var->value_len = 0;
+	var->value_hash = 0;
 }
 
 static inline int kiwi_var_compare(kiwi_var_t *a, kiwi_var_t *b)
@@ -83,6 +194,8 @@ static inline int kiwi_var_compare(kiwi_var_t *a, kiwi_var_t *b)
 		return 0;
 	if (a->value_len != b->value_len)
 		return 0;
+	if (a->value_hash != b->value_hash)
+		return 0;
 	return memcmp(a->value, b->value, a->value_len) == 0;
 }
 
@@ -102,51 +215,10 @@ static inline kiwi_var_t *kiwi_vars_get(kiwi_vars_t *vars, kiwi_var_type_t type)
 
 static inline void kiwi_vars_init(kiwi_vars_t *vars)
 {
-	kiwi_var_init(&vars->vars[KIWI_VAR_CLIENT_ENCODING], "client_encoding",
-		      16);
-	kiwi_var_init(&vars->vars[KIWI_VAR_DATESTYLE], "DateStyle", 10);
-	kiwi_var_init(&vars->vars[KIWI_VAR_TIMEZONE], "TimeZone", 9);
-	kiwi_var_init(&vars->vars[KIWI_VAR_STANDARD_CONFORMING_STRINGS],
-		      "standard_conforming_strings", 28);
-	kiwi_var_init(&vars->vars[KIWI_VAR_APPLICATION_NAME],
-		      "application_name", 17);
-	kiwi_var_init(&vars->vars[KIWI_VAR_COMPRESSION], "compression", 12);
-	kiwi_var_init(&vars->vars[KIWI_VAR_SEARCH_PATH], "search_path", 12);
-	kiwi_var_init(&vars->vars[KIWI_VAR_STATEMENT_TIMEOUT],
-		      "statement_timeout", sizeof("statement_timeout"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_LOCK_TIMEOUT], "lock_timeout",
-		      sizeof("lock_timeout"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_IDLE_IN_TRANSACTION_TIMEOUT],
-		      "idle_in_transaction_timeout",
-		      sizeof("idle_in_transaction_timeout"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_DEFAULT_TABLE_ACCESS_METHOD],
-		      "default_table_access_method",
-		      sizeof("default_table_access_method"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_DEFAULT_TOAST_COMPRESSION],
-		      "default_toast_compression",
-		      sizeof("default_toast_compression"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_CHECK_FUNCTION_BODIES],
-		      "check_function_bodies", sizeof("check_function_bodies"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_DEFAULT_TRANSACTION_ISOLATION],
-		      "default_transaction_isolation",
-		      sizeof("default_transaction_isolation"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_DEFAULT_TRANSACTION_READ_ONLY],
-		      "default_transaction_read_only",
-		      sizeof("default_transaction_read_only"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_DEFAULT_TRANSACTION_DEFERRABLE],
-		      "default_transaction_deferrable",
-		      sizeof("default_transaction_deferrable"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_TRANSACTION_ISOLATION],
-		      "transaction_isolation", sizeof("transaction_isolation"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_TRANSACTION_READ_ONLY],
-		      "transaction_read_only", sizeof("transaction_read_only"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_IDLE_SESSION_TIMEOUT],
-		      "idle_session_timeout", sizeof("idle_session_timeout"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_GP_SESSION_ROLE], "gp_session_role",
-		      sizeof("gp_session_role"));
-	kiwi_var_init(&vars->vars[KIWI_VAR_ODYSSEY_CATCHUP_TIMEOUT],
-		      "odyssey_catchup_timeout",
-		      sizeof("odyssey_catchup_timeout"));
+	kiwi_var_type_t type = 0;
+	for (; type < KIWI_VAR_MAX; type++)
+		kiwi_var_init(&vars->vars[type], kiwi_var_names[type].name,
+			      kiwi_var_names[type].name_len);
 }
 
 static inline int kiwi_vars_set(kiwi_vars_t *vars, kiwi_var_type_t type,
@@ -160,21 +232,6 @@ static inline void kiwi_vars_unset(kiwi_vars_t *vars, kiwi_var_type_t type)
 	kiwi_var_unset(kiwi_vars_of(vars, type));
 }
 
-static inline kiwi_var_type_t kiwi_vars_find(kiwi_vars_t *vars, char *name,
-					     int name_len)
-{
-	kiwi_var_type_t type;
-	type = KIWI_VAR_CLIENT_ENCODING;
-	for (; type < KIWI_VAR_MAX; type++) {
-		kiwi_var_t *var = kiwi_vars_of(vars, type);
-		if (var->name_len != name_len)
-			continue;
-		if (!strncasecmp(var->name, name, name_len))
-			return type;
-	}
-	return KIWI_VAR_UNDEF;
-}
-
 static inline int kiwi_vars_override(kiwi_vars_t *vars,
 				     kiwi_vars_t *override_vars)
 {
@@ -192,7 +249,7 @@ static inline int kiwi_vars_update(kiwi_vars_t *vars, char *name, int name_len,
 				   char *value, int value_len)
 {
 	kiwi_var_type_t type;
-	type = kiwi_vars_find(vars, name, name_len);
+	type = kiwi_var_find(name, name_len);
 	if (type == KIWI_VAR_UNDEF)
 		return -1;
 	kiwi_vars_set(vars, type, value, value_len);
@@ -204,7 +261,7 @@ static inline int kiwi_vars_update_both(kiwi_vars_t *a, kiwi_vars_t *b,
 					int value_len)
 {
 	kiwi_var_type_t type;
-	type = kiwi_vars_find(a, name, name_len);
+	type = kiwi_var_find(name, name_len);
 	if (type == KIWI_VAR_UNDEF)
 		return -1;
 	kiwi_vars_set(a, type, value, value_len);
@@ -30,6 +30,13 @@ int mm_clock_timer_del(mm_clock_t *, mm_timer_t *);
 
 mm_timer_t *mm_clock_timer_min(mm_clock_t *);
 
+static inline uint64_t mm_clock_gettime_us(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * (uint64_t)1e6 + t.tv_nsec / 1000;
+}
+
 static inline void mm_clock_reset(mm_clock_t *clock)
 {
 	clock->time_cached = 0;
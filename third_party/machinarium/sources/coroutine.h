@@ -23,6 +23,7 @@ struct mm_coroutine {
 	mm_contextstack_t stack;
 	mm_context_t context;
 	mm_coroutine_t *resume;
+	uint64_t time_ready;
 	void *call_ptr;
 	mm_list_t joiners;
 	mm_list_t link_join;
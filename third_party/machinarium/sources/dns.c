@@ -33,8 +33,8 @@ MACHINE_API int machine_getaddrinfo(char *addr, char *service,
 				 .res = res,
 				 .rc = 0 };
 	int rc;
-	rc = mm_taskmgr_new(&machinarium.task_mgr, mm_getaddrinfo_cb, &gai,
-			    time_ms);
+	rc = mm_taskmgr_new(&machinarium.task_mgr, mm_getaddrinfo_cb, NULL,
+			    &gai, time_ms);
 	if (rc == -1)
 		return -1;
 	return gai.rc;
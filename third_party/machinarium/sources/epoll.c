@@ -25,6 +25,8 @@ static mm_poll_t *mm_epoll_create(void)
 	if (epoll == NULL)
 		return NULL;
 	epoll->poll.iface = &mm_epoll_if;
+	epoll->poll.count_wait = 0;
+	epoll->poll.time_wait_us = 0;
 	epoll->count = 0;
 	epoll->size = 1024;
 	int size = sizeof(struct epoll_event) * epoll->size;
@@ -61,19 +63,42 @@ static int mm_epoll_shutdown(mm_poll_t *poll)
 	return 0;
 }
 
+static inline void mm_epoll_step_edge(mm_fd_t *fd, uint32_t events)
+{
+	if (events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP))
+		fd->ready |= MM_R;
+	if (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+		fd->ready |= MM_W;
+	if ((fd->mask & MM_R) && (fd->ready & MM_R) && fd->on_read)
+		fd->on_read(fd);
+	if ((fd->mask & MM_W) && (fd->ready & MM_W) && fd->on_write)
+		fd->on_write(fd);
+}
+
 static int mm_epoll_step(mm_poll_t *poll, int timeout)
 {
 	mm_epoll_t *epoll = (mm_epoll_t *)poll;
 	if (epoll->count == 0)
 		return 0;
 	int count;
+	uint64_t start = mm_clock_gettime_us();
 	count = epoll_wait(epoll->fd, epoll->list, epoll->count, timeout);
+	uint64_t end = mm_clock_gettime_us();
+	poll->count_wait++;
+	poll->time_wait_us += end - start;
+	/* coroutines woken up by callbacks below became ready now */
+	mm_scheduler_set_time(&mm_self->scheduler, end);
 	if (count <= 0)
 		return 0;
 	int i = 0;
 	while (i < count) {
 		struct epoll_event *ev = &epoll->list[i];
 		mm_fd_t *fd = ev->data.ptr;
+		if (fd->edge) {
+			mm_epoll_step_edge(fd, ev->events);
+			i++;
+			continue;
+		}
 		if (fd->on_read) {
 			if (ev->events & EPOLLIN)
 				fd->on_read(fd);
@@ -104,10 +129,16 @@ static int mm_epoll_add(mm_poll_t *poll, mm_fd_t *fd, int mask)
 	struct epoll_event ev;
 	ev.events = 0;
 	fd->mask = mask;
-	if (fd->mask & MM_R)
-		ev.events |= EPOLLIN;
-	if (fd->mask & MM_W)
-		ev.events |= EPOLLOUT;
+	fd->ready = 0;
+	if (fd->edge) {
+		/* armed once, kernel reports current state right away */
+		ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	} else {
+		if (fd->mask & MM_R)
+			ev.events |= EPOLLIN;
+		if (fd->mask & MM_W)
+			ev.events |= EPOLLOUT;
+	}
 	ev.data.ptr = fd;
 	int rc = epoll_ctl(epoll->fd, EPOLL_CTL_ADD, fd->fd, &ev);
 	if (rc == -1)
@@ -133,6 +164,21 @@ static inline int mm_epoll_modify(mm_poll_t *poll, mm_fd_t *fd, int mask)
 	return 0;
 }
 
+static inline int mm_epoll_interest(mm_fd_t *fd, int mask, int rearm)
+{
+	/* edge-triggered fd is never modified in kernel, only
+	 * report readiness which is already known. Data left unread
+	 * produces no new edge, so readiness is reported again on
+	 * every (re)start, even if interest was never dropped */
+	int enabled = mask & (~fd->mask | rearm);
+	fd->mask = mask;
+	if ((enabled & MM_R) && (fd->ready & MM_R) && fd->on_read)
+		fd->on_read(fd);
+	if ((enabled & MM_W) && (fd->ready & MM_W) && fd->on_write)
+		fd->on_write(fd);
+	return 0;
+}
+
 static int mm_epoll_read(mm_poll_t *poll, mm_fd_t *fd, mm_fd_callback_t on_read,
 			 void *arg, int enable)
 {
@@ -143,6 +189,8 @@ static int mm_epoll_read(mm_poll_t *poll, mm_fd_t *fd, mm_fd_callback_t on_read,
 		mask &= ~MM_R;
 	fd->on_read = on_read;
 	fd->on_read_arg = arg;
+	if (fd->edge)
+		return mm_epoll_interest(fd, mask, enable ? MM_R : 0);
 	if (mask == fd->mask)
 		return 0;
 	return mm_epoll_modify(poll, fd, mask);
@@ -158,6 +206,8 @@ static int mm_epoll_write(mm_poll_t *poll, mm_fd_t *fd,
 		mask &= ~MM_W;
 	fd->on_write = on_write;
 	fd->on_write_arg = arg;
+	if (fd->edge)
+		return mm_epoll_interest(fd, mask, enable ? MM_W : 0);
 	if (mask == fd->mask)
 		return 0;
 	return mm_epoll_modify(poll, fd, mask);
@@ -175,6 +225,8 @@ static int mm_epoll_read_write(mm_poll_t *poll, mm_fd_t *fd,
 	fd->on_write_arg = arg;
 	fd->on_read = on_event;
 	fd->on_read_arg = arg;
+	if (fd->edge)
+		return mm_epoll_interest(fd, mask, enable ? MM_R | MM_W : 0);
 	if (mask == fd->mask)
 		return 0;
 	return mm_epoll_modify(poll, fd, mask);
@@ -191,6 +243,7 @@ static int mm_epoll_del(mm_poll_t *poll, mm_fd_t *fd)
 		ev.events |= EPOLLOUT;
 	ev.data.ptr = fd;
 	fd->mask = 0;
+	fd->ready = 0;
 	fd->on_write = NULL;
 	fd->on_write_arg = NULL;
 	fd->on_read = NULL;
@@ -18,6 +18,11 @@ typedef void (*mm_fd_callback_t)(mm_fd_t *);
 struct mm_fd {
 	int fd;
 	int mask;
+	/* edge-triggered mode: fd stays registered for both
+	 * directions, mask only tracks interest and ready
+	 * keeps readiness reported by poller until EAGAIN */
+	int edge;
+	int ready;
 	mm_fd_callback_t on_read;
 	void *on_read_arg;
 	mm_fd_callback_t on_write;
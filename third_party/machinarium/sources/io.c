@@ -24,13 +24,40 @@ MACHINE_API machine_tls_t *machine_tls_create(void)
 	tls->ca_file = NULL;
 	tls->cert_file = NULL;
 	tls->key_file = NULL;
+	if (!RAND_bytes(tls->sid, sizeof(tls->sid))) {
+		free(tls);
+		mm_errno_set(EIO);
+		return NULL;
+	}
+	mm_sleeplock_init(&tls->session_lock);
+	tls->session = NULL;
+	tls->session_resumed = 0;
+	tls->session_full = 0;
+	mm_sleeplock_init(&tls->ctx_lock);
+	tls->ctx = NULL;
+	tls->refs = 1;
 	return (machine_tls_t *)tls;
 }
 
+MACHINE_API void machine_tls_ref(machine_tls_t *obj)
+{
+	mm_tls_t *tls = mm_cast(mm_tls_t *, obj);
+	__sync_add_and_fetch(&tls->refs, 1);
+}
+
 MACHINE_API void machine_tls_free(machine_tls_t *obj)
 {
 	mm_tls_t *tls = mm_cast(mm_tls_t *, obj);
 	mm_errno_set(0);
+	if (__sync_sub_and_fetch(&tls->refs, 1) > 0)
+		return;
+	mm_tls_ctx_t *ctx = tls->ctx;
+	while (ctx) {
+		mm_tls_ctx_t *next = ctx->next;
+		SSL_CTX_free(ctx->tls_ctx);
+		free(ctx);
+		ctx = next;
+	}
 	if (tls->protocols)
 		free(tls->protocols);
 	if (tls->server)
@@ -43,9 +70,21 @@ MACHINE_API void machine_tls_free(machine_tls_t *obj)
 		free(tls->cert_file);
 	if (tls->key_file)
 		free(tls->key_file);
+	if (tls->session)
+		SSL_SESSION_free(tls->session);
 	free(tls);
 }
 
+MACHINE_API void machine_tls_stat(machine_tls_t *obj, uint64_t *resumed,
+				  uint64_t *full)
+{
+	mm_tls_t *tls = mm_cast(mm_tls_t *, obj);
+	mm_sleeplock_lock(&tls->session_lock);
+	*resumed = tls->session_resumed;
+	*full = tls->session_full;
+	mm_sleeplock_unlock(&tls->session_lock);
+}
+
 MACHINE_API int machine_tls_set_verify(machine_tls_t *obj, char *mode)
 {
 	mm_tls_t *tls = mm_cast(mm_tls_t *, obj);
@@ -158,6 +197,10 @@ MACHINE_API int machine_set_tls(machine_io_t *obj, machine_tls_t *tls,
 		mm_errno_set(EINPROGRESS);
 		return -1;
 	}
+	/* ssl reports both want read and want write as EAGAIN,
+	 * readiness cannot be tracked reliably */
+	if (mm_io_set_level_triggered(io) == -1)
+		return -1;
 	io->tls = mm_cast(mm_tls_t *, tls);
 	return mm_tls_handshake(io, timeout);
 }
@@ -172,6 +215,8 @@ MACHINE_API int machine_set_compression(machine_io_t *obj, char algorithm)
 
 	int impl = mm_zpq_get_algorithm_impl(algorithm);
 	if (impl >= 0) {
+		if (mm_io_set_level_triggered(io) == -1)
+			return -1;
 		io->zpq_stream =
 			zpq_create(impl, (mm_zpq_tx_func)mm_io_write,
 				   (mm_zpq_rx_func)mm_io_read, obj, NULL, 0);
@@ -261,6 +306,57 @@ MACHINE_API int machine_set_keepalive(machine_io_t *obj, int enable, int delay,
 	return 0;
 }
 
+MACHINE_API int machine_set_edge_triggered(machine_io_t *obj, int enable)
+{
+	mm_io_t *io = mm_cast(mm_io_t *, obj);
+	mm_errno_set(0);
+	if (io->attached) {
+		mm_errno_set(EINPROGRESS);
+		return -1;
+	}
+	io->opt_edge_triggered = enable;
+	return 0;
+}
+
+MACHINE_API int machine_edge_triggered(machine_io_t *obj)
+{
+	mm_io_t *io = mm_cast(mm_io_t *, obj);
+	return io->handle.edge;
+}
+
+int mm_io_set_level_triggered(mm_io_t *io)
+{
+	if (!io->handle.edge)
+		return 0;
+	io->handle.edge = 0;
+	if (!io->attached)
+		return 0;
+	/* re-register fd, level-triggered poller reports current
+	 * state on its own */
+	int mask = io->handle.mask;
+	mm_fd_callback_t on_read = io->handle.on_read;
+	void *on_read_arg = io->handle.on_read_arg;
+	mm_fd_callback_t on_write = io->handle.on_write;
+	void *on_write_arg = io->handle.on_write_arg;
+	int rc;
+	rc = mm_loop_delete(&mm_self->loop, &io->handle);
+	if (rc == -1) {
+		mm_errno_set(errno);
+		return -1;
+	}
+	io->handle.on_read = on_read;
+	io->handle.on_read_arg = on_read_arg;
+	io->handle.on_write = on_write;
+	io->handle.on_write_arg = on_write_arg;
+	rc = mm_loop_add(&mm_self->loop, &io->handle, mask);
+	if (rc == -1) {
+		io->attached = 0;
+		mm_errno_set(errno);
+		return -1;
+	}
+	return 0;
+}
+
 MACHINE_API int machine_io_attach(machine_io_t *obj)
 {
 	mm_io_t *io = mm_cast(mm_io_t *, obj);
@@ -269,6 +365,9 @@ MACHINE_API int machine_io_attach(machine_io_t *obj)
 		mm_errno_set(EINPROGRESS);
 		return -1;
 	}
+	/* tls and compression streams keep level-triggered mode */
+	io->handle.edge = io->opt_edge_triggered && !mm_tls_is_active(io) &&
+			  !mm_compression_is_active(io);
 	int rc;
 	rc = mm_loop_add(&mm_self->loop, &io->handle, 0);
 	if (rc == -1) {
@@ -373,7 +472,11 @@ ssize_t mm_io_write(mm_io_t *io, void *buf, size_t size)
 		return rc;
 	int errno_ = errno;
 	mm_errno_set(errno_);
-	if (errno_ == EAGAIN || errno_ == EWOULDBLOCK || errno_ == EINTR)
+	if (errno_ == EAGAIN || errno_ == EWOULDBLOCK) {
+		io->handle.ready &= ~MM_W;
+		return -1;
+	}
+	if (errno_ == EINTR)
 		return -1;
 	io->connected = 0;
 	return -1;
@@ -394,8 +497,11 @@ ssize_t mm_io_read(mm_io_t *io, void *buf, size_t size)
 	if (rc < 0) {
 		int errno_ = errno;
 		mm_errno_set(errno_);
-		if (errno_ == EAGAIN || errno_ == EWOULDBLOCK ||
-		    errno_ == EINTR)
+		if (errno_ == EAGAIN || errno_ == EWOULDBLOCK) {
+			io->handle.ready &= ~MM_R;
+			return -1;
+		}
+		if (errno_ == EINTR)
 			return -1;
 	}
 	/* error of eof */
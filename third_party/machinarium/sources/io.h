@@ -21,10 +21,22 @@ struct mm_tls {
 	char *ca_file;
 	char *cert_file;
 	char *key_file;
+	/* shared by all workers, so sessions resume on any of them */
+	unsigned char sid[SSL_MAX_SID_CTX_LENGTH];
+	/* client side session reuse */
+	mm_sleeplock_t session_lock;
+	SSL_SESSION *session;
+	uint64_t session_resumed;
+	uint64_t session_full;
+	/* SSL_CTX per machine, freed with the object */
+	mm_sleeplock_t ctx_lock;
+	mm_tls_ctx_t *ctx;
+	int refs;
 };
 
 struct mm_tls_ctx {
-	mm_tls_t *key;
+	uint64_t machine_id;
+	int is_client;
 	SSL_CTX *tls_ctx;
 	mm_tls_ctx_t *next;
 };
@@ -42,6 +54,7 @@ struct mm_io {
 	int opt_keepalive_interval;
 	int opt_keepalive_probes;
 	int opt_keepalive_usr_timeout;
+	int opt_edge_triggered;
 	/* tls */
 	mm_tls_t *tls;
 	SSL *tls_ssl;
@@ -64,5 +77,6 @@ int mm_io_socket_set(mm_io_t *, int);
 int mm_io_socket(mm_io_t *, struct sockaddr *);
 ssize_t mm_io_write(mm_io_t *, void *, size_t);
 ssize_t mm_io_read(mm_io_t *, void *, size_t);
+int mm_io_set_level_triggered(mm_io_t *);
 
 #endif /* MM_IO_H */
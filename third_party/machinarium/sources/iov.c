@@ -52,3 +52,9 @@ MACHINE_API int machine_iov_pending(machine_iov_t *obj)
 	mm_iov_t *iov = mm_cast(mm_iov_t *, obj);
 	return mm_iov_pending(iov);
 }
+
+MACHINE_API size_t machine_iov_size(machine_iov_t *obj)
+{
+	mm_iov_t *iov = mm_cast(mm_iov_t *, obj);
+	return iov->size;
+}
@@ -17,6 +17,7 @@ struct mm_iov {
 	mm_buf_t iov;
 	int iov_count;
 	int write_pos;
+	size_t size;
 	mm_list_t msg_list;
 };
 
@@ -26,6 +27,7 @@ static inline void mm_iov_init(mm_iov_t *iov)
 	mm_list_init(&iov->msg_list);
 	iov->write_pos = 0;
 	iov->iov_count = 0;
+	iov->size = 0;
 }
 
 static inline void mm_iov_gc(mm_iov_t *iov)
@@ -50,6 +52,7 @@ static inline void mm_iov_reset(mm_iov_t *iov)
 {
 	iov->write_pos = 0;
 	iov->iov_count = 0;
+	iov->size = 0;
 	mm_buf_reset(&iov->iov);
 	mm_iov_gc(iov);
 }
@@ -67,6 +70,7 @@ mm_iov_add_pointer(mm_iov_t *iov, void *pointer, int size)
 	iovec->iov_len = size;
 	mm_buf_advance(&iov->iov, sizeof(struct iovec));
 	iov->iov_count++;
+	iov->size += size;
 	return 0;
 }
 
@@ -95,6 +99,7 @@ static inline struct iovec *mm_iov_pos(mm_iov_t *iov)
 static inline void mm_iov_advance(mm_iov_t *iov, int size)
 {
 	struct iovec *iovec = mm_iov_pos(iov);
+	iov->size -= size;
 	while (iov->iov_count > 0) {
 		if (iovec->iov_len > (size_t)size) {
 			iovec->iov_base = (char *)iovec->iov_base + size;
@@ -25,6 +25,8 @@ extern "C" {
 
 typedef void (*machine_coroutine_t)(void *arg);
 
+typedef void (*machine_task_function_t)(void *arg);
+
 #define mm_yield machine_sleep(0);
 
 /* library handles */
@@ -34,7 +36,9 @@ typedef struct machine_msg_private machine_msg_t;
 typedef struct machine_channel_private machine_channel_t;
 typedef struct machine_tls_private machine_tls_t;
 typedef struct machine_iov_private machine_iov_t;
+typedef struct machine_splice_private machine_splice_t;
 typedef struct machine_io_private machine_io_t;
+typedef struct machine_taskmgr_private machine_taskmgr_t;
 
 /* configuration */
 
@@ -46,6 +50,14 @@ MACHINE_API void machinarium_set_coroutine_cache_size(int size);
 
 MACHINE_API void machinarium_set_msg_cache_gc_size(int size);
 
+/*
+ * Lifetime of the process wide TLS session ticket keys, in seconds.
+ * Keys are shared by all machines and the previous key is still
+ * accepted for one more lifetime after rotation. Zero leaves
+ * OpenSSL's per context ticket keys in place.
+ */
+MACHINE_API void machinarium_set_tls_ticket_lifetime(int seconds);
+
 /* main */
 
 MACHINE_API int machinarium_init(void);
@@ -81,6 +93,23 @@ machine_stat(uint64_t *coroutine_count, uint64_t *coroutine_cache_count,
 	     uint64_t *msg_allocated, uint64_t *msg_cache_count,
 	     uint64_t *msg_cache_gc_count, uint64_t *msg_cache_size);
 
+/* event loop stats of the current machine: counters and times are
+ * cumulative, maximums are reset by each call */
+typedef struct {
+	uint64_t count_ready;
+	uint64_t count_active;
+	uint64_t count_timer;
+	uint64_t count_switch;
+	uint64_t count_wait;
+	uint64_t time_wait_us;
+	uint64_t time_run_us;
+	uint64_t run_max_us;
+	uint64_t ready_delay_us;
+	uint64_t ready_delay_max_us;
+} machine_loop_stat_t;
+
+MACHINE_API void machine_loop_stat(machine_loop_stat_t *stat);
+
 /* signals */
 
 MACHINE_API int machine_signal_init(sigset_t *, sigset_t *);
@@ -152,10 +181,34 @@ MACHINE_API mm_retcode_t machine_channel_write(machine_channel_t *,
 MACHINE_API machine_msg_t *machine_channel_read(machine_channel_t *,
 						uint32_t time_ms);
 
+/* task executor */
+
+MACHINE_API machine_taskmgr_t *machine_taskmgr_create(char *name,
+						      int workers_count);
+
+MACHINE_API void machine_taskmgr_free(machine_taskmgr_t *);
+
+/*
+ * Run function(arg) on one of the executor threads and wait for it.
+ *
+ * On timeout or cancel -1 is returned and the task is abandoned:
+ * ownership of arg passes to the executor, which calls on_abandon(arg)
+ * once the function has finished (or instead of running it, if it was
+ * still queued). With on_abandon == NULL the task is always waited to
+ * completion and time_ms only bounds each wait round.
+ */
+MACHINE_API int machine_task_run(machine_taskmgr_t *,
+				 machine_task_function_t function,
+				 machine_task_function_t on_abandon, void *arg,
+				 uint32_t time_ms);
+
 /* tls */
 
 MACHINE_API machine_tls_t *machine_tls_create(void);
 
+/* free drops a reference, the object is released with the last one */
+MACHINE_API void machine_tls_ref(machine_tls_t *);
+
 MACHINE_API void machine_tls_free(machine_tls_t *);
 
 MACHINE_API int machine_tls_set_verify(machine_tls_t *, char *);
@@ -172,6 +225,10 @@ MACHINE_API int machine_tls_set_cert_file(machine_tls_t *, char *);
 
 MACHINE_API int machine_tls_set_key_file(machine_tls_t *, char *);
 
+/* client side handshakes that resumed a cached session or ran in full */
+MACHINE_API void machine_tls_stat(machine_tls_t *, uint64_t *resumed,
+				  uint64_t *full);
+
 /* io control */
 
 MACHINE_API machine_io_t *machine_io_create(void);
@@ -192,6 +249,10 @@ MACHINE_API int machine_set_keepalive(machine_io_t *, int enable, int delay,
 				      int interval, int probes,
 				      int usr_timeout);
 
+MACHINE_API int machine_set_edge_triggered(machine_io_t *, int enable);
+
+MACHINE_API int machine_edge_triggered(machine_io_t *);
+
 MACHINE_API int machine_set_tls(machine_io_t *, machine_tls_t *, uint32_t);
 MACHINE_API int machine_set_compression(machine_io_t *, char algorithm);
 
@@ -239,6 +300,23 @@ MACHINE_API int machine_iov_add(machine_iov_t *, machine_msg_t *);
 
 MACHINE_API int machine_iov_pending(machine_iov_t *);
 
+MACHINE_API size_t machine_iov_size(machine_iov_t *);
+
+/* splice */
+
+MACHINE_API machine_splice_t *machine_splice_create(void);
+
+MACHINE_API void machine_splice_free(machine_splice_t *);
+
+MACHINE_API int machine_splice_supported(machine_io_t *);
+
+MACHINE_API size_t machine_splice_pending(machine_splice_t *);
+
+MACHINE_API ssize_t machine_splice_read(machine_splice_t *, machine_io_t *,
+					size_t);
+
+MACHINE_API ssize_t machine_splice_write(machine_splice_t *, machine_io_t *);
+
 /* read */
 
 MACHINE_API int machine_read_active(machine_io_t *);
@@ -249,6 +327,8 @@ MACHINE_API int machine_read_stop(machine_io_t *);
 
 MACHINE_API ssize_t machine_read_raw(machine_io_t *, void *, size_t);
 
+MACHINE_API ssize_t machine_readv_raw(machine_io_t *, struct iovec *, int);
+
 MACHINE_API machine_msg_t *machine_read(machine_io_t *, size_t,
 					uint32_t time_ms);
 
@@ -91,6 +91,7 @@
 #include "mm.h"
 
 #include "iov.h"
+#include "splice.h"
 #include "io.h"
 #include "tls.h"
 #include "compression.h"
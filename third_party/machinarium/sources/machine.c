@@ -72,8 +72,6 @@ MACHINE_API int64_t machine_create(char *name, machine_coroutine_t function,
 	machine->id = 0;
 	machine->main = function;
 	machine->main_arg = arg;
-	machine->server_tls_ctx = NULL;
-	machine->client_tls_ctx = NULL;
 	machine->name = NULL;
 	if (name) {
 		machine->name = strdup(name);
@@ -119,8 +117,8 @@ MACHINE_API int64_t machine_create(char *name, machine_coroutine_t function,
 		return -1;
 	}
 	mm_machinemgr_add(&machinarium.machine_mgr, machine);
-	rc = mm_thread_create(&machine->thread, PTHREAD_STACK_MIN, machine_main,
-			      machine);
+	rc = mm_thread_create(&machine->thread, MM_MACHINE_STACK_SIZE,
+			      machine_main, machine);
 	if (rc == -1) {
 		mm_machinemgr_delete(&machinarium.machine_mgr, machine);
 		mm_eventmgr_free(&machine->event_mgr, &machine->loop);
@@ -259,6 +257,24 @@ MACHINE_API uint64_t machine_time_us(void)
 	return mm_self->loop.clock.time_us;
 }
 
+MACHINE_API void machine_loop_stat(machine_loop_stat_t *stat)
+{
+	mm_scheduler_t *scheduler = &mm_self->scheduler;
+	mm_loop_t *loop = &mm_self->loop;
+	stat->count_ready = scheduler->count_ready;
+	stat->count_active = scheduler->count_active;
+	stat->count_timer = loop->clock.timers_count;
+	stat->count_switch = scheduler->count_switch;
+	stat->count_wait = loop->poll->count_wait;
+	stat->time_wait_us = loop->poll->time_wait_us;
+	stat->time_run_us = scheduler->time_run_us;
+	stat->run_max_us = scheduler->run_max_us;
+	stat->ready_delay_us = scheduler->ready_delay_us;
+	stat->ready_delay_max_us = scheduler->ready_delay_max_us;
+	scheduler->run_max_us = 0;
+	scheduler->ready_delay_max_us = 0;
+}
+
 MACHINE_API uint32_t machine_timeofday_sec(void)
 {
 	mm_clock_update(&mm_self->loop.clock);
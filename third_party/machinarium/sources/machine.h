@@ -9,6 +9,13 @@
 
 typedef struct mm_machine mm_machine_t;
 
+/*
+ * Event loop callbacks (TLS handshakes included) run on the machine
+ * thread stack, and OpenSSL 3 private key operations alone need more
+ * than PTHREAD_STACK_MIN.
+ */
+#define MM_MACHINE_STACK_SIZE (256 * 1024)
+
 struct mm_machine {
 	volatile int online;
 	uint64_t id;
@@ -24,8 +31,6 @@ struct mm_machine {
 	mm_coroutine_cache_t coroutine_cache;
 	mm_loop_t loop;
 	mm_list_t link;
-	struct mm_tls_ctx *server_tls_ctx;
-	struct mm_tls_ctx *client_tls_ctx;
 };
 
 extern __thread mm_machine_t *mm_self;
@@ -12,6 +12,7 @@ static int machinarium_stack_size = 0;
 static int machinarium_pool_size = 0;
 static int machinarium_coroutine_cache_size = 0;
 static int machinarium_msg_cache_gc_size = 0;
+static int machinarium_tls_ticket_lifetime = 0;
 static int machinarium_initialized = 0;
 mm_t machinarium;
 
@@ -40,6 +41,11 @@ MACHINE_API void machinarium_set_msg_cache_gc_size(int size)
 	machinarium_msg_cache_gc_size = size;
 }
 
+MACHINE_API void machinarium_set_tls_ticket_lifetime(int seconds)
+{
+	machinarium_tls_ticket_lifetime = seconds;
+}
+
 MACHINE_API int machinarium_init(void)
 {
 	if (machinarium_initialized)
@@ -57,11 +63,14 @@ MACHINE_API int machinarium_init(void)
 	machinarium.config.coroutine_cache_size =
 		machinarium_coroutine_cache_size;
 	machinarium.config.msg_cache_gc_size = machinarium_msg_cache_gc_size;
+	machinarium.config.tls_ticket_lifetime =
+		machinarium_tls_ticket_lifetime;
 
 	mm_machinemgr_init(&machinarium.machine_mgr);
 	mm_tls_engine_init();
 	mm_taskmgr_init(&machinarium.task_mgr);
-	mm_taskmgr_start(&machinarium.task_mgr, machinarium.config.pool_size);
+	mm_taskmgr_start(&machinarium.task_mgr, "resolver",
+			 machinarium.config.pool_size);
 	machinarium_initialized = 1;
 	return 0;
 }
@@ -16,6 +16,7 @@ struct mm_config {
 	int pool_size;
 	int coroutine_cache_size;
 	int msg_cache_gc_size;
+	int tls_ticket_lifetime;
 };
 
 struct mm {
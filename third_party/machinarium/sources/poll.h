@@ -26,6 +26,9 @@ struct mm_pollif {
 
 struct mm_poll {
 	mm_pollif_t *iface;
+	/* stats */
+	uint64_t count_wait;
+	uint64_t time_wait_us;
 };
 
 #endif /* MM_POLL_H */
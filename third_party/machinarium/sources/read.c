@@ -95,6 +95,36 @@ MACHINE_API ssize_t machine_read_raw(machine_io_t *obj, void *buf, size_t size)
 	return mm_io_read(io, buf, size);
 }
 
+MACHINE_API ssize_t machine_readv_raw(machine_io_t *obj, struct iovec *iov,
+				      int iovc)
+{
+	mm_io_t *io = mm_cast(mm_io_t *, obj);
+
+	/* tls and compression streams are read into the first
+	 * buffer only, caller handles short reads */
+	if (mm_tls_is_active(io) || mm_compression_is_active(io))
+		return machine_read_raw(obj, iov[0].iov_base, iov[0].iov_len);
+
+	mm_errno_set(0);
+	ssize_t rc;
+	rc = mm_socket_readv(io->fd, iov, iovc);
+	if (rc > 0)
+		return rc;
+	if (rc < 0) {
+		int errno_ = errno;
+		mm_errno_set(errno_);
+		if (errno_ == EAGAIN || errno_ == EWOULDBLOCK) {
+			io->handle.ready &= ~MM_R;
+			return -1;
+		}
+		if (errno_ == EINTR)
+			return -1;
+	}
+	/* error or eof */
+	io->connected = 0;
+	return rc;
+}
+
 static inline int machine_read_to(machine_io_t *obj, machine_msg_t *msg,
 				  size_t size, uint32_t time_ms)
 {
@@ -43,6 +43,12 @@ int mm_scheduler_init(mm_scheduler_t *scheduler)
 	scheduler->id_seq = 0;
 	scheduler->count_ready = 0;
 	scheduler->count_active = 0;
+	scheduler->time_us = mm_clock_gettime_us();
+	scheduler->count_switch = 0;
+	scheduler->time_run_us = 0;
+	scheduler->run_max_us = 0;
+	scheduler->ready_delay_us = 0;
+	scheduler->ready_delay_max_us = 0;
 	mm_coroutine_init(&scheduler->main);
 	scheduler->current = &scheduler->main;
 	return 0;
@@ -66,15 +72,36 @@ void mm_scheduler_free(mm_scheduler_t *scheduler)
 
 void mm_scheduler_run(mm_scheduler_t *scheduler, mm_coroutine_cache_t *cache)
 {
+	if (scheduler->count_ready == 0)
+		return;
+	/* end of one coroutine run is the start of the next one, so
+	 * the clock is read once per switch */
+	uint64_t start = mm_clock_gettime_us();
 	while (scheduler->count_ready > 0) {
 		mm_coroutine_t *coroutine;
 		coroutine = mm_container_of(scheduler->list_ready.next,
 					    mm_coroutine_t, link);
+		if (start > coroutine->time_ready) {
+			uint64_t delay = start - coroutine->time_ready;
+			scheduler->ready_delay_us += delay;
+			if (delay > scheduler->ready_delay_max_us)
+				scheduler->ready_delay_max_us = delay;
+		}
+		scheduler->time_us = start;
 		mm_scheduler_set(&mm_self->scheduler, coroutine, MM_CACTIVE);
 		mm_scheduler_call(&mm_self->scheduler, coroutine);
 		if (coroutine->state == MM_CFREE)
 			mm_coroutine_cache_push(cache, coroutine);
+
+		uint64_t end = mm_clock_gettime_us();
+		uint64_t run = end - start;
+		scheduler->count_switch++;
+		scheduler->time_run_us += run;
+		if (run > scheduler->run_max_us)
+			scheduler->run_max_us = run;
+		start = end;
 	}
+	scheduler->time_us = start;
 }
 
 void mm_scheduler_new(mm_scheduler_t *scheduler, mm_coroutine_t *coroutine,
@@ -135,6 +162,7 @@ void mm_scheduler_set(mm_scheduler_t *scheduler, mm_coroutine_t *coroutine,
 	case MM_CREADY:
 		target = &scheduler->list_ready;
 		scheduler->count_ready++;
+		coroutine->time_ready = scheduler->time_us;
 		break;
 	case MM_CACTIVE:
 		target = &scheduler->list_active;
@@ -17,6 +17,14 @@ struct mm_scheduler {
 	mm_list_t list_ready;
 	mm_list_t list_active;
 	uint64_t id_seq;
+	/* last time observed by scheduler, used to stamp ready coroutines */
+	uint64_t time_us;
+	/* stats */
+	uint64_t count_switch;
+	uint64_t time_run_us;
+	uint64_t run_max_us;
+	uint64_t ready_delay_us;
+	uint64_t ready_delay_max_us;
 };
 
 static inline mm_coroutine_t *mm_scheduler_current(mm_scheduler_t *scheduler)
@@ -24,6 +32,12 @@ static inline mm_coroutine_t *mm_scheduler_current(mm_scheduler_t *scheduler)
 	return scheduler->current;
 }
 
+static inline void mm_scheduler_set_time(mm_scheduler_t *scheduler,
+					 uint64_t time_us)
+{
+	scheduler->time_us = time_us;
+}
+
 static inline int mm_scheduler_online(mm_scheduler_t *scheduler)
 {
 	return scheduler->count_active + scheduler->count_ready;
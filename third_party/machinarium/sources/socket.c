@@ -205,6 +205,13 @@ int mm_socket_read(int fd, void *buf, int size)
 	return rc;
 }
 
+int mm_socket_readv(int fd, struct iovec *iov, int iovc)
+{
+	int rc;
+	rc = readv(fd, iov, iovc);
+	return rc;
+}
+
 int mm_socket_getsockname(int fd, struct sockaddr *sa, socklen_t *salen)
 {
 	int rc;
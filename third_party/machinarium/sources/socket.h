@@ -25,6 +25,7 @@ int mm_socket_accept(int, struct sockaddr *, socklen_t *);
 int mm_socket_write(int, void *, int);
 int mm_socket_writev(int, struct iovec *, int);
 int mm_socket_read(int, void *, int);
+int mm_socket_readv(int, struct iovec *, int);
 int mm_socket_getsockname(int, struct sockaddr *, socklen_t *);
 int mm_socket_getpeername(int, struct sockaddr *, socklen_t *);
 int mm_socket_getaddrinfo(char *, char *, struct addrinfo *,
@@ -0,0 +1,108 @@
+/*
+ * machinarium.
+ *
+ * cooperative multitasking engine.
+ */
+
+#include <machinarium.h>
+#include <machinarium_private.h>
+
+MACHINE_API machine_splice_t *machine_splice_create(void)
+{
+	mm_errno_set(0);
+	mm_splice_t *sp = malloc(sizeof(mm_splice_t));
+	if (sp == NULL) {
+		mm_errno_set(ENOMEM);
+		return NULL;
+	}
+	int rc;
+	rc = pipe2(sp->fd, O_NONBLOCK | O_CLOEXEC);
+	if (rc == -1) {
+		mm_errno_set(errno);
+		free(sp);
+		return NULL;
+	}
+	sp->pending = 0;
+	return (machine_splice_t *)sp;
+}
+
+MACHINE_API void machine_splice_free(machine_splice_t *obj)
+{
+	mm_splice_t *sp = mm_cast(mm_splice_t *, obj);
+	close(sp->fd[0]);
+	close(sp->fd[1]);
+	free(sp);
+}
+
+MACHINE_API int machine_splice_supported(machine_io_t *obj)
+{
+	mm_io_t *io = mm_cast(mm_io_t *, obj);
+	/* data must be passed as is */
+	return !mm_tls_is_active(io) && !mm_compression_is_active(io);
+}
+
+MACHINE_API size_t machine_splice_pending(machine_splice_t *obj)
+{
+	mm_splice_t *sp = mm_cast(mm_splice_t *, obj);
+	return sp->pending;
+}
+
+MACHINE_API ssize_t machine_splice_read(machine_splice_t *obj,
+					machine_io_t *src, size_t size)
+{
+	mm_splice_t *sp = mm_cast(mm_splice_t *, obj);
+	mm_io_t *io = mm_cast(mm_io_t *, src);
+	mm_errno_set(0);
+	ssize_t rc;
+	rc = splice(io->fd, NULL, sp->fd[1], NULL, size,
+		    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+	if (rc > 0) {
+		sp->pending += rc;
+		return rc;
+	}
+	if (rc == 0) {
+		/* eof */
+		io->connected = 0;
+		return 0;
+	}
+	int errno_ = errno;
+	mm_errno_set(errno_);
+	/* EAGAIN is also reported when pipe is full, so socket
+	 * readiness can be reset only when pipe is empty */
+	if (errno_ == EAGAIN || errno_ == EWOULDBLOCK) {
+		if (sp->pending == 0)
+			io->handle.ready &= ~MM_R;
+		return -1;
+	}
+	if (errno_ == EINTR)
+		return -1;
+	io->connected = 0;
+	return -1;
+}
+
+MACHINE_API ssize_t machine_splice_write(machine_splice_t *obj,
+					 machine_io_t *dst)
+{
+	mm_splice_t *sp = mm_cast(mm_splice_t *, obj);
+	mm_io_t *io = mm_cast(mm_io_t *, dst);
+	mm_errno_set(0);
+	if (sp->pending == 0)
+		return 0;
+	ssize_t rc;
+	rc = splice(sp->fd[0], NULL, io->fd, NULL, sp->pending,
+		    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+	if (rc > 0) {
+		sp->pending -= rc;
+		return rc;
+	}
+	int errno_ = errno;
+	mm_errno_set(errno_);
+	if (errno_ == EAGAIN || errno_ == EWOULDBLOCK) {
+		io->handle.ready &= ~MM_W;
+		return -1;
+	}
+	if (errno_ == EINTR)
+		return -1;
+	io->connected = 0;
+	return -1;
+}
@@ -0,0 +1,22 @@
+#ifndef MM_SPLICE_H
+#define MM_SPLICE_H
+
+/*
+ * machinarium.
+ *
+ * cooperative multitasking engine.
+ */
+
+/*
+ * Pipe used to move data between two sockets
+ * without copying it to user space
+ * */
+
+typedef struct mm_splice mm_splice_t;
+
+struct mm_splice {
+	int fd[2];
+	size_t pending;
+};
+
+#endif /* MM_SPLICE_H */
@@ -11,9 +11,19 @@ typedef struct mm_task mm_task_t;
 
 typedef void (*mm_task_function_t)(void *);
 
+typedef enum {
+	MM_TASK_PENDING,
+	MM_TASK_RUNNING,
+	MM_TASK_DONE,
+	MM_TASK_ABANDONED
+} mm_taskstate_t;
+
 struct mm_task {
 	mm_task_function_t function;
+	mm_task_function_t on_abandon;
 	void *arg;
+	mm_sleeplock_t lock;
+	mm_taskstate_t state;
 	mm_event_t on_complete;
 };
 
@@ -10,15 +10,37 @@
 
 enum { MM_TASK, MM_TASK_EXIT };
 
-static void mm_taskmgr_main(void *arg __attribute__((unused)))
+static inline void mm_taskmgr_complete(mm_msg_t *msg)
 {
+	mm_task_t *task;
+	task = (mm_task_t *)msg->data.start;
+
+	/* waiter has gone, task owns the argument now */
+	mm_sleeplock_lock(&task->lock);
+	if (task->state == MM_TASK_ABANDONED) {
+		mm_sleeplock_unlock(&task->lock);
+		if (task->on_abandon)
+			task->on_abandon(task->arg);
+		machine_msg_free((machine_msg_t *)msg);
+		return;
+	}
+	task->state = MM_TASK_DONE;
+	int event_mgr_fd;
+	event_mgr_fd = mm_eventmgr_signal(&task->on_complete);
+	mm_sleeplock_unlock(&task->lock);
+	if (event_mgr_fd > 0)
+		mm_eventmgr_wakeup(event_mgr_fd);
+}
+
+static void mm_taskmgr_main(void *arg)
+{
+	mm_taskmgr_t *mgr = arg;
 	sigset_t mask;
 	sigfillset(&mask);
 	pthread_sigmask(SIG_BLOCK, &mask, NULL);
 	for (;;) {
 		mm_msg_t *msg;
-		msg = mm_channel_read(&machinarium.task_mgr.channel,
-				      UINT32_MAX);
+		msg = mm_channel_read(&mgr->channel, UINT32_MAX);
 		assert(msg != NULL);
 		if (msg->type == MM_TASK_EXIT) {
 			free(msg);
@@ -29,11 +51,17 @@ static void mm_taskmgr_main(void *arg __attribute__((unused)))
 
 		mm_task_t *task;
 		task = (mm_task_t *)msg->data.start;
-		task->function(task->arg);
-		int event_mgr_fd;
-		event_mgr_fd = mm_eventmgr_signal(&task->on_complete);
-		if (event_mgr_fd > 0)
-			mm_eventmgr_wakeup(event_mgr_fd);
+
+		/* skip tasks abandoned while still queued */
+		mm_sleeplock_lock(&task->lock);
+		int abandoned = task->state == MM_TASK_ABANDONED;
+		if (!abandoned)
+			task->state = MM_TASK_RUNNING;
+		mm_sleeplock_unlock(&task->lock);
+
+		if (!abandoned)
+			task->function(task->arg);
+		mm_taskmgr_complete(msg);
 	}
 }
 
@@ -42,9 +70,10 @@ void mm_taskmgr_init(mm_taskmgr_t *mgr)
 	mgr->workers_count = 0;
 	mgr->workers = NULL;
 	mm_channel_init(&mgr->channel);
+	mgr->channel.limit_policy = MM_CHANNEL_UNLIMITED;
 }
 
-int mm_taskmgr_start(mm_taskmgr_t *mgr, int workers_count)
+int mm_taskmgr_start(mm_taskmgr_t *mgr, char *name, int workers_count)
 {
 	mgr->workers_count = workers_count;
 	mgr->workers = malloc(sizeof(int) * workers_count);
@@ -52,9 +81,11 @@ int mm_taskmgr_start(mm_taskmgr_t *mgr, int workers_count)
 		return -1;
 	int i = 0;
 	for (; i < workers_count; i++) {
-		char name[32];
-		mm_snprintf(name, sizeof(name), "resolver: %d", i);
-		mgr->workers[i] = machine_create(name, mm_taskmgr_main, NULL);
+		char worker_name[32];
+		mm_snprintf(worker_name, sizeof(worker_name), "%s: %d", name,
+			    i);
+		mgr->workers[i] = machine_create(worker_name, mm_taskmgr_main,
+						 mgr);
 	}
 	return 0;
 }
@@ -62,32 +93,45 @@ int mm_taskmgr_start(mm_taskmgr_t *mgr, int workers_count)
 void mm_taskmgr_stop(mm_taskmgr_t *mgr)
 {
 	int i;
-	int rc;
 	for (i = 0; i < mgr->workers_count; i++) {
 		mm_msg_t *msg;
 		msg = malloc(sizeof(mm_msg_t));
-		if (msg == NULL) {
-			/* todo: */
-			abort();
-			return;
-		}
+		if (msg == NULL)
+			break;
 		mm_msg_init(msg, MM_TASK_EXIT);
 		mm_channel_write(&mgr->channel, msg);
 	}
 	for (i = 0; i < mgr->workers_count; i++) {
-		rc = machine_wait(mgr->workers[i]);
-		if (rc != MM_OK_RETCODE) {
-			/* TODO: handle gracefully */
-			abort();
-			return;
-		}
+		if (mgr->workers[i] == -1)
+			continue;
+		machine_wait(mgr->workers[i]);
 	}
 	mm_channel_free(&mgr->channel);
 	free(mgr->workers);
+	mgr->workers = NULL;
+	mgr->workers_count = 0;
+}
+
+/*
+ * Cancelled coroutine returns from every wait right away, task which
+ * can not be abandoned is waited with cancellation suppressed.
+ */
+static inline int mm_taskmgr_wait_uncancellable(mm_task_t *task)
+{
+	mm_coroutine_t *coroutine;
+	coroutine = mm_scheduler_current(&mm_self->scheduler);
+	int cancel = coroutine->cancel;
+	coroutine->cancel = 0;
+	int ready;
+	ready = mm_eventmgr_wait(&mm_self->event_mgr, &task->on_complete,
+				 UINT32_MAX);
+	if (cancel)
+		coroutine->cancel = cancel;
+	return ready;
 }
 
-int mm_taskmgr_new(mm_taskmgr_t *mgr, mm_task_function_t function, void *arg,
-		   uint32_t time_ms)
+int mm_taskmgr_new(mm_taskmgr_t *mgr, mm_task_function_t function,
+		   mm_task_function_t on_abandon, void *arg, uint32_t time_ms)
 {
 	mm_msg_t *msg;
 	msg = (mm_msg_t *)machine_msg_create(sizeof(mm_task_t));
@@ -98,24 +142,86 @@ int mm_taskmgr_new(mm_taskmgr_t *mgr, mm_task_function_t function, void *arg,
 	mm_task_t *task;
 	task = (mm_task_t *)msg->data.start;
 	task->function = function;
+	task->on_abandon = on_abandon;
 	task->arg = arg;
+	task->state = MM_TASK_PENDING;
+	mm_sleeplock_init(&task->lock);
 	mm_eventmgr_add(&mm_self->event_mgr, &task->on_complete);
 
 	/* schedule task */
 	mm_channel_write(&mgr->channel, msg);
 
 	/* wait for completion */
-	time_ms = UINT32_MAX;
+	for (;;) {
+		int ready;
+		if (on_abandon)
+			ready = mm_eventmgr_wait(&mm_self->event_mgr,
+						 &task->on_complete, time_ms);
+		else
+			ready = mm_taskmgr_wait_uncancellable(task);
+		int status = mm_errno_get();
 
-	int ready;
-	ready = mm_eventmgr_wait(&mm_self->event_mgr, &task->on_complete,
-				 time_ms);
-	if (!ready) {
-		/* todo: */
-		abort();
-		return 0;
+		mm_sleeplock_lock(&task->lock);
+		if (ready || task->state == MM_TASK_DONE) {
+			/* task thread may still hold the lock on signal */
+			mm_sleeplock_unlock(&task->lock);
+			break;
+		}
+
+		/*
+		 * Without abandon callback the argument may live on the
+		 * waiter stack, so the task must be waited to the end.
+		 */
+		if (on_abandon == NULL) {
+			mm_eventmgr_add(&mm_self->event_mgr,
+					&task->on_complete);
+			mm_sleeplock_unlock(&task->lock);
+			continue;
+		}
+
+		task->state = MM_TASK_ABANDONED;
+		mm_sleeplock_unlock(&task->lock);
+		mm_errno_set(status ? status : ETIMEDOUT);
+		return -1;
 	}
 
 	machine_msg_free((machine_msg_t *)msg);
+	mm_errno_set(0);
 	return 0;
 }
+
+MACHINE_API machine_taskmgr_t *machine_taskmgr_create(char *name,
+						      int workers_count)
+{
+	mm_taskmgr_t *mgr = malloc(sizeof(mm_taskmgr_t));
+	if (mgr == NULL) {
+		mm_errno_set(ENOMEM);
+		return NULL;
+	}
+	mm_taskmgr_init(mgr);
+	int rc;
+	rc = mm_taskmgr_start(mgr, name, workers_count);
+	if (rc == -1) {
+		mm_channel_free(&mgr->channel);
+		free(mgr);
+		mm_errno_set(ENOMEM);
+		return NULL;
+	}
+	return (machine_taskmgr_t *)mgr;
+}
+
+MACHINE_API void machine_taskmgr_free(machine_taskmgr_t *obj)
+{
+	mm_taskmgr_t *mgr = mm_cast(mm_taskmgr_t *, obj);
+	mm_taskmgr_stop(mgr);
+	free(mgr);
+}
+
+MACHINE_API int machine_task_run(machine_taskmgr_t *obj,
+				 machine_task_function_t function,
+				 machine_task_function_t on_abandon, void *arg,
+				 uint32_t time_ms)
+{
+	mm_taskmgr_t *mgr = mm_cast(mm_taskmgr_t *, obj);
+	return mm_taskmgr_new(mgr, function, on_abandon, arg, time_ms);
+}
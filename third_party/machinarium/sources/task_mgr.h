@@ -17,8 +17,9 @@ struct mm_taskmgr {
 };
 
 void mm_taskmgr_init(mm_taskmgr_t *);
-int mm_taskmgr_start(mm_taskmgr_t *, int);
+int mm_taskmgr_start(mm_taskmgr_t *, char *, int);
 void mm_taskmgr_stop(mm_taskmgr_t *);
-int mm_taskmgr_new(mm_taskmgr_t *, mm_task_function_t, void *, uint32_t);
+int mm_taskmgr_new(mm_taskmgr_t *, mm_task_function_t, mm_task_function_t,
+		   void *, uint32_t);
 
 #endif /* MM_TASK_MGR_H */
@@ -8,6 +8,12 @@
 #include <machinarium.h>
 #include <machinarium_private.h>
 
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#if !USE_BORINGSSL && (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+#include <openssl/core_names.h>
+#endif
+
 #if !USE_BORINGSSL && (OPENSSL_VERSION_NUMBER < 0x10100000L)
 
 static pthread_mutex_t *mm_tls_locks = NULL;
@@ -53,6 +59,132 @@ static void mm_tls_lock_free(void)
 
 #endif
 
+/*
+ * Session ticket keys are process wide, so a ticket issued by one
+ * machine can be decrypted by any other. The current key encrypts new
+ * tickets, the previous one is only accepted for decryption (and the
+ * ticket is renewed) until it ages out.
+ */
+typedef struct {
+	unsigned char name[16];
+	unsigned char aes_key[32];
+	unsigned char hmac_key[32];
+	time_t created;
+} mm_tls_ticket_key_t;
+
+static pthread_mutex_t mm_tls_ticket_lock = PTHREAD_MUTEX_INITIALIZER;
+static mm_tls_ticket_key_t mm_tls_ticket_current;
+static mm_tls_ticket_key_t mm_tls_ticket_previous;
+static int mm_tls_ticket_current_valid = 0;
+static int mm_tls_ticket_previous_valid = 0;
+
+static int mm_tls_ticket_key_generate(mm_tls_ticket_key_t *key, time_t now)
+{
+	if (!RAND_bytes(key->name, sizeof(key->name)) ||
+	    !RAND_bytes(key->aes_key, sizeof(key->aes_key)) ||
+	    !RAND_bytes(key->hmac_key, sizeof(key->hmac_key)))
+		return -1;
+	key->created = now;
+	return 0;
+}
+
+/* called with mm_tls_ticket_lock held */
+static int mm_tls_ticket_keys_rotate(time_t now)
+{
+	time_t lifetime = machinarium.config.tls_ticket_lifetime;
+	if (mm_tls_ticket_current_valid &&
+	    now - mm_tls_ticket_current.created < lifetime)
+		return 0;
+	if (mm_tls_ticket_current_valid &&
+	    now - mm_tls_ticket_current.created < 2 * lifetime) {
+		mm_tls_ticket_previous = mm_tls_ticket_current;
+		mm_tls_ticket_previous_valid = 1;
+	} else {
+		mm_tls_ticket_previous_valid = 0;
+	}
+	mm_tls_ticket_current_valid = 0;
+	if (mm_tls_ticket_key_generate(&mm_tls_ticket_current, now) == -1)
+		return -1;
+	mm_tls_ticket_current_valid = 1;
+	return 0;
+}
+
+/*
+ * Returns 1 when the current key was copied out, 2 when the previous
+ * one matched (the ticket should be renewed) and 0 when nothing
+ * matches.
+ */
+static int mm_tls_ticket_key_get(mm_tls_ticket_key_t *key, unsigned char *name,
+				 int enc)
+{
+	int rc = 0;
+	pthread_mutex_lock(&mm_tls_ticket_lock);
+	if (mm_tls_ticket_keys_rotate(time(NULL)) == -1)
+		goto done;
+	if (enc || memcmp(name, mm_tls_ticket_current.name,
+			  sizeof(mm_tls_ticket_current.name)) == 0) {
+		*key = mm_tls_ticket_current;
+		rc = 1;
+	} else if (mm_tls_ticket_previous_valid &&
+		   memcmp(name, mm_tls_ticket_previous.name,
+			  sizeof(mm_tls_ticket_previous.name)) == 0) {
+		*key = mm_tls_ticket_previous;
+		rc = 2;
+	}
+done:
+	pthread_mutex_unlock(&mm_tls_ticket_lock);
+	return rc;
+}
+
+#if !USE_BORINGSSL && (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+static int mm_tls_ticket_key_cb(SSL *ssl, unsigned char *name,
+				unsigned char *iv, EVP_CIPHER_CTX *cipher_ctx,
+				EVP_MAC_CTX *mac_ctx, int enc)
+#else
+static int mm_tls_ticket_key_cb(SSL *ssl, unsigned char *name,
+				unsigned char *iv, EVP_CIPHER_CTX *cipher_ctx,
+				HMAC_CTX *mac_ctx, int enc)
+#endif
+{
+	(void)ssl;
+	mm_tls_ticket_key_t key;
+	int rc;
+	rc = mm_tls_ticket_key_get(&key, name, enc);
+	if (rc == 0)
+		return enc ? -1 : 0;
+
+	if (enc) {
+		memcpy(name, key.name, sizeof(key.name));
+		if (!RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) ||
+		    !EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), NULL,
+					key.aes_key, iv))
+			rc = -1;
+	} else {
+		if (!EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), NULL,
+					key.aes_key, iv))
+			rc = -1;
+	}
+
+	if (rc != -1) {
+#if !USE_BORINGSSL && (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+		OSSL_PARAM params[3];
+		params[0] = OSSL_PARAM_construct_octet_string(
+			OSSL_MAC_PARAM_KEY, key.hmac_key, sizeof(key.hmac_key));
+		params[1] = OSSL_PARAM_construct_utf8_string(
+			OSSL_MAC_PARAM_DIGEST, "sha256", 0);
+		params[2] = OSSL_PARAM_construct_end();
+		if (!EVP_MAC_CTX_set_params(mac_ctx, params))
+			rc = -1;
+#else
+		if (!HMAC_Init_ex(mac_ctx, key.hmac_key, sizeof(key.hmac_key),
+				  EVP_sha256(), NULL))
+			rc = -1;
+#endif
+	}
+	OPENSSL_cleanse(&key, sizeof(key));
+	return rc;
+}
+
 void mm_tls_engine_init(void)
 {
 	SSL_library_init();
@@ -64,6 +196,13 @@ void mm_tls_engine_init(void)
 
 void mm_tls_engine_free(void)
 {
+	pthread_mutex_lock(&mm_tls_ticket_lock);
+	OPENSSL_cleanse(&mm_tls_ticket_current, sizeof(mm_tls_ticket_current));
+	OPENSSL_cleanse(&mm_tls_ticket_previous,
+			sizeof(mm_tls_ticket_previous));
+	mm_tls_ticket_current_valid = 0;
+	mm_tls_ticket_previous_valid = 0;
+	pthread_mutex_unlock(&mm_tls_ticket_lock);
 #if !USE_BORINGSSL && (OPENSSL_VERSION_NUMBER < 0x10100000L)
 	mm_tls_lock_free();
 	ERR_remove_state(getpid());
@@ -161,19 +300,48 @@ static inline void mm_tls_error(mm_io_t *io, int ssl_rc, char *fmt, ...)
 		errno = EIO;
 }
 
+static int mm_tls_session_new_cb(SSL *ssl, SSL_SESSION *session)
+{
+	mm_io_t *io = SSL_get_app_data(ssl);
+	if (io == NULL || io->tls == NULL)
+		return 0;
+	mm_tls_t *tls = io->tls;
+	int rc = 1;
+#if !USE_BORINGSSL && (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+	/*
+	 * Keep a private copy: OpenSSL marks the connection's session
+	 * not resumable when it is freed without close_notify, which is
+	 * how most connections end.
+	 */
+	session = SSL_SESSION_dup(session);
+	if (session == NULL)
+		return 0;
+	rc = 0;
+#endif
+	mm_sleeplock_lock(&tls->session_lock);
+	if (tls->session)
+		SSL_SESSION_free(tls->session);
+	tls->session = session;
+	mm_sleeplock_unlock(&tls->session_lock);
+	/* 1 means the reference passed in is kept */
+	return rc;
+}
+
 SSL_CTX *mm_tls_get_context(mm_io_t *io, int is_client)
 {
+	mm_tls_t *tls = io->tls;
 	mm_tls_ctx_t *ctx_container;
-	if (is_client)
-		ctx_container = mm_self->client_tls_ctx;
-	else
-		ctx_container = mm_self->server_tls_ctx;
+	mm_sleeplock_lock(&tls->ctx_lock);
+	ctx_container = tls->ctx;
 	while (ctx_container != NULL) {
-		if (ctx_container->key == io->tls) {
+		if (ctx_container->machine_id == mm_self->id &&
+		    ctx_container->is_client == is_client) {
+			mm_sleeplock_unlock(&tls->ctx_lock);
 			return ctx_container->tls_ctx;
 		}
 		ctx_container = ctx_container->next;
 	}
+	mm_sleeplock_unlock(&tls->ctx_lock);
 	// Cached context not found - we must create ctx
 
 	SSL_CTX *ctx;
@@ -257,32 +425,51 @@ SSL_CTX *mm_tls_get_context(mm_io_t *io, int is_client)
 		mm_tls_error(io, 0, "SSL_CTX_set_cipher_list()");
 		goto error;
 	}
-	if (!is_client) {
-		unsigned char sid[SSL_MAX_SSL_SESSION_ID_LENGTH];
-		if (!RAND_bytes(sid, sizeof(sid))) {
-			mm_tls_error(io, 0, "failed to generate session id");
-			goto error;
-		}
-		if (!SSL_CTX_set_session_id_context(ctx, sid, sizeof(sid))) {
+	if (is_client) {
+		/* sessions are kept in the shared tls object instead */
+		SSL_CTX_set_session_cache_mode(
+			ctx, SSL_SESS_CACHE_CLIENT |
+				     SSL_SESS_CACHE_NO_INTERNAL_STORE);
+		SSL_CTX_sess_set_new_cb(ctx, mm_tls_session_new_cb);
+	} else {
+		if (!SSL_CTX_set_session_id_context(ctx, io->tls->sid,
+						    sizeof(io->tls->sid))) {
 			mm_tls_error(io, 0, "failed to set session id context");
 			goto error;
 		}
 
+		if (machinarium.config.tls_ticket_lifetime > 0) {
+#if !USE_BORINGSSL && (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+			rc = SSL_CTX_set_tlsext_ticket_key_evp_cb(
+				ctx, mm_tls_ticket_key_cb);
+#else
+			rc = SSL_CTX_set_tlsext_ticket_key_cb(
+				ctx, mm_tls_ticket_key_cb);
+#endif
+			if (rc != 1) {
+				mm_tls_error(io, 0,
+					     "failed to set ticket key callback");
+				goto error;
+			}
+		}
+
 		SSL_CTX_set_options(ctx, SSL_OP_CIPHER_SERVER_PREFERENCE);
 	}
 	// Place new ctx on top of cache
 
 	ctx_container = malloc(sizeof(*ctx_container));
-	ctx_container->key = io->tls;
+	if (ctx_container == NULL) {
+		mm_tls_error(io, 0, "failed to allocate context");
+		goto error;
+	}
+	ctx_container->machine_id = mm_self->id;
+	ctx_container->is_client = is_client;
 	ctx_container->tls_ctx = ctx;
 
-	if (is_client) {
-		ctx_container->next = mm_self->client_tls_ctx;
-		mm_self->client_tls_ctx = ctx_container;
-	} else {
-		ctx_container->next = mm_self->server_tls_ctx;
-		mm_self->server_tls_ctx = ctx_container;
-	}
+	mm_sleeplock_lock(&tls->ctx_lock);
+	ctx_container->next = tls->ctx;
+	tls->ctx = ctx_container;
+	mm_sleeplock_unlock(&tls->ctx_lock);
 
 	return ctx;
 error:
@@ -306,6 +493,15 @@ static int mm_tls_prepare(mm_io_t *io, int is_client)
 		mm_tls_error(io, 0, "SSL_new()");
 		goto error;
 	}
+	SSL_set_app_data(ssl, io);
+
+	/* offer the last session negotiated with this peer */
+	if (is_client) {
+		mm_sleeplock_lock(&io->tls->session_lock);
+		if (io->tls->session)
+			SSL_set_session(ssl, io->tls->session);
+		mm_sleeplock_unlock(&io->tls->session_lock);
+	}
 
 	/* set server name */
 	if (io->tls->server) {
@@ -504,6 +700,14 @@ int mm_tls_handshake(mm_io_t *io, uint32_t timeout)
 		return -1;
 
 	if (is_client) {
+		int resumed = SSL_session_reused(io->tls_ssl);
+		mm_sleeplock_lock(&io->tls->session_lock);
+		if (resumed)
+			io->tls->session_resumed++;
+		else
+			io->tls->session_full++;
+		mm_sleeplock_unlock(&io->tls->session_lock);
+
 		if (io->tls->server) {
 			rc = mm_tls_verify_common_name(io, io->tls->server);
 			if (rc == -1)
@@ -126,7 +126,11 @@ MACHINE_API ssize_t machine_writev_raw(machine_io_t *obj,
 	}
 	int errno_ = errno;
 	mm_errno_set(errno_);
-	if (errno_ == EAGAIN || errno_ == EWOULDBLOCK || errno_ == EINTR)
+	if (errno_ == EAGAIN || errno_ == EWOULDBLOCK) {
+		io->handle.ready &= ~MM_W;
+		return -1;
+	}
+	if (errno_ == EINTR)
 		return -1;
 	io->connected = 0;
 	return -1;